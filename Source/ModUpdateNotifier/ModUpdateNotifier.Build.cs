@@ -27,6 +27,7 @@ public class ModUpdateNotifier : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"ImageWrapper",
 				"Slate",
 				"SlateCore",
 			}
@@ -0,0 +1,246 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNChangelogCache.h"
+
+#include "MUNStats.h"
+
+namespace
+{
+	// A line of three or more dashes, asterisks or underscores
+	bool IsHorizontalRule(const FStringView Line)
+	{
+		if (Line.Len() < 3 || (Line[0] != TEXT('-') && Line[0] != TEXT('*') && Line[0] != TEXT('_')))
+		{
+			return false;
+		}
+
+		for (const TCHAR Character : Line)
+		{
+			if (Character != Line[0] && Character != TEXT(' '))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+TSharedRef<const FMUNRenderedChangelog> FMUNChangelogRenderer::Render(const FString& Markdown, const int32 ChunkCharacters, const EMUNChangelogFormat Format)
+{
+	MUN_SCOPE_PHASE(RenderChangelogs, TEXT("Render changelogs"));
+
+	const TSharedRef<FMUNRenderedChangelog> Rendered = MakeShared<FMUNRenderedChangelog>();
+	FString Chunk;
+	Chunk.Reserve(ChunkCharacters + 256);
+	bool bPreviousLineBlank = true; // Drops leading blank lines
+
+	TArray<FString> Lines;
+	Markdown.ParseIntoArrayLines(Lines, false);
+
+	for (const FString& RawLine : Lines)
+	{
+		const FStringView Line = FStringView(RawLine).TrimEnd();
+		const int32 Indent = Line.Len() - Line.TrimStart().Len();
+		const FStringView Content = Line.TrimStart();
+
+		// Runs of blank lines and horizontal rules collapse into a single blank line
+		if (Content.IsEmpty() || IsHorizontalRule(Content))
+		{
+			if (!bPreviousLineBlank)
+			{
+				Chunk += TEXT("\n");
+				bPreviousLineBlank = true;
+			}
+			continue;
+		}
+
+		FString RenderedLine;
+		int32 Level = 0;
+		while (Level < Content.Len() && Content[Level] == TEXT('#'))
+		{
+			Level++;
+		}
+
+		if (Level > 0 && (Level == Content.Len() || Content[Level] == TEXT(' ')))
+		{
+			// Rich text styles don't nest, so a heading is bold as a whole and its inline styles are dropped
+			if (Format == EMUNChangelogFormat::RichText)
+			{
+				RenderedLine += TEXT("<Bold>");
+			}
+			RenderInline(Content.RightChop(Level).TrimStart(), false, Format, RenderedLine);
+			if (Format == EMUNChangelogFormat::RichText)
+			{
+				RenderedLine += TEXT("</>");
+			}
+		}
+		else if (Content.Len() > 1 && (Content[0] == TEXT('-') || Content[0] == TEXT('*') || Content[0] == TEXT('+')) && Content[1] == TEXT(' '))
+		{
+			RenderedLine = FString::ChrN(Indent, TEXT(' ')) + TEXT("\u2022 ");
+			RenderInline(Content.RightChop(2).TrimStart(), true, Format, RenderedLine);
+		}
+		else
+		{
+			RenderInline(Content, true, Format, RenderedLine);
+		}
+
+		// Chunks only break between lines, so every chunk is valid markup on its own
+		if (!Chunk.IsEmpty() && Chunk.Len() + RenderedLine.Len() > ChunkCharacters)
+		{
+			Rendered->NumBytes += Chunk.GetAllocatedSize();
+			Rendered->Chunks.Add(MoveTemp(Chunk));
+			Chunk.Reset(ChunkCharacters + 256);
+		}
+
+		Chunk += RenderedLine;
+		Chunk += TEXT("\n");
+		bPreviousLineBlank = false;
+	}
+
+	Chunk.TrimEndInline();
+	if (!Chunk.IsEmpty())
+	{
+		Chunk.Shrink();
+		Rendered->NumBytes += Chunk.GetAllocatedSize();
+		Rendered->Chunks.Add(MoveTemp(Chunk));
+	}
+
+	Rendered->NumBytes += Rendered->Chunks.GetAllocatedSize();
+	return Rendered;
+}
+
+void FMUNChangelogRenderer::RenderInline(const FStringView Line, const bool bAllowStyles, const EMUNChangelogFormat Format, FString& Out)
+{
+	const bool bStyled = bAllowStyles && Format == EMUNChangelogFormat::RichText;
+
+	int32 Index = 0;
+	while (Index < Line.Len())
+	{
+		const FStringView Rest = Line.RightChop(Index);
+
+		// **bold** and __bold__
+		if (Rest.StartsWith(TEXT("**")) || Rest.StartsWith(TEXT("__")))
+		{
+			const int32 End = Rest.RightChop(2).Find(Rest.Left(2));
+			if (End > 0)
+			{
+				if (bStyled)
+				{
+					Out += TEXT("<Bold>");
+				}
+				AppendText(Rest.Mid(2, End), Format, Out);
+				if (bStyled)
+				{
+					Out += TEXT("</>");
+				}
+				Index += End + 4;
+				continue;
+			}
+		}
+
+		// `code` keeps its text without the backticks
+		if (Rest[0] == TEXT('`'))
+		{
+			const int32 End = Rest.RightChop(1).Find(TEXT("`"));
+			if (End >= 0)
+			{
+				AppendText(Rest.Mid(1, End), Format, Out);
+				Index += End + 2;
+				continue;
+			}
+		}
+
+		// [text](url) keeps its text, the rich text block can't open links
+		if (Rest[0] == TEXT('['))
+		{
+			const int32 TextEnd = Rest.Find(TEXT("]("));
+			const int32 UrlEnd = TextEnd > 0 ? Rest.RightChop(TextEnd).Find(TEXT(")")) : INDEX_NONE;
+			if (UrlEnd > 0)
+			{
+				AppendText(Rest.Mid(1, TextEnd - 1), Format, Out);
+				Index += TextEnd + UrlEnd + 1;
+				continue;
+			}
+		}
+
+		// Copy plain text up to the next character that could start markdown
+		int32 PlainEnd = 1;
+		while (PlainEnd < Rest.Len() && Rest[PlainEnd] != TEXT('*') && Rest[PlainEnd] != TEXT('_') && Rest[PlainEnd] != TEXT('`') && Rest[PlainEnd] != TEXT('['))
+		{
+			PlainEnd++;
+		}
+		AppendText(Rest.Left(PlainEnd), Format, Out);
+		Index += PlainEnd;
+	}
+}
+
+void FMUNChangelogRenderer::AppendText(const FStringView Text, const EMUNChangelogFormat Format, FString& Out)
+{
+	if (Format == EMUNChangelogFormat::PlainText)
+	{
+		Out += Text;
+		return;
+	}
+
+	// The escapes understood by the default rich text markup parser
+	for (const TCHAR Character : Text)
+	{
+		switch (Character)
+		{
+		case TEXT('&'): Out += TEXT("&amp;"); break;
+		case TEXT('<'): Out += TEXT("&lt;"); break;
+		case TEXT('>'): Out += TEXT("&gt;"); break;
+		case TEXT('"'): Out += TEXT("&quot;"); break;
+		default: Out.AppendChar(Character); break;
+		}
+	}
+}
+
+FMUNChangelogCache::FMUNChangelogCache()
+	: Entries(MaxEntries)
+{
+}
+
+void FMUNChangelogCache::SetBudget(const int64 InBudgetBytes)
+{
+	BudgetBytes = InBudgetBytes;
+	EvictToBudget(0);
+}
+
+TSharedPtr<const FMUNRenderedChangelog> FMUNChangelogCache::Find(const FString& ModReference)
+{
+	const TSharedPtr<const FMUNRenderedChangelog>* Entry = Entries.FindAndTouch(ModReference);
+	return Entry ? *Entry : nullptr;
+}
+
+void FMUNChangelogCache::Add(const FString& ModReference, const TSharedRef<const FMUNRenderedChangelog>& Changelog)
+{
+	Remove(ModReference);
+	EvictToBudget(Changelog->NumBytes);
+
+	Entries.Add(ModReference, Changelog);
+	NumBytes += Changelog->NumBytes;
+}
+
+void FMUNChangelogCache::Remove(const FString& ModReference)
+{
+	if (const TSharedPtr<const FMUNRenderedChangelog>* Entry = Entries.Find(ModReference))
+	{
+		NumBytes -= (*Entry)->NumBytes;
+		Entries.Remove(ModReference);
+	}
+}
+
+void FMUNChangelogCache::Reset()
+{
+	Entries.Empty(MaxEntries);
+	NumBytes = 0;
+}
+
+void FMUNChangelogCache::EvictToBudget(const int64 ReservedBytes)
+{
+	while (Entries.Num() > 0 && (NumBytes + ReservedBytes > BudgetBytes || Entries.Num() >= MaxEntries))
+	{
+		NumBytes -= Entries.RemoveLeastRecent()->NumBytes;
+	}
+}
@@ -0,0 +1,57 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNDependencyGraph.h"
+
+#include "ModLoading/ModLoadingLibrary.h"
+
+void FMUNDependencyGraph::Build(const UModLoadingLibrary& ModLoadingLibrary, const TConstArrayView<FModInfo> LoadedMods)
+{
+	Dependents.Reset();
+	NumDependencyEdges = 0;
+
+	for (const FModInfo& ModInfo : LoadedMods)
+	{
+		const auto* Metadata = ModLoadingLibrary.PluginMetadata.Find(ModInfo.Name);
+		if (!Metadata)
+		{
+			continue;
+		}
+
+		const FName Dependent(*ModInfo.Name);
+		for (const auto& ModDependencyVersion : Metadata->DependenciesVersions)
+		{
+			AddDependency(FName(*ModDependencyVersion.Key), Dependent, ModDependencyVersion.Value);
+		}
+	}
+}
+
+void FMUNDependencyGraph::AddDependency(const FName Dependency, const FName Dependent, const FVersionRange& Range)
+{
+	Dependents.FindOrAdd(Dependency).Add({Dependent, Range});
+	NumDependencyEdges++;
+}
+
+FVersion FMUNDependencyGraph::FindNewestAllowed(const FName ModReference, const TConstArrayView<FVersion> Versions, FName* OutBlockingDependent) const
+{
+	const TArray<FEdge>* Edges = Dependents.Find(ModReference);
+	if (!Edges)
+	{
+		return Versions.IsEmpty() ? FVersion{0,0,0} : Versions[0];
+	}
+
+	for (int32 VersionIndex = 0; VersionIndex < Versions.Num(); VersionIndex++)
+	{
+		const FEdge* Excluding = Edges->FindByPredicate([&Version = Versions[VersionIndex]](const FEdge& Edge) { return !Edge.Range.Matches(Version); });
+		if (!Excluding)
+		{
+			return Versions[VersionIndex];
+		}
+
+		if (VersionIndex == 0 && OutBlockingDependent)
+		{
+			*OutBlockingDependent = Excluding->Dependent;
+		}
+	}
+
+	return {0,0,0};
+}
@@ -0,0 +1,460 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNIconCache.h"
+
+#include "ModUpdateNotifier.h"
+#include "MUNStats.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "ImageUtils.h"
+#include "Async/Async.h"
+#include "Engine/Texture2D.h"
+#include "Hash/xxhash.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+
+FMUNIconDiskCache::FMUNIconDiskCache(const FString& InDirectory, IImageWrapperModule& InImageWrapperModule)
+	: Directory(InDirectory)
+	, ImageWrapperModule(InImageWrapperModule)
+{
+}
+
+bool FMUNIconDiskCache::Load(const FString& LogoURL, TArray<uint8>& OutPixels, int32& OutWidth, int32& OutHeight)
+{
+	MUN_SCOPE_PHASE(DecodeIcons, TEXT("Decode icons"));
+
+	const FString ThumbnailPath = GetThumbnailPath(LogoURL);
+
+	TArray<uint8> Thumbnail;
+	if (!FFileHelper::LoadFileToArray(Thumbnail, *ThumbnailPath, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	const TSharedPtr<IImageWrapper> PngWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+	if (!PngWrapper.IsValid() || !PngWrapper->SetCompressed(Thumbnail.GetData(), Thumbnail.Num()) || !PngWrapper->GetRaw(ERGBFormat::BGRA, 8, OutPixels))
+	{
+		// Written by an interrupted session, it is downloaded again and overwritten
+		return false;
+	}
+
+	OutWidth = PngWrapper->GetWidth();
+	OutHeight = PngWrapper->GetHeight();
+
+	// The modification time orders thumbnails for eviction
+	IFileManager::Get().SetTimeStamp(*ThumbnailPath, FDateTime::UtcNow());
+	return true;
+}
+
+bool FMUNIconDiskCache::DecodeAndStore(const FString& LogoURL, const TConstArrayView<uint8> Content, const int32 MaxSize, TArray<uint8>& OutPixels, int32& OutWidth, int32& OutHeight)
+{
+	MUN_SCOPE_PHASE(DecodeIcons, TEXT("Decode icons"));
+
+	const EImageFormat Format = ImageWrapperModule.DetectImageFormat(Content.GetData(), Content.Num());
+	const TSharedPtr<IImageWrapper> SourceWrapper = Format != EImageFormat::Invalid ? ImageWrapperModule.CreateImageWrapper(Format) : nullptr;
+
+	TArray<uint8> SourcePixels;
+	if (!SourceWrapper.IsValid() || !SourceWrapper->SetCompressed(Content.GetData(), Content.Num()) || !SourceWrapper->GetRaw(ERGBFormat::BGRA, 8, SourcePixels))
+	{
+		return false;
+	}
+
+	const int32 SourceWidth = SourceWrapper->GetWidth();
+	const int32 SourceHeight = SourceWrapper->GetHeight();
+	if (SourceWidth <= 0 || SourceHeight <= 0)
+	{
+		return false;
+	}
+
+	// Logos are uploaded at any size, rows only ever show a thumbnail
+	const float Scale = FMath::Min(1.0f, static_cast<float>(MaxSize) / FMath::Max(SourceWidth, SourceHeight));
+	OutWidth = FMath::Max(1, FMath::RoundToInt(SourceWidth * Scale));
+	OutHeight = FMath::Max(1, FMath::RoundToInt(SourceHeight * Scale));
+
+	if (OutWidth == SourceWidth && OutHeight == SourceHeight)
+	{
+		OutPixels = MoveTemp(SourcePixels);
+	}
+	else
+	{
+		// BGRA8 has the same layout as FColor
+		TArray<FColor> SourceColors;
+		SourceColors.SetNumUninitialized(SourceWidth * SourceHeight);
+		FMemory::Memcpy(SourceColors.GetData(), SourcePixels.GetData(), SourceColors.Num() * sizeof(FColor));
+
+		TArray<FColor> ThumbnailColors;
+		ThumbnailColors.SetNumUninitialized(OutWidth * OutHeight);
+		FImageUtils::ImageResize(SourceWidth, SourceHeight, SourceColors, OutWidth, OutHeight, ThumbnailColors, false, false);
+
+		OutPixels.SetNumUninitialized(ThumbnailColors.Num() * sizeof(FColor));
+		FMemory::Memcpy(OutPixels.GetData(), ThumbnailColors.GetData(), OutPixels.Num());
+	}
+
+	// Failing to store the thumbnail only means it is downloaded again next session
+	const TSharedPtr<IImageWrapper> PngWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+	if (PngWrapper.IsValid() && PngWrapper->SetRaw(OutPixels.GetData(), OutPixels.Num(), OutWidth, OutHeight, ERGBFormat::BGRA, 8))
+	{
+		const TArray64<uint8> Thumbnail = PngWrapper->GetCompressed();
+		const FString ThumbnailPath = GetThumbnailPath(LogoURL);
+
+		// A thumbnail left by an interrupted session is overwritten, only the difference adds to the directory
+		const int64 ReplacedBytes = FMath::Max<int64>(0, IFileManager::Get().FileSize(*ThumbnailPath));
+
+		if (FFileHelper::SaveArrayToFile(Thumbnail, *ThumbnailPath))
+		{
+			// Until the first trim has measured the directory there is nothing to add to
+			const int64 AddedBytes = Thumbnail.Num() - ReplacedBytes;
+			int64 Measured = NumBytes.load();
+			while (Measured >= 0 && !NumBytes.compare_exchange_weak(Measured, Measured + AddedBytes))
+			{
+			}
+
+			if (Measured >= 0 && Measured + AddedBytes > BudgetBytes.load())
+			{
+				Trim();
+			}
+		}
+	}
+
+	return true;
+}
+
+void FMUNIconDiskCache::SetBudget(const int64 InBudgetBytes)
+{
+	BudgetBytes = InBudgetBytes;
+}
+
+void FMUNIconDiskCache::Trim()
+{
+	if (bTrimming.exchange(true))
+	{
+		return;
+	}
+
+	struct FThumbnailFile
+	{
+		FString Path;
+		int64 Size;
+		FDateTime ModificationTime;
+	};
+
+	TArray<FThumbnailFile> Thumbnails;
+	int64 TotalBytes = 0;
+	int64 DeletedBytes = 0;
+
+	IFileManager::Get().IterateDirectoryStat(*Directory, [&Thumbnails, &TotalBytes](const TCHAR* Path, const FFileStatData& StatData)
+	{
+		if (!StatData.bIsDirectory)
+		{
+			Thumbnails.Add({Path, StatData.FileSize, StatData.ModificationTime});
+			TotalBytes += StatData.FileSize;
+		}
+		return true;
+	});
+
+	const int64 Budget = BudgetBytes.load();
+	if (TotalBytes > Budget)
+	{
+		Thumbnails.Sort([](const FThumbnailFile& A, const FThumbnailFile& B) { return A.ModificationTime < B.ModificationTime; });
+
+		for (const FThumbnailFile& Thumbnail : Thumbnails)
+		{
+			if (TotalBytes <= Budget)
+			{
+				break;
+			}
+
+			if (IFileManager::Get().Delete(*Thumbnail.Path, false, false, true))
+			{
+				TotalBytes -= Thumbnail.Size;
+				DeletedBytes += Thumbnail.Size;
+			}
+		}
+	}
+
+	// Thumbnails stored while the directory was walked have already been added to the count, so only take off what was
+	// deleted. The first trim sets the count, nothing was added to it before.
+	int64 Unmeasured = -1;
+	if (!NumBytes.compare_exchange_strong(Unmeasured, TotalBytes))
+	{
+		NumBytes -= DeletedBytes;
+	}
+	bTrimming = false;
+}
+
+FString FMUNIconDiskCache::GetThumbnailPath(const FString& LogoURL) const
+{
+	// SMR gives every uploaded logo a new URL, so the URL identifies the image
+	const FXxHash64 Hash = FXxHash64::HashBuffer(*LogoURL, LogoURL.Len() * sizeof(TCHAR));
+	return FPaths::Combine(Directory, FString::Printf(TEXT("%016llx.png"), Hash.Hash));
+}
+
+FString FMUNIconDiskCache::GetDefaultDirectory()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ModUpdateNotifier"), TEXT("Icons"));
+}
+
+void UMUNIconCache::Initialize()
+{
+	// Modules can only be loaded on the game thread, the workers share this one
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+	DiskCache = MakeShared<FMUNIconDiskCache>(FMUNIconDiskCache::GetDefaultDirectory(), ImageWrapperModule);
+
+	FMUNRequestSettings RequestSettings;
+	RequestSettings.MaxConcurrentRequests = MaxConcurrentLoads;
+	PendingRequests = MakeShared<FMUNRequestScheduler>(RequestSettings);
+}
+
+void UMUNIconCache::SetDiskBudget(const int64 BudgetBytes)
+{
+	check(DiskCache.IsValid());
+
+	DiskCache->SetBudget(BudgetBytes);
+
+	// Measures the directory too, so stored thumbnails are counted from now on
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [DiskCache = DiskCache.ToSharedRef()]()
+	{
+		DiskCache->Trim();
+	});
+}
+
+bool UMUNIconCache::RequestIcon(const FString& LogoURL, UTexture2D*& OutIcon)
+{
+	OutIcon = nullptr;
+
+	if (LogoURL.IsEmpty())
+	{
+		return true;
+	}
+
+	// Counted for loaded icons too, so they aren't dropped while a row shows them
+	Interest.FindOrAdd(LogoURL)++;
+
+	if (FailedIcons.Contains(LogoURL))
+	{
+		return true;
+	}
+
+	if (const TObjectPtr<UTexture2D>* Icon = Icons.Find(LogoURL))
+	{
+		UnusedIcons.Remove(LogoURL);
+		OutIcon = *Icon;
+		return true;
+	}
+
+	// Rows requested last are the ones on screen now, they go first
+	if (!Loading.Contains(LogoURL))
+	{
+		Queue.Remove(LogoURL);
+		Queue.Add(LogoURL);
+		PumpQueue();
+	}
+
+	return false;
+}
+
+void UMUNIconCache::ReleaseIcon(const FString& LogoURL)
+{
+	int32* NumHolding = Interest.Find(LogoURL);
+	if (!NumHolding || --*NumHolding > 0)
+	{
+		return;
+	}
+
+	Interest.Remove(LogoURL);
+	Queue.Remove(LogoURL);
+
+	if (Icons.Contains(LogoURL))
+	{
+		AddUnusedIcon(LogoURL);
+	}
+}
+
+void UMUNIconCache::AddUnusedIcon(const FString& LogoURL)
+{
+	UnusedIcons.Remove(LogoURL);
+	UnusedIcons.Add(LogoURL);
+
+	// The texture is collected once the map lets go of it, the thumbnail stays in the disk cache
+	while (UnusedIcons.Num() > MaxUnusedIcons)
+	{
+		Icons.Remove(UnusedIcons[0]);
+		UnusedIcons.RemoveAt(0);
+	}
+}
+
+void UMUNIconCache::PumpQueue()
+{
+	check(DiskCache.IsValid());
+
+	while (Loading.Num() < MaxConcurrentLoads && !Queue.IsEmpty())
+	{
+		FString LogoURL = Queue.Pop();
+		Loading.Add(LogoURL);
+
+		TWeakObjectPtr<UMUNIconCache> WeakThis = this;
+		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [WeakThis, DiskCache = DiskCache.ToSharedRef(), LogoURL = MoveTemp(LogoURL)]() mutable
+		{
+			FDecodedIcon DecodedIcon;
+			const bool bCached = DiskCache->Load(LogoURL, DecodedIcon.Pixels, DecodedIcon.Width, DecodedIcon.Height);
+			DecodedIcon.LogoURL = MoveTemp(LogoURL);
+
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, bCached, DecodedIcon = MoveTemp(DecodedIcon)]() mutable
+			{
+				if (UMUNIconCache* This = WeakThis.Get())
+				{
+					if (bCached)
+					{
+						This->OnIconDecoded(MoveTemp(DecodedIcon));
+					}
+					else
+					{
+						This->RequestLogo(DecodedIcon.LogoURL);
+					}
+				}
+			});
+		});
+	}
+}
+
+void UMUNIconCache::RequestLogo(const FString& LogoURL)
+{
+	const FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
+	Request->SetURL(LogoURL);
+	Request->SetVerb("GET");
+	Request->SetHeader(TEXT("User-Agent"), "X-UE5-ModUpdateNotifier-Agent");
+
+	PendingRequests->Enqueue(Request, FHttpRequestCompleteDelegate::CreateUObject(this, &UMUNIconCache::OnLogoReceived, LogoURL));
+}
+
+void UMUNIconCache::OnLogoReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful, FString LogoURL)
+{
+	if (!bWasSuccessful || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Unable to download logo: %s"), *LogoURL);
+
+		// The network may be back by the time the row asks again, so unlike undecodable logos this one isn't given up on
+		Loading.Remove(LogoURL);
+		OnIconLoaded.Broadcast(LogoURL, nullptr);
+		PumpQueue();
+		return;
+	}
+
+	// Decoding a full size logo takes milliseconds, far too long for the game thread
+	TWeakObjectPtr<UMUNIconCache> WeakThis = this;
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [WeakThis, DiskCache = DiskCache.ToSharedRef(), Response, LogoURL = MoveTemp(LogoURL)]() mutable
+	{
+		FDecodedIcon DecodedIcon;
+		TArray<uint8> Decompressed;
+		if (!DiskCache->DecodeAndStore(LogoURL, FMUNRequestScheduler::GetContent(Response, Decompressed), IconSize, DecodedIcon.Pixels, DecodedIcon.Width, DecodedIcon.Height))
+		{
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Logo is not in a format the engine can decode: %s"), *LogoURL);
+			DecodedIcon.Pixels.Empty();
+		}
+		DecodedIcon.LogoURL = MoveTemp(LogoURL);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, DecodedIcon = MoveTemp(DecodedIcon)]() mutable
+		{
+			if (UMUNIconCache* This = WeakThis.Get())
+			{
+				This->OnIconDecoded(MoveTemp(DecodedIcon));
+			}
+		});
+	});
+}
+
+void UMUNIconCache::OnIconDecoded(FDecodedIcon&& DecodedIcon)
+{
+	MUN_SCOPE_GAME_THREAD();
+
+	DecodedIcons.Add(MoveTemp(DecodedIcon));
+
+	if (!CreateTexturesHandle.IsValid())
+	{
+		CreateTexturesHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMUNIconCache::CreateTextures));
+	}
+}
+
+bool UMUNIconCache::CreateTextures(float DeltaTime)
+{
+	MUN_SCOPE_GAME_THREAD();
+	MUN_SCOPE_PHASE(CreateIconTextures, TEXT("Create icon textures"));
+
+	// A whole list of icons can arrive at once, spread creating their textures over several frames
+	TArray<FDecodedIcon> CreatedIcons;
+	const int32 NumToCreate = FMath::Min(MaxTexturesPerFrame, DecodedIcons.Num());
+	for (int32 IconIndex = 0; IconIndex < NumToCreate; IconIndex++)
+	{
+		CreatedIcons.Add(MoveTemp(DecodedIcons[IconIndex]));
+	}
+	DecodedIcons.RemoveAt(0, NumToCreate);
+
+	for (const FDecodedIcon& DecodedIcon : CreatedIcons)
+	{
+		UTexture2D* Icon = nullptr;
+		if (!DecodedIcon.Pixels.IsEmpty())
+		{
+			Icon = UTexture2D::CreateTransient(DecodedIcon.Width, DecodedIcon.Height, PF_B8G8R8A8);
+		}
+
+		if (Icon)
+		{
+			FTexture2DMipMap& Mip = Icon->GetPlatformData()->Mips[0];
+			FMemory::Memcpy(Mip.BulkData.Lock(LOCK_READ_WRITE), DecodedIcon.Pixels.GetData(), DecodedIcon.Pixels.Num());
+			Mip.BulkData.Unlock();
+			Icon->UpdateResource();
+
+			Icons.Add(DecodedIcon.LogoURL, Icon);
+
+			// Every row asking for it was released while it was loading
+			if (!Interest.Contains(DecodedIcon.LogoURL))
+			{
+				AddUnusedIcon(DecodedIcon.LogoURL);
+			}
+		}
+		else
+		{
+			FailedIcons.Add(DecodedIcon.LogoURL);
+		}
+
+		Loading.Remove(DecodedIcon.LogoURL);
+		OnIconLoaded.Broadcast(DecodedIcon.LogoURL, Icon);
+	}
+
+	PumpQueue();
+
+	if (DecodedIcons.IsEmpty())
+	{
+		CreateTexturesHandle.Reset();
+		return false;
+	}
+	return true;
+}
+
+void UMUNIconCache::CancelPendingRequests()
+{
+	if (PendingRequests.IsValid())
+	{
+		PendingRequests->CancelAll();
+	}
+
+	if (CreateTexturesHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(CreateTexturesHandle);
+		CreateTexturesHandle.Reset();
+	}
+
+	Queue.Reset();
+	Interest.Reset();
+	Loading.Reset();
+	DecodedIcons.Reset();
+}
+
+void UMUNIconCache::BeginDestroy()
+{
+	CancelPendingRequests();
+
+	Super::BeginDestroy();
+}
@@ -3,13 +3,17 @@
 #include "MUNMenuModule.h"
 
 #include "AkAcousticTextureSetComponent.h"
-#include "Modules/BuildVersion.h"
+#include "Async/Async.h"
 #include "FGBlueprintFunctionLibrary.h"
 #include "ModUpdateNotifier.h"
-#include "Http.h"
-#include "Serialization/JsonSerializer.h"
+#include "MUNStats.h"
+#include "MUNUpdateListItem.h"
+#include "MUNUpdateSubsystem.h"
+#include "TimerManager.h"
+#include "Blueprint/WidgetBlueprintLibrary.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/ScrollBox.h"
 #include "Logging/StructuredLog.h"
-#include "Kismet/KismetStringLibrary.h"
 #include "ModLoading/ModLoadingLibrary.h"
 #include "Module/WorldModuleManager.h"
 
@@ -23,10 +27,13 @@ UMUNMenuModule::UMUNMenuModule()
 	ModNotifierConfig = FModUpdateNotifier_ConfigStruct::GetActiveConfig(GetWorld());
 	#endif
 	}
+	FMUNCheckSettings::ReadIniOptions(ModNotifierConfig);
 
 	bShowNotifications = ModNotifierConfig.bShowNotifications;
 	bDebugLogging = ModNotifierConfig.bDebugLogging;
 	bDisableNotifications = ModNotifierConfig.bDisableNotifications;
+	CheckSettings = FMUNCheckSettings::FromConfig(ModNotifierConfig);
+	NotificationDeadlineSeconds = ModNotifierConfig.NotificationDeadlineSeconds > 0.0f ? ModNotifierConfig.NotificationDeadlineSeconds : DefaultNotificationDeadlineSeconds;
 
 	APIIndex = 0;
 	APIIndexRetrieved = 0;
@@ -34,6 +41,8 @@ UMUNMenuModule::UMUNMenuModule()
 
 void UMUNMenuModule::CheckForModUpdates()
 {
+	MUN_SCOPE_GAME_THREAD();
+
 	// Log metadata from ModUpdateNotifier for debug purposes
 	UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Loaded ModUpdateNotifier Menu Module."));
 
@@ -55,278 +64,258 @@ void UMUNMenuModule::CheckForModUpdates()
 	}
 
 	// Should we check for updates?
-	if (bShowNotifications && this->GetWorld()->GetNetMode() != NM_DedicatedServer && !bDisableNotifications) // Temporarily disable checking on dedicated servers due to elevated number of SIGSEGV errors
+	if (!bShowNotifications || bDisableNotifications)
 	{
-		// Get a reference to the World Module Manager, used later for check for the SMR_ID property on mod World Modules
-		UWorldModuleManager *WorldModuleManager = GetWorld()->GetSubsystem<UWorldModuleManager>();
-		// Get a list of all loaded mods, we loop through this to check if each mod has the SMR_ID property
-		TArray<FModInfo> LoadedMods = ModLoadingLibrary->GetLoadedMods();
+		return;
+	}
 
-		// Get all loaded mod versions and put them into an array
-		for(int32 Index = 0; Index != LoadedMods.Num(); ++Index)
-		{
-			const FString CurrentModName = LoadedMods[Index].Name;
+	// Dedicated servers have no one to show a popup to, they write a report instead
+	if (this->GetWorld()->GetNetMode() == NM_DedicatedServer)
+	{
+		StartServerCheck();
+		return;
+	}
 
-			if(ModLoadingLibrary->IsModLoaded(CurrentModName))
-			{
-				bool OptedOut = false;
-				FModInfo ModInfo;
-				ModLoadingLibrary->GetLoadedModInfo(CurrentModName, ModInfo);
-
-				// Check for locked dependencies that shouldn't prompt for updates
-				TMap<FString, FVersionRange> ModDependencies = ModLoadingLibrary->PluginMetadata.Find(ModInfo.Name)->DependenciesVersions;
-
-				for (const auto& ModDependencyVersion : ModDependencies)
-				{
-					FString DependencyName = ModDependencyVersion.Key;
-					FVersionRange DependencyVersion = ModDependencyVersion.Value;
-
-					if (!DependencyVersion.ToString().Contains(TEXT("^"))) // If the dependency does not contain a ^ (indicating any newer versions are allowed), we consider it to be locked and don't issue a notification for it's updates
-					{
-						UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Dependency is locked, cannot allow update notification: %s"), *DependencyName);
-
-						LockedDependencies.Add(DependencyName);
-					}
-				}
-
-				if (bDebugLogging)
-				{
-					UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Detected mod: %s."), *ModInfo.FriendlyName);
-				}
-
-				// If we find a module for the currently loaded mod, continue
-				if (WorldModuleManager->FindModule(FName(*LoadedMods[Index].Name)))
-				{
-					// Create a variable to hold the mod module
-					UWorldModule* Mod = WorldModuleManager->FindModule(FName(*LoadedMods[Index].Name));
-
-					// Based on this post: https://forums.unrealengine.com/t/how-to-get-a-string-property-by-name/266008
-
-					if (Mod->GetClass()->FindPropertyByName("ModUpdateNotifier_OptOut")->IsValidLowLevel())
-					{
-						// Get a reference to the OptOut property and assign its value to a variable
-						FProperty* Property = Mod->GetClass()->FindPropertyByName("ModUpdateNotifier_OptOut");
-
-						FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property);
-
-						void* PropertyAddress = Property->ContainerPtrToValuePtr<void>(Mod);
-
-						OptedOut = BoolProperty->GetPropertyValue(PropertyAddress);
-					}
-					if (!OptedOut)
-					{
-						// Check if the module has a Support_URL property
-						if (Mod->GetClass()->FindPropertyByName("ModUpdateNotifier_Support_URL")->IsValidLowLevel())
-						{
-							// Get a reference to the Support_URL property and assign its value to a variable
-							FProperty* Property = Mod->GetClass()->FindPropertyByName("ModUpdateNotifier_Support_URL");
-
-							FStrProperty* StringProperty = CastField<FStrProperty>(Property);
-
-							void* PropertyAddress = Property->ContainerPtrToValuePtr<void>(Mod);
-
-							FString OutValue = StringProperty->GetPropertyValue(PropertyAddress);
-
-							SupportURLs.Add(OutValue);
-							HasSupportURLs.Add(true);
-
-							if (bDebugLogging)
-							{
-								UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Successfully loaded Support URL for mod: %s"), *LoadedMods[Index].FriendlyName);
-							}
-						}
-						else {
-							if (bDebugLogging)
-							{
-								UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Could not find Support_URL field for mod: %s"), *LoadedMods[Index].FriendlyName);
-							}
-
-							SupportURLs.Add("none");
-							HasSupportURLs.Add(false);
-						}
-					}
-				}
-				else
-				{
-					if (!OptedOut)
-					{
-						SupportURLs.Add("none");
-						HasSupportURLs.Add(false);
-					}
-				}
-
-				if (!OptedOut)
-				{
-					APIVersions.Add({0,0,0});
-					APIIndex++;
-					ModChangelogs.Add("Unfulfilled");
-					InstalledMods.Add(CurrentModName);
-					InstalledModVersions.Add(ModInfo.Version);
-					InstalledModFriendlyNames.Add(LoadedMods[Index].FriendlyName);
-					ModAuthors.Add(LoadedMods[Index].CreatedBy);
-				}
-				else
-				{
-					UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Mod opted-out of update checking: %s"), *LoadedMods[Index].FriendlyName);
-				}
-			}
+	if (Checker)
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Mods have already been checked for updates."));
+		return;
+	}
+
+	// The check belongs to the session, a menu loaded after returning from a save picks up where the last one left off
+	UMUNUpdateSubsystem* UpdateSubsystem = GetWorld()->GetGameInstance()->GetSubsystem<UMUNUpdateSubsystem>();
+	UpdateSubsystem->GetChangelogCache().SetBudget(static_cast<int64>(ModNotifierConfig.ChangelogCacheBudgetKB > 0 ? ModNotifierConfig.ChangelogCacheBudgetKB : DefaultChangelogCacheBudgetKB) * 1024);
+	UpdateSubsystem->GetIconCache()->SetDiskBudget(static_cast<int64>(ModNotifierConfig.IconCacheBudgetMB > 0 ? ModNotifierConfig.IconCacheBudgetMB : DefaultIconCacheBudgetMB) * 1024 * 1024);
+
+	TimerWorld = GetWorld();
+	Checker = UpdateSubsystem->GetMenuChecker(CheckSettings);
+	Checker->OnModChecked.AddUObject(this, &UMUNMenuModule::EvaluateModUpdate);
+	Checker->OnCheckComplete.AddUObject(this, &UMUNMenuModule::OnAllVersionsRetrieved);
+	Checker->OnChangelogFetched.AddUObject(this, &UMUNMenuModule::OnChangelogFetched);
+
+	if (!Checker->HasStarted())
+	{
+		Checker->StartCheck(ModLoadingLibrary, GetWorld()->GetSubsystem<UWorldModuleManager>());
+	}
+	else
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Reusing this session's update check, %d of %d mods retrieved."), Checker->GetNumRetrieved(), Checker->GetNumRequested());
+
+		for (const int32 RecordIndex : Checker->GetCheckedMods())
+		{
+			EvaluateModUpdate(RecordIndex);
 		}
 
-		// Create an HTTP request to send to the ficsit.app REST API to get the latest version(s) for each mod
-		for(auto& CurrentModReference : InstalledMods)
+		if (Checker->IsComplete())
 		{
-			// Create an HTTP GET request
-			FHttpRequestRef Request =  FHttpModule::Get().CreateRequest();
-			TSharedRef<FJsonObject> RequestObj = MakeShared<FJsonObject>();
-			Request->OnProcessRequestComplete().BindUObject(this, &UMUNMenuModule::OnResponseReceived);
-			Request->SetURL("https://api.ficsit.app/v1/mod/" + CurrentModReference + "/versions/all");
-			Request->SetVerb("GET");
-			Request->SetHeader(TEXT("User-Agent"), "X-UE5-ModUpdateNotifier-Agent");
-
-			PendingRequests.Add(Request);
-			Request->ProcessRequest();
+			OnAllVersionsRetrieved();
 		}
 	}
+	APIIndex = Checker->GetNumRequested();
+
+	// Don't let slow responses hold back the notification for every other mod
+	if (!Checker->IsComplete())
+	{
+		GetWorld()->GetTimerManager().SetTimer(NotificationDeadlineHandle, this, &UMUNMenuModule::OnNotificationDeadline, NotificationDeadlineSeconds, false);
+	}
 }
 
-// Parse the HTTP response to extract the data we want: "mod_reference" and "version"
-void UMUNMenuModule::OnResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful)
+void UMUNMenuModule::StartServerCheck()
 {
-	PendingRequests.Remove(Request);
-	if(bWasSuccessful){
-
-		FString LeftStringOut;
-		FString RightStringOut;
-		FString ModReference;
-		Request->GetURL().Split("https://api.ficsit.app/v1/mod/", &LeftStringOut, &RightStringOut, ESearchCase::IgnoreCase, ESearchDir::FromStart);
-		RightStringOut.Split("/versions/all", &ModReference, &RightStringOut, ESearchCase::IgnoreCase, ESearchDir::FromEnd);
-
-		// Create our JSON object
-		TSharedPtr<FJsonObject> ResponseObj;
-		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-		FJsonSerializer::Deserialize(Reader, ResponseObj);
-
-		// https://forums.unrealengine.com/t/parse-json-file-with-array-of-objects-without-converting-to-ustruct/650839/7
-		if(ResponseObj.IsValid() && ResponseObj->HasField("data"))
-		{
-			// Find the highest version from the API
-			const TArray<TSharedPtr<FJsonValue>> DataArrayObj = ResponseObj->GetArrayField(ANSI_TO_TCHAR("data"));
-
-			FVersion HighestVersion = {0,0,0};
+	UModLoadingLibrary* ModLoadingLibrary = GetWorld()->GetGameInstance()->GetSubsystem<UModLoadingLibrary>();
+	UMUNUpdateSubsystem* UpdateSubsystem = GetWorld()->GetGameInstance()->GetSubsystem<UMUNUpdateSubsystem>();
 
-			for (auto ArrayItem : DataArrayObj)
-			{
-				TSharedPtr<FJsonObject> JsonObject = ArrayItem->AsObject();
-
-				FString Version = JsonObject->GetStringField(ANSI_TO_TCHAR("version"));
-
-				FString VersionSymbols;
-				FString ChangeListNumber;
-
-				// Check if the mod supports our current game version (Useful for not showing versions exclusive to the Experimental branch)
-				JsonObject->GetStringField(ANSI_TO_TCHAR("game_version")).Split(">=", &VersionSymbols, &ChangeListNumber, ESearchCase::IgnoreCase, ESearchDir::FromStart);
-
-				uint64 NewVersionCL = UKismetStringLibrary::Conv_StringToInt64(ChangeListNumber);
-				uint64 GameCL = FEngineVersion::Current().GetChangelist();
-
-				if (NewVersionCL <= GameCL)
-				{
-					if (!Version.Contains("-"))
-					{
-						FString MajorVersionOut;
-						FString MinorVersionOut;
-						FString PatchVersionOut;
-						Version.Split(".", &MajorVersionOut,&MinorVersionOut, ESearchCase::IgnoreCase, ESearchDir::FromStart);
-						MinorVersionOut.Split(".", &MinorVersionOut, &PatchVersionOut, ESearchCase::IgnoreCase, ESearchDir::FromStart);
-
-						FVersion OutVersion = {
-							UKismetStringLibrary::Conv_StringToInt64(MajorVersionOut),
-							UKismetStringLibrary::Conv_StringToInt64(MinorVersionOut),
-							UKismetStringLibrary::Conv_StringToInt64(PatchVersionOut),
-						};
-
-						if (OutVersion.Compare(HighestVersion) == 1)
-						{
-							HighestVersion = OutVersion;
-						}
-					}
-					else if (bDebugLogging)
-					{
-							UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Version %s contains a `-`, excluding."), *Version);
-					}
-				}
-				else if (bDebugLogging)
-				{
-					UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Version %s is newer than the game version, excluding."), *Version);
-				}
-			}
+	// The subsystem outlives this module, so loading a save right away doesn't cancel the check
+	UpdateSubsystem->StartServerCheck(CheckSettings, ModLoadingLibrary, GetWorld()->GetSubsystem<UWorldModuleManager>());
+}
 
-			APIVersions[InstalledMods.Find(ModReference)] = HighestVersion;
+void UMUNMenuModule::EvaluateModUpdate(const int32 RecordIndex)
+{
+	const FMUNModRecord& CurrentMod = Checker->GetModTable().Records[RecordIndex];
+	APIIndex = Checker->GetNumRequested();
+	APIIndexRetrieved = Checker->GetNumRetrieved();
 
-			if (bDebugLogging)
-			{
-				UE_LOG(LogModUpdateNotifier, Verbose, TEXT("%s: %s"), *ModReference, *HighestVersion.ToString());
-			}
+	if (!Checker->IsUpdateAvailable(RecordIndex))
+	{
+		if (bDebugLogging)
+		{
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("The installed mod is up to date, newer than the available versions on SMR or a locked dependency. %s"), *CurrentMod.ModReference);
 		}
-		else if (bDebugLogging)
+		return;
+	}
+
+	const FAvailableUpdateInfo& ModAvailableUpdate = AvailableUpdates.Add_GetRef({
+		CurrentMod.FriendlyName,
+		CurrentMod.ModReference,
+		CurrentMod.InstalledVersion.ToString(),
+		CurrentMod.CompatibleVersion.ToString(),
+		CurrentMod.Changelog,
+		CurrentMod.SupportURL,
+		CurrentMod.bHasSupportURL,
+		CurrentMod.Author,
+		CurrentMod.LogoURL,
+	});
+
+	UMUNUpdateListItem* ListItem = NewObject<UMUNUpdateListItem>(this);
+	ListItem->Initialize(this, UpdateListItems.Num());
+	UpdateListItems.Add(ListItem);
+
+	// The notification is already open, let it add the update live. If the deadline passed without any updates, this is the first one, so show it now.
+	if (bNotificationShown)
+	{
+		OnUpdateFound.Broadcast(ModAvailableUpdate);
+		OnUpdateItemAdded.Broadcast(ListItem);
+		if (UMUNUpdateListView* ListView = UpdateListView.Get())
 		{
-			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Invalid response: no field \"data\" found."));
+			ListView->AddItem(ListItem);
 		}
+		PrefetchChangelogs();
+	}
+	else if (bNotificationDeadlinePassed)
+	{
+		ShowNotification();
+	}
+}
 
-		APIIndexRetrieved++;
+void UMUNMenuModule::OnAllVersionsRetrieved()
+{
+	GetWorld()->GetTimerManager().ClearTimer(NotificationDeadlineHandle);
 
-		// If the API version list is as long as the list of mods we've asked for, compare it to the known version list
-		if(APIIndex == APIIndexRetrieved)
-		{
-			for (int Index = 0; Index < APIVersions.Num(); Index++)
-			{
-				bool IsModOutOfDate = false;
-
-				// Create an index of the current version in the array that we are processing
-				FVersion CurrentAPIVersion = APIVersions[Index];
-
-				if (CurrentAPIVersion.Compare(InstalledModVersions[Index]) == 1)
-				{
-					IsModOutOfDate = true;
-				}
-				else if (bDebugLogging)
-				{
-					UE_LOG(LogModUpdateNotifier, Verbose, TEXT("The installed mod is up to date or newer than the available versions on SMR. %s"), *InstalledMods[Index]);
-				}
-
-				if (IsModOutOfDate && !LockedDependencies.Contains(InstalledMods[Index])) // Only add if the mod is out of date and is not a locked dependency
-				{
-					FAvailableUpdateInfo ModAvailableUpdate = {
-						InstalledModFriendlyNames[Index],
-						InstalledMods[Index],
-						InstalledModVersions[Index].ToString(),
-						APIVersions[Index].ToString(),
-						ModChangelogs[Index],
-						SupportURLs[Index],
-						HasSupportURLs[Index],
-						ModAuthors[Index],
-					};
-
-					AvailableUpdates.Add(ModAvailableUpdate);
-				}
-			}
+	if (AvailableUpdates.IsEmpty())
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("All mods are up to date, not displaying a notification."));
+		return;
+	}
 
-			// If there are out of date mods in the list, create the menu widget. Also check if we are running on a server and not display the menu widget.
-			if (!AvailableUpdates.IsEmpty() && this->GetWorld()->GetNetMode() != NM_DedicatedServer)
-			{
-				// Add the popup in the Main Menu
-				const FPopupClosed CloseDelegate;
+	ShowNotification();
+	PrefetchChangelogs();
+}
 
-				UFGBlueprintFunctionLibrary::AddPopupWithCloseDelegate(this->GetWorld()->GetFirstPlayerController(), FText::FromString("Mod Update Notifier"), FText::FromString("Body Text"), CloseDelegate, PID_NONE, MenuWidgetClass, this, false);
-			}
-			else
-			{
-				UE_LOG(LogModUpdateNotifier, Verbose, TEXT("All mods are up to date, not displaying a notification."));
-			}
-		}
+void UMUNMenuModule::OnNotificationDeadline()
+{
+	MUN_SCOPE_GAME_THREAD();
+
+	bNotificationDeadlinePassed = true;
+
+	UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Notification deadline passed with %d of %d mods retrieved, showing %d updates found so far."), APIIndexRetrieved, APIIndex, AvailableUpdates.Num());
+
+	ShowNotification();
+	PrefetchChangelogs();
+}
+
+void UMUNMenuModule::ShowNotification()
+{
+	// If there are out of date mods in the list, create the menu widget. Also check if we are running on a server and not display the menu widget.
+	if (bNotificationShown || AvailableUpdates.IsEmpty() || this->GetWorld()->GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	bNotificationShown = true;
+	FMUNCheckReport::Get().RecordNotificationShown();
+
+	// Worlds without a local player, like the benchmarks' headless ones, have no one to show the popup to
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (!PlayerController)
+	{
+		return;
+	}
+
+	MUN_SCOPE_PHASE(PopupCreation, TEXT("Popup creation"));
+
+	// Add the popup in the Main Menu
+	const FPopupClosed CloseDelegate;
+
+	UFGBlueprintFunctionLibrary::AddPopupWithCloseDelegate(PlayerController, FText::FromString("Mod Update Notifier"), FText::FromString("Body Text"), CloseDelegate, PID_NONE, MenuWidgetClass, this, false);
+
+	if (MenuWidgetClass)
+	{
+		GetWorld()->GetTimerManager().SetTimer(AttachUpdateListHandle, this, &UMUNMenuModule::AttachUpdateList, AttachUpdateListIntervalSeconds, true, 0.0f);
+	}
+}
+
+void UMUNMenuModule::AttachUpdateList()
+{
+	MUN_SCOPE_GAME_THREAD();
+
+	TArray<UUserWidget*> Notifications;
+	UWidgetBlueprintLibrary::GetAllWidgetsOfClass(this, Notifications, MenuWidgetClass, false);
+	if (Notifications.IsEmpty())
+	{
+		return;
+	}
+
+	GetWorld()->GetTimerManager().ClearTimer(AttachUpdateListHandle);
+	NotificationWidget = Notifications[0];
+
+	UPanelWidget* UpdatePanel = NotificationWidget->WidgetTree ? Cast<UPanelWidget>(NotificationWidget->WidgetTree->FindWidget(TEXT("UpdatePanel"))) : nullptr;
+	if (!UpdatePanel || !UpdatePanel->GetParent())
+	{
+		UE_LOG(LogModUpdateNotifier, Warning, TEXT("%s has no UpdatePanel, keeping the rows it builds itself."), *MenuWidgetClass->GetName());
+		return;
+	}
+
+	// A list view scrolls on its own, inside a scroll box it would be given unlimited height and create a row for every update
+	UWidget* Replaced = UpdatePanel;
+	if (UpdatePanel->GetParent()->IsA<UScrollBox>() && UpdatePanel->GetParent()->GetParent())
+	{
+		Replaced = UpdatePanel->GetParent();
+	}
+
+	UMUNUpdateListView* ListView = NotificationWidget->WidgetTree->ConstructWidget<UMUNUpdateListView>();
+	ListView->SetListItems(GetUpdateListItems());
+	ListView->OnItemClicked().AddUObject(this, &UMUNMenuModule::OnUpdateItemClicked);
+
+	// The widget's own rows stay in the detached panel, which it can keep adding to without it being seen
+	UPanelWidget* Parent = Replaced->GetParent();
+	Parent->ReplaceChildAt(Parent->GetChildIndex(Replaced), ListView);
+	UpdateListView = ListView;
+
+	if (bDebugLogging)
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Showing %d updates in a list view."), UpdateListItems.Num());
+	}
+}
+
+void UMUNMenuModule::OnUpdateItemClicked(UObject* Item)
+{
+	const UMUNUpdateListItem* ListItem = Cast<UMUNUpdateListItem>(Item);
+	if (!ListItem || !AvailableUpdates.IsValidIndex(ListItem->GetUpdateIndex()))
+	{
+		return;
+	}
+
+	// The info panel fills in the support links and asks for the changelog itself. Without it, only the changelog is shown.
+	UUserWidget* Notification = NotificationWidget.Get();
+	UFunction* LoadInfoPanel = Notification ? Notification->FindFunction(LoadInfoPanelName) : nullptr;
+	if (LoadInfoPanel && LoadInfoPanel->NumParms == 1 && CastField<FIntProperty>(LoadInfoPanel->ChildProperties))
+	{
+		int32 ModIndex = ListItem->GetUpdateIndex();
+		Notification->ProcessEvent(LoadInfoPanel, &ModIndex);
+	}
+	else
+	{
+		GetChangelog(AvailableUpdates[ListItem->GetUpdateIndex()].ModReference);
 	}
-	else {
-		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Unable to connect to the API, user may be offline."));
+}
+
+void UMUNMenuModule::ModUpdateReport()
+{
+	FMUNCheckReport::Get().LogSummary();
+}
+
+void UMUNMenuModule::ModUpdateReportCsv()
+{
+	FMUNCheckReport::Get().LogSummary();
+
+	const FString CsvPath = FMUNCheckReport::GetDefaultCsvPath();
+	if (FMUNCheckReport::Get().WriteCsv(CsvPath))
+	{
+		UE_LOG(LogModUpdateNotifier, Display, TEXT("Wrote check report to %s"), *CsvPath);
+	}
+	else
+	{
+		UE_LOG(LogModUpdateNotifier, Warning, TEXT("Unable to write check report: %s"), *CsvPath);
 	}
 }
 
@@ -336,76 +325,269 @@ void UMUNMenuModule::GetAvailableUpdates(TArray<FAvailableUpdateInfo>& OutAvaila
 	OutAvailableUpdates = AvailableUpdates;
 }
 
+bool UMUNMenuModule::GetAvailableUpdate(const int32 Index, FAvailableUpdateInfo& OutUpdateInfo) const
+{
+	if (!AvailableUpdates.IsValidIndex(Index))
+	{
+		return false;
+	}
+
+	OutUpdateInfo = AvailableUpdates[Index];
+	return true;
+}
+
+void UMUNMenuModule::GetAvailableUpdatesPage(const int32 FirstIndex, const int32 Count, TArray<FAvailableUpdateInfo>& OutAvailableUpdates) const
+{
+	OutAvailableUpdates.Reset();
+
+	const int32 StartIndex = FMath::Max(FirstIndex, 0);
+	const int32 EndIndex = FMath::Min(StartIndex + FMath::Max(Count, 0), AvailableUpdates.Num());
+	if (StartIndex < EndIndex)
+	{
+		OutAvailableUpdates.Append(AvailableUpdates.GetData() + StartIndex, EndIndex - StartIndex);
+	}
+}
+
+TArray<UMUNUpdateListItem*> UMUNMenuModule::GetUpdateListItems() const
+{
+	return TArray<UMUNUpdateListItem*>(UpdateListItems);
+}
+
+int32 UMUNMenuModule::GetModCount() const
+{
+	return Checker ? Checker->GetModTable().Num() : 0;
+}
+
+bool UMUNMenuModule::GetModRecord(const int32 Index, FMUNModRecord& OutModRecord) const
+{
+	if (!Checker || !Checker->GetModTable().Records.IsValidIndex(Index))
+	{
+		return false;
+	}
+
+	OutModRecord = Checker->GetModTable().Records[Index];
+	return true;
+}
+
+bool UMUNMenuModule::FindModRecord(const FString& ModReference, FMUNModRecord& OutModRecord) const
+{
+	if (const FMUNModRecord* ModRecord = Checker ? Checker->GetModTable().Find(ModReference) : nullptr)
+	{
+		OutModRecord = *ModRecord;
+		return true;
+	}
+
+	return false;
+}
+
 void UMUNMenuModule::GetChangelog(const FString ModReference)
 {
-	if (ModChangelogs[InstalledMods.Find(ModReference)] != "Unfulfilled")
+	MUN_SCOPE_GAME_THREAD();
+
+	const FMUNModRecord* ModRecord = Checker ? Checker->GetModTable().Find(ModReference) : nullptr;
+	if (!ModRecord)
 	{
-		ChangelogProcessed(ModChangelogs[InstalledMods.Find(ModReference)]);
+		return;
+	}
+
+	// Whatever was asked for before is no longer wanted
+	StopChangelogChunks();
+	DisplayedChangelog.Empty();
+
+	if (const TSharedPtr<const FMUNRenderedChangelog> Rendered = GetChangelogCache().Find(ModReference))
+	{
+		ShowRenderedChangelog(Rendered.ToSharedRef());
+		return;
+	}
+
+	// Show it once it has arrived and been rendered, only sending a request if one isn't in flight already
+	DisplayedChangelog = ModReference;
+
+	if (ModRecord->ChangelogState == EMUNChangelogState::Fetched)
+	{
+		RenderChangelog(ModReference, ModRecord->Changelog);
 	}
 	else
 	{
-		// Create an HTTP GET request
-		const FHttpRequestRef Request =  FHttpModule::Get().CreateRequest();
-		TSharedRef<FJsonObject> RequestObj = MakeShared<FJsonObject>();
-		Request->OnProcessRequestComplete().BindUObject(this, &UMUNMenuModule::OnChangelogReceived);
-		Request->SetURL("https://api.ficsit.app/v2/query");
-		Request->SetContentAsString("{\"query\": \"{ getModByReference(modReference:" + ModReference + ") { version(version: \\\"" + APIVersions[InstalledMods.Find(ModReference)].ToString() + "\\\") { changelog mod { mod_reference } } } }\"}");
+		Checker->RequestChangelogs({ModReference});
+	}
+}
+
+void UMUNMenuModule::PrefetchChangelogs()
+{
+	TArray<FString> ModReferences;
+	for (int32 Index = 0; Index < FMath::Min(MaxPrefetchedChangelogs, AvailableUpdates.Num()); Index++)
+	{
+		ModReferences.Add(AvailableUpdates[Index].ModReference);
+	}
+
+	Checker->RequestChangelogs(ModReferences);
+}
+
+void UMUNMenuModule::OnChangelogFetched(const int32 RecordIndex)
+{
+	const FMUNModRecord& ModRecord = Checker->GetModTable().Records[RecordIndex];
+	if (ModRecord.ChangelogState != EMUNChangelogState::Fetched)
+	{
+		return;
+	}
+
+	for (FAvailableUpdateInfo& AvailableUpdate : AvailableUpdates)
+	{
+		if (AvailableUpdate.ModReference == ModRecord.ModReference)
+		{
+			AvailableUpdate.ModChangelog = ModRecord.Changelog;
+			break;
+		}
+	}
 
-		Request->SetVerb("POST");
-		Request->SetHeader(TEXT("User-Agent"), "X-UE5-ModUpdateNotifier-Agent");
-		Request->SetHeader("Content-Type", TEXT("application/json"));
+	// A re-check can bring a newer version with a different changelog
+	GetChangelogCache().Remove(ModRecord.ModReference);
 
-		PendingRequests.Add(Request);
-		Request->ProcessRequest();
+	if (DisplayedChangelog == ModRecord.ModReference)
+	{
+		RenderChangelog(ModRecord.ModReference, ModRecord.Changelog);
 	}
 }
 
-void UMUNMenuModule::OnChangelogReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful)
+void UMUNMenuModule::RenderChangelog(const FString& ModReference, const FString& Changelog)
 {
-	PendingRequests.Remove(Request);
-	if(bWasSuccessful)
+	if (RenderingChangelogs.Contains(ModReference))
 	{
-		// Create our JSON object
-		TSharedPtr<FJsonObject> ResponseObj;
-		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Response->GetContentAsString());
-		FJsonSerializer::Deserialize(Reader, ResponseObj);
+		return;
+	}
+	RenderingChangelogs.Add(ModReference);
+
+	TWeakObjectPtr<UMUNMenuModule> WeakThis = this;
+	const EMUNChangelogFormat Format = WantsRenderedChangelogs() ? EMUNChangelogFormat::RichText : EMUNChangelogFormat::PlainText;
 
-		if(ResponseObj && ResponseObj->HasField("data"))
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [WeakThis, ModReference, Changelog, Format]()
+	{
+		const TSharedRef<const FMUNRenderedChangelog> Rendered = FMUNChangelogRenderer::Render(Changelog, ChangelogChunkCharacters, Format);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, ModReference, Rendered]()
 		{
-			if(const TSharedPtr<FJsonObject> DataObj = ResponseObj->GetObjectField("data"); DataObj && DataObj->HasField("getModByReference"))
+			if (UMUNMenuModule* This = WeakThis.Get())
 			{
-				const TSharedPtr<FJsonObject> VersionObj = ResponseObj->GetObjectField("data")->GetObjectField("getModByReference")->GetObjectField("version");
+				This->OnChangelogRendered(ModReference, Rendered);
+			}
+		});
+	});
+}
 
-				const FString ModReference = VersionObj->GetObjectField("mod")->GetStringField("mod_reference");
+void UMUNMenuModule::OnChangelogRendered(const FString& ModReference, const TSharedRef<const FMUNRenderedChangelog>& Rendered)
+{
+	MUN_SCOPE_GAME_THREAD();
 
-				const FString Changelog = VersionObj->GetStringField("changelog");
+	RenderingChangelogs.Remove(ModReference);
 
-				ModChangelogs[InstalledMods.Find(ModReference)] = Changelog;
+	FMUNChangelogCache& ChangelogCache = GetChangelogCache();
+	ChangelogCache.Add(ModReference, Rendered);
 
-				ChangelogProcessed(Changelog);
-			}
-		}
+	if (bDebugLogging)
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Rendered the changelog of %s into %d chunks, %d changelogs cached using %lld bytes."), *ModReference, Rendered->Chunks.Num(), ChangelogCache.Num(), ChangelogCache.GetNumBytes());
 	}
-	else {
-		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Unable to connect to the API, user may be offline."));
+
+	if (DisplayedChangelog == ModReference)
+	{
+		DisplayedChangelog.Empty();
+		ShowRenderedChangelog(Rendered);
 	}
 }
 
-void UMUNMenuModule::BeginDestroy()
+void UMUNMenuModule::ShowRenderedChangelog(const TSharedRef<const FMUNRenderedChangelog>& Rendered)
 {
-	CancelPendingRequests();
-	Super::BeginDestroy();
+	StopChangelogChunks();
+	ShownChangelogText = Rendered->Chunks.IsEmpty() ? FString() : Rendered->Chunks[0];
+	ChangelogProcessed(ShownChangelogText);
+
+	if (Rendered->Chunks.Num() > 1)
+	{
+		ShownChangelog = Rendered;
+		NextChangelogChunk = 1;
+		ChangelogChunkHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UMUNMenuModule::ShowNextChangelogChunk);
+	}
 }
 
-void UMUNMenuModule::CancelPendingRequests()
+void UMUNMenuModule::ShowNextChangelogChunk()
 {
-	for (const FHttpRequestPtr& Request : PendingRequests)
+	MUN_SCOPE_GAME_THREAD();
+
+	ChangelogChunkHandle.Invalidate();
+	if (!ShownChangelog.IsValid())
 	{
-		if (Request.IsValid())
-		{
-			Request->CancelRequest();
-		}
+		return;
+	}
+
+	const TSharedRef<const FMUNRenderedChangelog> Shown = ShownChangelog.ToSharedRef();
+	const FString& Chunk = Shown->Chunks[NextChangelogChunk++];
+	if (WantsRenderedChangelogs())
+	{
+		ChangelogChunkReady(Chunk);
+	}
+	else
+	{
+		// Chunks end where lines do, so the text shown so far grows by whole lines
+		ShownChangelogText += Chunk;
+		ChangelogProcessed(ShownChangelogText);
+	}
+
+	// The widget may have asked for another changelog in the meantime
+	if (ShownChangelog != Shown)
+	{
+		return;
 	}
 
-	PendingRequests.Empty();
+	if (NextChangelogChunk < Shown->Chunks.Num())
+	{
+		ChangelogChunkHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UMUNMenuModule::ShowNextChangelogChunk);
+	}
+	else
+	{
+		ShownChangelog.Reset();
+		ShownChangelogText.Empty();
+	}
+}
+
+void UMUNMenuModule::StopChangelogChunks()
+{
+	if (const UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(ChangelogChunkHandle);
+	}
+	ShownChangelog.Reset();
+	ShownChangelogText.Empty();
+	NextChangelogChunk = 0;
+}
+
+FMUNChangelogCache& UMUNMenuModule::GetChangelogCache() const
+{
+	return GetWorld()->GetGameInstance()->GetSubsystem<UMUNUpdateSubsystem>()->GetChangelogCache();
+}
+
+bool UMUNMenuModule::WantsRenderedChangelogs() const
+{
+	return GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UMUNMenuModule, ChangelogChunkReady));
+}
+
+void UMUNMenuModule::BeginDestroy()
+{
+	// Reaching the world through the outer chain isn't safe during garbage collection, the world may be going away too
+	if (UWorld* World = TimerWorld.Get())
+	{
+		World->GetTimerManager().ClearTimer(NotificationDeadlineHandle);
+		World->GetTimerManager().ClearTimer(AttachUpdateListHandle);
+		World->GetTimerManager().ClearTimer(ChangelogChunkHandle);
+	}
+
+	// The check and its requests belong to the session, the next menu attaches to them
+	if (Checker)
+	{
+		Checker->OnModChecked.RemoveAll(this);
+		Checker->OnCheckComplete.RemoveAll(this);
+		Checker->OnChangelogFetched.RemoveAll(this);
+	}
+
+	Super::BeginDestroy();
 }
@@ -0,0 +1,318 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNModpackCheckCommandlet.h"
+
+#include "ModUpdateNotifier.h"
+#include "MUNUpdateChecker.h"
+#include "MUNSemVer.h"
+#include "Http.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+bool FMUNModpackProfile::LoadFromFile(const FString& ManifestPath, FMUNModpackProfile& OutProfile)
+{
+	FString Content;
+	if (!FFileHelper::LoadFileToString(Content, *ManifestPath))
+	{
+		UE_LOG(LogModUpdateNotifier, Error, TEXT("Unable to read modpack manifest: %s"), *ManifestPath);
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> ManifestObj;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Content);
+	if (!FJsonSerializer::Deserialize(Reader, ManifestObj) || !ManifestObj.IsValid())
+	{
+		UE_LOG(LogModUpdateNotifier, Error, TEXT("Modpack manifest is not valid JSON: %s"), *ManifestPath);
+		return false;
+	}
+
+	OutProfile = FMUNModpackProfile();
+	OutProfile.ManifestPath = ManifestPath;
+	if (!ManifestObj->TryGetStringField(TEXT("name"), OutProfile.Name) || OutProfile.Name.IsEmpty())
+	{
+		OutProfile.Name = FPaths::GetBaseFilename(ManifestPath);
+	}
+
+	auto AddMod = [&OutProfile, &ManifestPath](const FString& ModReference, const FString& Version)
+	{
+		TMUNSemVer<TCHAR> SemVer;
+		if (ModReference.IsEmpty() || !TMUNSemVer<TCHAR>::Parse(Version, SemVer))
+		{
+			UE_LOG(LogModUpdateNotifier, Warning, TEXT("Skipping %s in %s, \"%s\" is not a valid version."), *ModReference, *ManifestPath, *Version);
+			return;
+		}
+
+		OutProfile.Mods.Add({ModReference, SemVer.ToVersion()});
+	};
+
+	const TArray<TSharedPtr<FJsonValue>>* ModValues;
+	const TSharedPtr<FJsonObject>* ModsObj;
+	if (ManifestObj->TryGetArrayField(TEXT("mods"), ModValues))
+	{
+		for (const TSharedPtr<FJsonValue>& ModValue : *ModValues)
+		{
+			const TSharedPtr<FJsonObject>* ModObj;
+			if (ModValue->TryGetObject(ModObj))
+			{
+				AddMod((*ModObj)->GetStringField(TEXT("mod_reference")), (*ModObj)->GetStringField(TEXT("version")));
+			}
+		}
+	}
+	else if (ManifestObj->TryGetObjectField(TEXT("mods"), ModsObj))
+	{
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& ModField : (*ModsObj)->Values)
+		{
+			// Lockfiles nest the version in an object, hand-written manifests usually give it directly
+			const TSharedPtr<FJsonObject>* ModObj;
+			AddMod(ModField.Key, ModField.Value->TryGetObject(ModObj) ? (*ModObj)->GetStringField(TEXT("version")) : ModField.Value->AsString());
+		}
+	}
+	else
+	{
+		UE_LOG(LogModUpdateNotifier, Error, TEXT("Modpack manifest has no mods: %s"), *ManifestPath);
+		return false;
+	}
+
+	return true;
+}
+
+UMUNModpackCheckCommandlet::UMUNModpackCheckCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UMUNModpackCheckCommandlet::Main(const FString& Params)
+{
+	// Same API base URL and request settings as the in-game check, -MUNApiBaseURL= points it at a mirror or a local stand-in server
+	FMUNCheckSettings Settings = FMUNCheckSettings::FromConfig(FMUNCheckSettings::LoadConfigFile());
+	Settings.bIncludePreReleases = FParse::Param(*Params, TEXT("IncludePreReleases"));
+
+	// Profiles list other mods than the installed ones, confirming them says nothing about the mods the game checks
+	Settings.bRecordBaseline = false;
+
+	FString OutputDir = GetDefaultOutputDir();
+	FParse::Value(*Params, TEXT("OutputDir="), OutputDir);
+
+	FString Format = TEXT("both");
+	FParse::Value(*Params, TEXT("Format="), Format);
+	const bool bWriteJson = Format != TEXT("csv");
+	const bool bWriteCsv = Format != TEXT("json");
+
+	FString ProfileList;
+	TArray<FString> ProfilePaths;
+	if (!FParse::Value(*Params, TEXT("Profiles="), ProfileList, false) || ProfileList.ParseIntoArray(ProfilePaths, TEXT(",")) == 0)
+	{
+		UE_LOG(LogModUpdateNotifier, Error, TEXT("No modpack manifests given, pass them with -Profiles=<paths>."));
+		return 1;
+	}
+
+	TArray<FString> ManifestPaths;
+	for (const FString& ProfilePath : ProfilePaths)
+	{
+		if (FPaths::DirectoryExists(ProfilePath))
+		{
+			TArray<FString> FoundManifests;
+			IFileManager::Get().FindFiles(FoundManifests, *FPaths::Combine(ProfilePath, TEXT("*.json")), true, false);
+			FoundManifests.Sort();
+			for (const FString& FoundManifest : FoundManifests)
+			{
+				ManifestPaths.Add(FPaths::Combine(ProfilePath, FoundManifest));
+			}
+		}
+		else
+		{
+			ManifestPaths.Add(ProfilePath);
+		}
+	}
+
+	TArray<FMUNModpackProfile> Profiles;
+	TSet<FString> ReportNames;
+	bool bHadErrors = false;
+	for (const FString& ManifestPath : ManifestPaths)
+	{
+		FMUNModpackProfile Profile;
+		if (!FMUNModpackProfile::LoadFromFile(ManifestPath, Profile))
+		{
+			bHadErrors = true;
+			continue;
+		}
+
+		// Profiles sharing a name would overwrite each other's reports
+		const FString BaseName = FPaths::MakeValidFileName(Profile.Name);
+		Profile.Name = BaseName;
+		for (int32 Suffix = 2; ReportNames.Contains(Profile.Name); Suffix++)
+		{
+			Profile.Name = FString::Printf(TEXT("%s_%d"), *BaseName, Suffix);
+		}
+		ReportNames.Add(Profile.Name);
+
+		Profiles.Add(MoveTemp(Profile));
+	}
+
+	// Every mod reference is checked once, however many profiles list it. The installed version of the shared record
+	// doesn't matter, each profile is compared against the remote versions with its own.
+	FMUNModTable ModTable;
+	int32 NumProfileMods = 0;
+	for (const FMUNModpackProfile& Profile : Profiles)
+	{
+		NumProfileMods += Profile.Mods.Num();
+		for (const FMUNModpackProfile::FMod& Mod : Profile.Mods)
+		{
+			if (ModTable.IndexOf(Mod.ModReference) == INDEX_NONE)
+			{
+				FMUNModRecord ModRecord;
+				ModRecord.ModReference = Mod.ModReference;
+				ModRecord.FriendlyName = Mod.ModReference;
+				ModRecord.InstalledVersion = Mod.InstalledVersion;
+				ModTable.Add(MoveTemp(ModRecord));
+			}
+		}
+	}
+
+	if (ModTable.Num() == 0)
+	{
+		UE_LOG(LogModUpdateNotifier, Error, TEXT("None of the given modpack manifests list any mods."));
+		return 1;
+	}
+
+	UE_LOG(LogModUpdateNotifier, Display, TEXT("Checking %d unique mods listed %d times across %d profiles against %s"), ModTable.Num(), NumProfileMods, Profiles.Num(), *Settings.APIBaseURL);
+
+	// Manifests don't carry dependency ranges, so every mod is offered its newest compatible version
+	bool bCheckComplete = false;
+	const TSharedRef<FMUNVersionCache> VersionCache = MakeShared<FMUNVersionCache>();
+	Checker = NewObject<UMUNUpdateChecker>(this);
+	Checker->Initialize(Settings, VersionCache);
+	Checker->OnCheckComplete.AddLambda([&bCheckComplete]() { bCheckComplete = true; });
+	Checker->StartCheck(MoveTemp(ModTable));
+
+	// There is no game loop in a commandlet, so drive HTTP, the scheduler's retry timers and the parse results posted back
+	// to the game thread by hand
+	double LastTickTime = FPlatformTime::Seconds();
+	while (!bCheckComplete)
+	{
+		FPlatformProcess::Sleep(0.01f);
+
+		const double Now = FPlatformTime::Seconds();
+		FHttpModule::Get().GetHttpManager().Tick(Now - LastTickTime);
+		FTSTicker::GetCoreTicker().Tick(Now - LastTickTime);
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		LastTickTime = Now;
+	}
+
+	// The cache is written on a worker, don't exit before it is on disk
+	VersionCache->Flush();
+
+	// The check is complete and nothing writes to it anymore, so every profile can read it at once
+	IFileManager::Get().MakeDirectory(*OutputDir, true);
+
+	std::atomic<int32> NumReportsWritten = 0;
+	ParallelFor(Profiles.Num(), [&](const int32 ProfileIndex)
+	{
+		if (WriteProfileReport(Profiles[ProfileIndex], *Checker, OutputDir, bWriteJson, bWriteCsv))
+		{
+			++NumReportsWritten;
+		}
+	});
+
+	if (NumReportsWritten != Profiles.Num())
+	{
+		bHadErrors = true;
+	}
+
+	UE_LOG(LogModUpdateNotifier, Display, TEXT("Wrote reports of %d profiles to %s"), NumReportsWritten.load(), *OutputDir);
+	return bHadErrors ? 1 : 0;
+}
+
+bool UMUNModpackCheckCommandlet::WriteProfileReport(const FMUNModpackProfile& Profile, const UMUNUpdateChecker& CompletedCheck, const FString& OutputDir, const bool bWriteJson, const bool bWriteCsv)
+{
+	const FMUNModTable& ModTable = CompletedCheck.GetModTable();
+
+	TArray<TSharedPtr<FJsonValue>> ModValues;
+	FString Csv = TEXT("mod_reference,installed_version,available_version,newest_version,status\n");
+	int32 NumOutdated = 0;
+
+	for (const FMUNModpackProfile::FMod& Mod : Profile.Mods)
+	{
+		const FMUNModRecord* ModRecord = ModTable.Find(Mod.ModReference);
+		check(ModRecord);
+
+		// Mods not found on SMR or without a release for this game version have no remote version at all
+		const TCHAR* Status = TEXT("up_to_date");
+		if (ModRecord->APIVersion.Compare(FVersion{0,0,0}) == 0)
+		{
+			Status = TEXT("unknown");
+		}
+		else if (UMUNUpdateChecker::IsUpdateAvailable(*ModRecord, Mod.InstalledVersion))
+		{
+			Status = TEXT("outdated");
+			NumOutdated++;
+		}
+
+		const FString InstalledVersion = Mod.InstalledVersion.ToString();
+		const FString AvailableVersion = ModRecord->CompatibleVersion.ToString();
+		const FString NewestVersion = ModRecord->APIVersion.ToString();
+
+		const TSharedRef<FJsonObject> ModObj = MakeShared<FJsonObject>();
+		ModObj->SetStringField(TEXT("mod_reference"), Mod.ModReference);
+		ModObj->SetStringField(TEXT("installed_version"), InstalledVersion);
+		ModObj->SetStringField(TEXT("available_version"), AvailableVersion);
+		ModObj->SetStringField(TEXT("newest_version"), NewestVersion);
+		ModObj->SetStringField(TEXT("status"), Status);
+		ModValues.Add(MakeShared<FJsonValueObject>(ModObj));
+
+		// Mod references and versions never contain commas or quotes, so nothing needs escaping
+		Csv += FString::Printf(TEXT("%s,%s,%s,%s,%s\n"), *Mod.ModReference, *InstalledVersion, *AvailableVersion, *NewestVersion, Status);
+	}
+
+	bool bWritten = true;
+
+	if (bWriteJson)
+	{
+		const TSharedRef<FJsonObject> ReportObj = MakeShared<FJsonObject>();
+		ReportObj->SetStringField(TEXT("generated_at"), FDateTime::UtcNow().ToIso8601());
+		ReportObj->SetStringField(TEXT("profile"), Profile.Name);
+		ReportObj->SetStringField(TEXT("manifest"), Profile.ManifestPath);
+		ReportObj->SetStringField(TEXT("api_base_url"), CompletedCheck.GetSettings().APIBaseURL);
+		ReportObj->SetNumberField(TEXT("mods_checked"), Profile.Mods.Num());
+		ReportObj->SetNumberField(TEXT("updates_available"), NumOutdated);
+		ReportObj->SetArrayField(TEXT("mods"), ModValues);
+
+		FString Report;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Report);
+		FJsonSerializer::Serialize(ReportObj, Writer);
+
+		const FString ReportPath = FPaths::Combine(OutputDir, Profile.Name + TEXT(".json"));
+		if (!FFileHelper::SaveStringToFile(Report, *ReportPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+		{
+			UE_LOG(LogModUpdateNotifier, Error, TEXT("Unable to write modpack report: %s"), *ReportPath);
+			bWritten = false;
+		}
+	}
+
+	if (bWriteCsv)
+	{
+		const FString ReportPath = FPaths::Combine(OutputDir, Profile.Name + TEXT(".csv"));
+		if (!FFileHelper::SaveStringToFile(Csv, *ReportPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+		{
+			UE_LOG(LogModUpdateNotifier, Error, TEXT("Unable to write modpack report: %s"), *ReportPath);
+			bWritten = false;
+		}
+	}
+
+	UE_LOG(LogModUpdateNotifier, Display, TEXT("%s: %d of %d mods have updates available"), *Profile.Name, NumOutdated, Profile.Mods.Num());
+	return bWritten;
+}
+
+FString UMUNModpackCheckCommandlet::GetDefaultOutputDir()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ModUpdateNotifier"), TEXT("Modpacks"));
+}
@@ -0,0 +1,283 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNRequestScheduler.h"
+
+#include "ModUpdateNotifier.h"
+#include "MUNStats.h"
+#include "Misc/Compression.h"
+
+FMUNRequestScheduler::FMUNRequestScheduler(const FMUNRequestSettings& InSettings)
+	: Settings(InSettings)
+{
+	Settings.MaxConcurrentRequests = FMath::Max(1, Settings.MaxConcurrentRequests);
+}
+
+FMUNRequestScheduler::~FMUNRequestScheduler()
+{
+	CancelAll();
+}
+
+void FMUNRequestScheduler::Enqueue(const FHttpRequestRef& Request, const FHttpRequestCompleteDelegate& OnComplete, const FString& Label)
+{
+	Request->SetTimeout(Settings.TimeoutSeconds);
+
+	// Version histories and changelogs are repetitive JSON and shrink a lot when compressed
+	Request->SetHeader(TEXT("Accept-Encoding"), TEXT("gzip"));
+
+	const TSharedRef<FScheduledRequest> Scheduled = MakeShared<FScheduledRequest>();
+	Scheduled->Request = Request;
+	Scheduled->OnComplete = OnComplete;
+	Scheduled->Label = Label.IsEmpty() ? Request->GetURL() : Label;
+
+	Queue.Add(Scheduled);
+	PumpQueue();
+}
+
+void FMUNRequestScheduler::CancelAll()
+{
+	for (const TSharedRef<FScheduledRequest>& Scheduled : InFlight)
+	{
+		// Unbind first so the cancellation isn't treated as a failure worth retrying
+		Scheduled->Request->OnProcessRequestComplete().Unbind();
+		Scheduled->Request->CancelRequest();
+	}
+
+	for (const TSharedRef<FScheduledRequest>& Scheduled : Waiting)
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(Scheduled->RetryHandle);
+	}
+
+	if (ResumeHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(ResumeHandle);
+		ResumeHandle.Reset();
+	}
+
+	Queue.Empty();
+	InFlight.Empty();
+	Waiting.Empty();
+
+	SET_DWORD_STAT(STAT_MUN_RequestsInFlight, 0);
+}
+
+void FMUNRequestScheduler::PumpQueue()
+{
+	MUN_SCOPE_GAME_THREAD();
+
+	// Hold everything back while the server has asked us to wait or the dispatch interval hasn't passed, and come back once the time is up
+	const double Now = FPlatformTime::Seconds();
+	const double NextDispatchTime = FMath::Max(ResumeTime, LastDispatchTime + Settings.MinDispatchIntervalSeconds);
+	if (Now < NextDispatchTime)
+	{
+		if (!Queue.IsEmpty())
+		{
+			ScheduleResume(static_cast<float>(NextDispatchTime - Now));
+		}
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(MUN_PumpQueue);
+
+	while (InFlight.Num() < Settings.MaxConcurrentRequests && !Queue.IsEmpty())
+	{
+		const TSharedRef<FScheduledRequest> Scheduled = Queue[0];
+		Queue.RemoveAt(0);
+
+		if (Scheduled->FirstDispatchTime == 0.0)
+		{
+			Scheduled->FirstDispatchTime = Now;
+		}
+
+		InFlight.Add(Scheduled);
+		Scheduled->Request->OnProcessRequestComplete().BindSP(this, &FMUNRequestScheduler::OnRequestComplete, Scheduled);
+		Scheduled->Request->ProcessRequest();
+		LastDispatchTime = Now;
+
+		// Only one request per interval, the next one goes out once it has passed
+		if (Settings.MinDispatchIntervalSeconds > 0.0f)
+		{
+			if (!Queue.IsEmpty() && InFlight.Num() < Settings.MaxConcurrentRequests)
+			{
+				ScheduleResume(Settings.MinDispatchIntervalSeconds);
+			}
+			break;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_MUN_RequestsInFlight, InFlight.Num());
+}
+
+void FMUNRequestScheduler::ScheduleResume(const float Delay)
+{
+	if (ResumeHandle.IsValid())
+	{
+		return;
+	}
+
+	TWeakPtr<FMUNRequestScheduler> WeakThis = AsShared();
+	ResumeHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis](float)
+	{
+		if (const TSharedPtr<FMUNRequestScheduler> This = WeakThis.Pin())
+		{
+			This->ResumeHandle.Reset();
+			This->PumpQueue();
+		}
+		return false;
+	}), Delay);
+}
+
+void FMUNRequestScheduler::OnRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, TSharedRef<FScheduledRequest> Scheduled)
+{
+	MUN_SCOPE_GAME_THREAD();
+
+	InFlight.Remove(Scheduled);
+
+	// Connection failures, timeouts, rate limiting and server errors are worth another try, anything else is final
+	const int32 ResponseCode = Response.IsValid() ? Response->GetResponseCode() : 0;
+	const bool bShouldRetry = !bWasSuccessful || ResponseCode == EHttpResponseCodes::TooManyRequests || ResponseCode >= EHttpResponseCodes::ServerError;
+
+	if (bShouldRetry && Scheduled->Attempt < Settings.MaxRetries)
+	{
+		const float Delay = GetRetryDelay(Scheduled->Attempt, Response);
+
+		// A rate limited response applies to every request to the same API, so pause the whole queue
+		if (ResponseCode == EHttpResponseCodes::TooManyRequests)
+		{
+			ResumeTime = FMath::Max(ResumeTime, FPlatformTime::Seconds() + Delay);
+		}
+
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Request to %s failed (%d), retrying in %.1fs (attempt %d of %d)."), *Request->GetURL(), ResponseCode, Delay, Scheduled->Attempt + 1, Settings.MaxRetries);
+
+		INC_DWORD_STAT(STAT_MUN_RequestRetries);
+
+		Scheduled->Attempt++;
+		Scheduled->Request = CloneRequest(Request);
+		ScheduleRetry(Scheduled, Delay);
+	}
+	else
+	{
+		if (bShouldRetry)
+		{
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Request to %s failed (%d), giving up after %d retries."), *Request->GetURL(), ResponseCode, Settings.MaxRetries);
+		}
+
+		const bool bSucceeded = bWasSuccessful && (EHttpResponseCodes::IsOk(ResponseCode) || ResponseCode == EHttpResponseCodes::NotModified);
+		// Bytes on the wire, some HTTP backends inflate gzipped bodies themselves but keep the original Content-Length
+		int64 BytesReceived = 0;
+		if (Response.IsValid())
+		{
+			const FString ContentLength = Response->GetHeader(TEXT("Content-Length"));
+			BytesReceived = ContentLength.IsNumeric() ? FMath::Max<int64>(FCString::Atoi64(*ContentLength), 0) : Response->GetContent().Num();
+		}
+
+		INC_DWORD_STAT(STAT_MUN_RequestsCompleted);
+		INC_DWORD_STAT_BY(STAT_MUN_RequestsFailed, bSucceeded ? 0 : 1);
+		INC_QWORD_STAT_BY(STAT_MUN_BytesReceived, static_cast<uint64>(BytesReceived));
+		if (Settings.bRecordReport)
+		{
+			FMUNCheckReport::Get().RecordRequest(Scheduled->Label, FPlatformTime::Seconds() - Scheduled->FirstDispatchTime, BytesReceived, Scheduled->Attempt + 1, bSucceeded);
+		}
+
+		Scheduled->OnComplete.ExecuteIfBound(Request, Response, bWasSuccessful);
+	}
+
+	PumpQueue();
+}
+
+TConstArrayView<uint8> FMUNRequestScheduler::GetContent(const FHttpResponsePtr& Response, TArray<uint8>& Storage)
+{
+	const TArray<uint8>& Content = Response->GetContent();
+
+	// Only decompress bodies that are still gzipped, the magic bytes tell us if the HTTP backend already did it
+	const bool bGzipped = Content.Num() >= 18 && Content[0] == 0x1F && Content[1] == 0x8B && Response->GetHeader(TEXT("Content-Encoding")).Contains(TEXT("gzip"));
+	if (!bGzipped)
+	{
+		return Content;
+	}
+
+	// The last four bytes of a gzip stream hold the size of the decompressed data
+	const int32 Num = Content.Num();
+	const uint32 DecompressedSize = Content[Num - 4] | Content[Num - 3] << 8 | Content[Num - 2] << 16 | static_cast<uint32>(Content[Num - 1]) << 24;
+
+	if (DecompressedSize > MaxDecompressedBytes)
+	{
+		UE_LOG(LogModUpdateNotifier, Warning, TEXT("Response from %s is too large to decompress (%u bytes)."), *Response->GetURL(), DecompressedSize);
+		return {};
+	}
+
+	Storage.SetNumUninitialized(DecompressedSize);
+	if (!FCompression::UncompressMemory(NAME_Gzip, Storage.GetData(), DecompressedSize, Content.GetData(), Num))
+	{
+		UE_LOG(LogModUpdateNotifier, Warning, TEXT("Unable to decompress response from %s"), *Response->GetURL());
+		Storage.Reset();
+		return {};
+	}
+
+	FMUNCheckReport::Get().RecordDecompression(Num, DecompressedSize);
+	return Storage;
+}
+
+void FMUNRequestScheduler::ScheduleRetry(const TSharedRef<FScheduledRequest>& Scheduled, const float Delay)
+{
+	Waiting.Add(Scheduled);
+
+	TWeakPtr<FMUNRequestScheduler> WeakThis = AsShared();
+	Scheduled->RetryHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis, Scheduled](float)
+	{
+		if (const TSharedPtr<FMUNRequestScheduler> This = WeakThis.Pin())
+		{
+			// Retries go to the front of the queue so they don't wait behind requests that haven't been tried yet
+			if (This->Waiting.Remove(Scheduled) > 0)
+			{
+				This->Queue.Insert(Scheduled, 0);
+				This->PumpQueue();
+			}
+		}
+		return false;
+	}), Delay);
+}
+
+float FMUNRequestScheduler::GetRetryDelay(const int32 Attempt, const FHttpResponsePtr& Response) const
+{
+	// Honor Retry-After (in seconds) on rate limited and unavailable responses
+	if (Response.IsValid())
+	{
+		const int32 ResponseCode = Response->GetResponseCode();
+		if (ResponseCode == EHttpResponseCodes::TooManyRequests || ResponseCode == EHttpResponseCodes::ServiceUnavail)
+		{
+			const FString RetryAfter = Response->GetHeader(TEXT("Retry-After"));
+			if (!RetryAfter.IsEmpty() && RetryAfter.IsNumeric())
+			{
+				return FMath::Min(FCString::Atof(*RetryAfter), Settings.MaxBackoffSeconds);
+			}
+		}
+	}
+
+	// Exponential backoff with jitter, so many failed requests don't all come back at the same moment
+	const float Backoff = FMath::Min(Settings.BaseBackoffSeconds * FMath::Pow(2.0f, Attempt), Settings.MaxBackoffSeconds);
+	return Backoff * FMath::FRandRange(0.5f, 1.0f);
+}
+
+FHttpRequestRef FMUNRequestScheduler::CloneRequest(const FHttpRequestPtr& Source) const
+{
+	// Completed requests can't be processed again, so every retry gets a fresh copy
+	const FHttpRequestRef Clone = FHttpModule::Get().CreateRequest();
+	Clone->SetURL(Source->GetURL());
+	Clone->SetVerb(Source->GetVerb());
+	Clone->SetTimeout(Settings.TimeoutSeconds);
+
+	for (const FString& Header : Source->GetAllHeaders())
+	{
+		FString HeaderName;
+		FString HeaderValue;
+		if (Header.Split(TEXT(": "), &HeaderName, &HeaderValue))
+		{
+			Clone->SetHeader(HeaderName, HeaderValue);
+		}
+	}
+
+	TArray<uint8> Content = Source->GetContent();
+	Clone->SetContent(MoveTemp(Content));
+
+	return Clone;
+}
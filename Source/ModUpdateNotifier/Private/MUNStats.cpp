@@ -0,0 +1,311 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNStats.h"
+
+#include "ModUpdateNotifier.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_STAT(STAT_MUN_ModScan);
+DEFINE_STAT(STAT_MUN_RequestDispatch);
+DEFINE_STAT(STAT_MUN_ParseVersions);
+DEFINE_STAT(STAT_MUN_VersionSelection);
+DEFINE_STAT(STAT_MUN_ParseChangelogs);
+DEFINE_STAT(STAT_MUN_RenderChangelogs);
+DEFINE_STAT(STAT_MUN_SnapshotLookup);
+DEFINE_STAT(STAT_MUN_PopupCreation);
+DEFINE_STAT(STAT_MUN_DecodeIcons);
+DEFINE_STAT(STAT_MUN_CreateIconTextures);
+
+DEFINE_STAT(STAT_MUN_RequestsInFlight);
+DEFINE_STAT(STAT_MUN_RequestsCompleted);
+DEFINE_STAT(STAT_MUN_RequestsFailed);
+DEFINE_STAT(STAT_MUN_RequestRetries);
+DEFINE_STAT(STAT_MUN_BytesReceived);
+DEFINE_STAT(STAT_MUN_ModsRetrieved);
+
+namespace
+{
+	// Nearest-rank percentile of an already sorted array
+	double Percentile(const TArray<double>& SortedValues, const double Fraction)
+	{
+		if (SortedValues.IsEmpty())
+		{
+			return 0.0;
+		}
+
+		const int32 Rank = FMath::CeilToInt32(Fraction * SortedValues.Num());
+		return SortedValues[FMath::Clamp(Rank - 1, 0, SortedValues.Num() - 1)];
+	}
+
+	// Nesting depth of MUN_SCOPE_GAME_THREAD, only touched on the game thread
+	int32 GameThreadWorkDepth = 0;
+
+	// Number of slowest mods listed in the summary
+	constexpr int32 SlowestModsShown = 5;
+
+	// Quotes a field that holds a separator, quote or line break, doubling the quotes in it (RFC 4180). Labels fall back to
+	// request URLs, which may contain commas.
+	FString EscapeCsvField(const FString& Field)
+	{
+		int32 Index;
+		if (!Field.FindChar(TEXT(','), Index) && !Field.FindChar(TEXT('"'), Index) && !Field.FindChar(TEXT('\n'), Index) && !Field.FindChar(TEXT('\r'), Index))
+		{
+			return Field;
+		}
+
+		return TEXT("\"") + Field.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+	}
+}
+
+FMUNCheckReport& FMUNCheckReport::Get()
+{
+	static FMUNCheckReport Report;
+	return Report;
+}
+
+void FMUNCheckReport::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	Requests.Reset();
+	Mods.Reset();
+	Phases.Reset();
+	NumDecompressed = 0;
+	CompressedBytes = 0;
+	DecompressedBytes = 0;
+	CheckStartTime = FPlatformTime::Seconds();
+	NotificationShownTime = 0.0;
+	GameThreadSeconds = 0.0;
+	GameThreadFrameSeconds = 0.0;
+	LongestGameThreadFrameSeconds = 0.0;
+	GameThreadFrame = 0;
+}
+
+void FMUNCheckReport::RecordPhase(const TCHAR* PhaseName, const double Seconds)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	FPhaseTotal& Phase = Phases.FindOrAdd(PhaseName);
+	Phase.Seconds += Seconds;
+	Phase.Count++;
+}
+
+void FMUNCheckReport::RecordRequest(const FString& Label, const double LatencySeconds, const int64 BytesReceived, const int32 Attempts, const bool bSucceeded)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	Requests.Add({Label, LatencySeconds, BytesReceived, Attempts, bSucceeded});
+}
+
+void FMUNCheckReport::RecordDecompression(const int64 InCompressedBytes, const int64 InDecompressedBytes)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	NumDecompressed++;
+	CompressedBytes += InCompressedBytes;
+	DecompressedBytes += InDecompressedBytes;
+}
+
+void FMUNCheckReport::RecordModRetrieved(const FString& ModReference, const bool bFromCache)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	Mods.Add({ModReference, FPlatformTime::Seconds() - CheckStartTime, bFromCache});
+}
+
+void FMUNCheckReport::RecordNotificationShown()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (NotificationShownTime == 0.0)
+	{
+		NotificationShownTime = FPlatformTime::Seconds();
+	}
+}
+
+void FMUNCheckReport::RecordGameThreadWork(const double Seconds)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (GameThreadFrame != GFrameCounter)
+	{
+		GameThreadFrame = GFrameCounter;
+		GameThreadFrameSeconds = 0.0;
+	}
+
+	GameThreadSeconds += Seconds;
+	GameThreadFrameSeconds += Seconds;
+	LongestGameThreadFrameSeconds = FMath::Max(LongestGameThreadFrameSeconds, GameThreadFrameSeconds);
+}
+
+void FMUNCheckReport::LogSummary() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	TArray<double> Latencies;
+	TArray<double> Sizes;
+	int64 TotalBytes = 0;
+	int32 FailedRequests = 0;
+	int32 Retries = 0;
+
+	for (const FRequestSample& Request : Requests)
+	{
+		Latencies.Add(Request.LatencySeconds);
+		Sizes.Add(static_cast<double>(Request.BytesReceived));
+		TotalBytes += Request.BytesReceived;
+		FailedRequests += Request.bSucceeded ? 0 : 1;
+		Retries += FMath::Max(0, Request.Attempts - 1);
+	}
+	Latencies.Sort();
+	Sizes.Sort();
+
+	int32 CachedMods = 0;
+	for (const FModSample& Mod : Mods)
+	{
+		CachedMods += Mod.bFromCache ? 1 : 0;
+	}
+
+	UE_LOG(LogModUpdateNotifier, Display, TEXT("Mod Update Notifier check report"));
+	UE_LOG(LogModUpdateNotifier, Display, TEXT("  Mods retrieved: %d (%d from cache)"), Mods.Num(), CachedMods);
+	UE_LOG(LogModUpdateNotifier, Display, TEXT("  Requests: %d (%d failed, %d retries), %.1f KiB received"), Requests.Num(), FailedRequests, Retries, TotalBytes / 1024.0);
+	UE_LOG(LogModUpdateNotifier, Display, TEXT("  Request latency: p50 %.0f ms, p95 %.0f ms, max %.0f ms"), Percentile(Latencies, 0.5) * 1000.0, Percentile(Latencies, 0.95) * 1000.0, Percentile(Latencies, 1.0) * 1000.0);
+	UE_LOG(LogModUpdateNotifier, Display, TEXT("  Request size: p50 %.1f KiB, p95 %.1f KiB, max %.1f KiB"), Percentile(Sizes, 0.5) / 1024.0, Percentile(Sizes, 0.95) / 1024.0, Percentile(Sizes, 1.0) / 1024.0);
+
+	if (NumDecompressed > 0)
+	{
+		UE_LOG(LogModUpdateNotifier, Display, TEXT("  Compression: %d responses, %.1f KiB received for %.1f KiB of content"), NumDecompressed, CompressedBytes / 1024.0, DecompressedBytes / 1024.0);
+	}
+
+	if (NotificationShownTime > 0.0)
+	{
+		UE_LOG(LogModUpdateNotifier, Display, TEXT("  Notification shown after %.0f ms"), (NotificationShownTime - CheckStartTime) * 1000.0);
+	}
+	else
+	{
+		UE_LOG(LogModUpdateNotifier, Display, TEXT("  Notification not shown"));
+	}
+
+	UE_LOG(LogModUpdateNotifier, Display, TEXT("  Game thread: %.2f ms, %.2f ms in the busiest frame"), GameThreadSeconds * 1000.0, LongestGameThreadFrameSeconds * 1000.0);
+
+	for (const auto& Phase : Phases)
+	{
+		UE_LOG(LogModUpdateNotifier, Display, TEXT("  %s: %.2f ms over %d calls"), *Phase.Key, Phase.Value.Seconds * 1000.0, Phase.Value.Count);
+	}
+
+	TArray<FModSample> SlowestMods = Mods;
+	SlowestMods.Sort([](const FModSample& A, const FModSample& B) { return A.SecondsSinceStart > B.SecondsSinceStart; });
+
+	for (int32 Index = 0; Index < FMath::Min(SlowestModsShown, SlowestMods.Num()); Index++)
+	{
+		UE_LOG(LogModUpdateNotifier, Display, TEXT("  Slowest mod #%d: %s after %.0f ms%s"), Index + 1, *SlowestMods[Index].ModReference, SlowestMods[Index].SecondsSinceStart * 1000.0, SlowestMods[Index].bFromCache ? TEXT(" (cached)") : TEXT(""));
+	}
+}
+
+bool FMUNCheckReport::WriteCsv(const FString& FilePath) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	// One row per sample, the kind column tells requests, mods and phases apart
+	FString Csv = TEXT("kind,name,milliseconds,count,bytes,succeeded\n");
+
+	for (const FRequestSample& Request : Requests)
+	{
+		Csv += FString::Printf(TEXT("request,%s,%.3f,%d,%lld,%d\n"), *EscapeCsvField(Request.Label), Request.LatencySeconds * 1000.0, Request.Attempts, Request.BytesReceived, Request.bSucceeded ? 1 : 0);
+	}
+
+	for (const FModSample& Mod : Mods)
+	{
+		Csv += FString::Printf(TEXT("mod,%s,%.3f,1,0,%d\n"), *EscapeCsvField(Mod.ModReference), Mod.SecondsSinceStart * 1000.0, Mod.bFromCache ? 1 : 0);
+	}
+
+	for (const auto& Phase : Phases)
+	{
+		Csv += FString::Printf(TEXT("phase,%s,%.3f,%d,0,1\n"), *EscapeCsvField(Phase.Key), Phase.Value.Seconds * 1000.0, Phase.Value.Count);
+	}
+
+	if (NumDecompressed > 0)
+	{
+		Csv += FString::Printf(TEXT("decompression,gzip,0,%d,%lld,1\n"), NumDecompressed, DecompressedBytes);
+	}
+
+	Csv += FString::Printf(TEXT("game_thread,total,%.3f,1,0,1\n"), GameThreadSeconds * 1000.0);
+	Csv += FString::Printf(TEXT("game_thread,busiest_frame,%.3f,1,0,1\n"), LongestGameThreadFrameSeconds * 1000.0);
+
+	if (NotificationShownTime > 0.0)
+	{
+		Csv += FString::Printf(TEXT("notification,shown,%.3f,1,0,1\n"), (NotificationShownTime - CheckStartTime) * 1000.0);
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+int32 FMUNCheckReport::GetNumRequests() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	return Requests.Num();
+}
+
+int64 FMUNCheckReport::GetBytesReceived() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	int64 TotalBytes = 0;
+	for (const FRequestSample& Request : Requests)
+	{
+		TotalBytes += Request.BytesReceived;
+	}
+	return TotalBytes;
+}
+
+int32 FMUNCheckReport::GetNumModsRetrieved() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	return Mods.Num();
+}
+
+double FMUNCheckReport::GetSecondsToNotification() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	return NotificationShownTime > 0.0 ? NotificationShownTime - CheckStartTime : 0.0;
+}
+
+double FMUNCheckReport::GetGameThreadSeconds() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	return GameThreadSeconds;
+}
+
+double FMUNCheckReport::GetLongestGameThreadFrameSeconds() const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	return LongestGameThreadFrameSeconds;
+}
+
+FString FMUNCheckReport::GetDefaultCsvPath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ModUpdateNotifier"), TEXT("CheckReport.csv"));
+}
+
+FMUNCheckReport::FScopedGameThreadWork::FScopedGameThreadWork()
+{
+	check(IsInGameThread());
+
+	if (GameThreadWorkDepth++ == 0)
+	{
+		StartTime = FPlatformTime::Seconds();
+	}
+}
+
+FMUNCheckReport::FScopedGameThreadWork::~FScopedGameThreadWork()
+{
+	if (--GameThreadWorkDepth == 0)
+	{
+		Get().RecordGameThreadWork(FPlatformTime::Seconds() - StartTime);
+	}
+}
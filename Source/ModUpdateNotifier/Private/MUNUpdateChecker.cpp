@@ -0,0 +1,1376 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNUpdateChecker.h"
+
+#include "ModUpdateNotifier.h"
+#include "MUNStats.h"
+#include "Http.h"
+#include "Async/Async.h"
+#include "Tasks/Task.h"
+#include "Hash/xxhash.h"
+#include "JsonObjectConverter.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "ModLoading/ModLoadingLibrary.h"
+#include "Module/WorldModuleManager.h"
+
+FMUNCheckSettings FMUNCheckSettings::FromConfig(const FModUpdateNotifier_ConfigStruct& Config)
+{
+	FMUNCheckSettings Settings;
+	Settings.bIncludePreReleases = Config.bIncludePreReleases;
+	Settings.bDebugLogging = Config.bDebugLogging;
+
+	// The API can be pointed at a mirror or a local stand-in server, the command line takes precedence over the config
+	if (!FParse::Value(FCommandLine::Get(), TEXT("MUNApiBaseURL="), Settings.APIBaseURL))
+	{
+		Settings.APIBaseURL = Config.APIBaseURL.IsEmpty() ? DefaultAPIBaseURL : Config.APIBaseURL;
+	}
+	Settings.APIBaseURL.RemoveFromEnd(TEXT("/"));
+
+	if (!FParse::Value(FCommandLine::Get(), TEXT("MUNVersionSnapshot="), Settings.VersionSnapshot))
+	{
+		Settings.VersionSnapshot = Config.VersionSnapshot;
+	}
+	Settings.VersionCacheTTL = FTimespan::FromMinutes(Config.VersionCacheTTLMinutes > 0 ? Config.VersionCacheTTLMinutes : DefaultVersionCacheTTLMinutes);
+
+	if (Config.bPeriodicRecheck)
+	{
+		Settings.RecheckIntervalSeconds = 60.0f * (Config.RecheckIntervalMinutes > 0 ? Config.RecheckIntervalMinutes : DefaultRecheckIntervalMinutes);
+	}
+
+	if (Config.MaxConcurrentRequests > 0)
+	{
+		Settings.RequestSettings.MaxConcurrentRequests = Config.MaxConcurrentRequests;
+	}
+	if (Config.RequestTimeoutSeconds > 0.0f)
+	{
+		Settings.RequestSettings.TimeoutSeconds = Config.RequestTimeoutSeconds;
+	}
+
+	return Settings;
+}
+
+FModUpdateNotifier_ConfigStruct FMUNCheckSettings::LoadConfigFile()
+{
+	FModUpdateNotifier_ConfigStruct Config;
+
+	// Where the config manager keeps the config of a mod: a JSON object with one field per option, named like the struct's members
+	const FString ConfigPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SaveGames"), TEXT("Configs"), TEXT("ModUpdateNotifier.cfg"));
+
+	FString ConfigContents;
+	TSharedPtr<FJsonObject> ConfigObj;
+	if (!FFileHelper::LoadFileToString(ConfigContents, *ConfigPath))
+	{
+		UE_LOG(LogModUpdateNotifier, Display, TEXT("No mod config found at %s, using the defaults."), *ConfigPath);
+	}
+	else if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(ConfigContents), ConfigObj) || !ConfigObj.IsValid() || !FJsonObjectConverter::JsonObjectToUStruct(ConfigObj.ToSharedRef(), &Config))
+	{
+		UE_LOG(LogModUpdateNotifier, Warning, TEXT("Mod config is not valid, using the defaults: %s"), *ConfigPath);
+		Config = FModUpdateNotifier_ConfigStruct();
+	}
+
+	ReadIniOptions(Config);
+	return Config;
+}
+
+void FMUNCheckSettings::ReadIniOptions(FModUpdateNotifier_ConfigStruct& Config)
+{
+	if (!GConfig)
+	{
+		return;
+	}
+
+	GConfig->GetBool(IniSection, TEXT("bPeriodicRecheck"), Config.bPeriodicRecheck, GGameIni);
+	GConfig->GetInt(IniSection, TEXT("RecheckIntervalMinutes"), Config.RecheckIntervalMinutes, GGameIni);
+	GConfig->GetInt(IniSection, TEXT("VersionCacheTTLMinutes"), Config.VersionCacheTTLMinutes, GGameIni);
+	GConfig->GetInt(IniSection, TEXT("MaxConcurrentRequests"), Config.MaxConcurrentRequests, GGameIni);
+	GConfig->GetFloat(IniSection, TEXT("RequestTimeoutSeconds"), Config.RequestTimeoutSeconds, GGameIni);
+	GConfig->GetFloat(IniSection, TEXT("NotificationDeadlineSeconds"), Config.NotificationDeadlineSeconds, GGameIni);
+	GConfig->GetBool(IniSection, TEXT("bIncludePreReleases"), Config.bIncludePreReleases, GGameIni);
+	GConfig->GetString(IniSection, TEXT("APIBaseURL"), Config.APIBaseURL, GGameIni);
+	GConfig->GetString(IniSection, TEXT("VersionSnapshot"), Config.VersionSnapshot, GGameIni);
+	GConfig->GetInt(IniSection, TEXT("ChangelogCacheBudgetKB"), Config.ChangelogCacheBudgetKB, GGameIni);
+	GConfig->GetInt(IniSection, TEXT("IconCacheBudgetMB"), Config.IconCacheBudgetMB, GGameIni);
+}
+
+void UMUNUpdateChecker::Initialize(const FMUNCheckSettings& InSettings, const TSharedRef<FMUNVersionCache>& InVersionCache)
+{
+	Settings = InSettings;
+	Settings.RequestSettings.bRecordReport = Settings.bRecordReport;
+	VersionCache = InVersionCache;
+	PendingRequests = MakeShared<FMUNRequestScheduler>(Settings.RequestSettings);
+}
+
+void UMUNUpdateChecker::StartCheck(UModLoadingLibrary* ModLoadingLibrary, UWorldModuleManager* WorldModuleManager)
+{
+	MUN_SCOPE_GAME_THREAD();
+
+	check(PendingRequests.IsValid() && VersionCache.IsValid());
+
+	if (Settings.bRecordReport)
+	{
+		FMUNCheckReport::Get().Reset();
+	}
+	bStarted = true;
+	bCompleteBroadcast = false;
+	CheckedMods.Reset();
+
+	TArray<FModInfo> LoadedMods = ModLoadingLibrary->GetLoadedMods();
+	InstalledFingerprint = ComputeInstalledFingerprint(ModLoadingLibrary, LoadedMods);
+
+	// Every dependent is known up front, so mods can be resolved as soon as their versions arrive even while the scan runs
+	{
+		const double BuildStartTime = FPlatformTime::Seconds();
+		DependencyGraph.Build(*ModLoadingLibrary, LoadedMods);
+
+		if (Settings.bDebugLogging)
+		{
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Built the dependency graph of %d mods with %d dependency ranges in %.2f ms."), LoadedMods.Num(), DependencyGraph.NumEdges(), (FPlatformTime::Seconds() - BuildStartTime) * 1000.0);
+		}
+	}
+
+	// The scan itself runs over several frames once the check has begun
+	ModTable.Reset();
+	PendingScanMods = MoveTemp(LoadedMods);
+	ScanIndex = 0;
+	PendingUncachedMods.Reset();
+	PendingStaleMods.Reset();
+	ScanModLoadingLibrary = ModLoadingLibrary;
+	ScanWorldModuleManager = WorldModuleManager;
+	bScanComplete = false;
+
+	// The cache file is read on a worker. If nothing installed has changed since the last check and its results are recent,
+	// neither scan nor ask again.
+	TWeakObjectPtr<UMUNUpdateChecker> WeakThis = this;
+	VersionCache->LoadAsync([WeakThis]()
+	{
+		UMUNUpdateChecker* This = WeakThis.Get();
+		if (This && !This->bCancelled && !This->RestoreCheckResults())
+		{
+			This->BeginCheck();
+		}
+	});
+}
+
+void UMUNUpdateChecker::StartCheck(FMUNModTable KnownMods, const FString& KnownFingerprint, const FMUNDependencyGraph& KnownDependencies)
+{
+	MUN_SCOPE_GAME_THREAD();
+
+	check(PendingRequests.IsValid() && VersionCache.IsValid());
+
+	if (Settings.bRecordReport)
+	{
+		FMUNCheckReport::Get().Reset();
+	}
+	bStarted = true;
+	bCompleteBroadcast = false;
+	CheckedMods.Reset();
+
+	InstalledFingerprint = KnownFingerprint;
+	DependencyGraph = KnownDependencies;
+
+	ModTable = MoveTemp(KnownMods);
+	for (FMUNModRecord& ModRecord : ModTable.Records)
+	{
+		ModRecord.APIVersion = {0,0,0};
+		ModRecord.CompatibleVersion = {0,0,0};
+		ModRecord.Changelog.Empty();
+		ModRecord.ChangelogState = EMUNChangelogState::NotFetched;
+	}
+	NumRequested = ModTable.Num();
+
+	TWeakObjectPtr<UMUNUpdateChecker> WeakThis = this;
+	VersionCache->LoadAsync([WeakThis]()
+	{
+		UMUNUpdateChecker* This = WeakThis.Get();
+		if (This && !This->bCancelled)
+		{
+			This->BeginCheck();
+		}
+	});
+}
+
+void UMUNUpdateChecker::BeginCheck()
+{
+	MUN_SCOPE_GAME_THREAD();
+
+	OldestConfirmation = FDateTime::UtcNow();
+	bHadFailures = false;
+	DeltaChangedMods.Reset();
+	WidenedMods.Reset();
+
+	// A snapshot on a mirror has to be downloaded first, a local one is mapped right away
+	if (Settings.VersionSnapshot.StartsWith(TEXT("http://")) || Settings.VersionSnapshot.StartsWith(TEXT("https://")))
+	{
+		RequestVersionSnapshot();
+		return;
+	}
+
+	if (!Settings.VersionSnapshot.IsEmpty())
+	{
+		VersionSnapshot = FMUNVersionSnapshot::LoadFromFile(Settings.VersionSnapshot);
+	}
+
+	BeginDispatch();
+}
+
+void UMUNUpdateChecker::BeginDispatch()
+{
+	if (!bScanComplete)
+	{
+		// The first slice runs right away, the rest on the following frames
+		if (ScanNextMods(0.0f))
+		{
+			ScanTickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMUNUpdateChecker::ScanNextMods));
+		}
+		return;
+	}
+
+	TArray<FString> ModReferences;
+	for (const FMUNModRecord& ModRecord : ModTable.Records)
+	{
+		ModReferences.Add(ModRecord.ModReference);
+	}
+
+	// Mods resolved right away from the snapshot or the cache complete the check through OnModVersionRetrieved
+	if (!ModReferences.IsEmpty())
+	{
+		DispatchVersionRequests(ModReferences);
+		return;
+	}
+
+	// Nothing takes part in update checking, so there is nothing to wait for
+	BroadcastIfComplete();
+}
+
+void UMUNUpdateChecker::RequestVersionSnapshot()
+{
+	const FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
+	Request->SetURL(Settings.VersionSnapshot);
+	Request->SetVerb("GET");
+	Request->SetHeader(TEXT("User-Agent"), "X-UE5-ModUpdateNotifier-Agent");
+
+	PendingRequests->Enqueue(Request, FHttpRequestCompleteDelegate::CreateUObject(this, &UMUNUpdateChecker::OnVersionSnapshotReceived), TEXT("version snapshot"));
+}
+
+void UMUNUpdateChecker::OnVersionSnapshotReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful)
+{
+	if (bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		TArray<uint8> Decompressed;
+		VersionSnapshot = FMUNVersionSnapshot::LoadFromMemory(TArray<uint8>(FMUNRequestScheduler::GetContent(Response, Decompressed)));
+	}
+	else
+	{
+		// Carry on without it, every mod is asked for from the API instead
+		UE_LOG(LogModUpdateNotifier, Warning, TEXT("Unable to download version snapshot from %s"), *Settings.VersionSnapshot);
+	}
+
+	BeginDispatch();
+}
+
+FString UMUNUpdateChecker::ComputeInstalledFingerprint(UModLoadingLibrary* ModLoadingLibrary, const TArray<FModInfo>& LoadedMods) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(MUN_InstalledFingerprint);
+
+	FXxHash64Builder Hasher;
+	const auto HashString = [&Hasher](const FString& String)
+	{
+		// Hash the length too, so "ab" + "c" and "a" + "bc" don't collide
+		const int32 Length = String.Len();
+		Hasher.Update(&Length, sizeof(Length));
+		Hasher.Update(*String, Length * sizeof(TCHAR));
+	};
+
+	// Anything that changes the results of a check is part of the fingerprint, not just the mods
+	const uint32 GameVersion = FEngineVersion::Current().GetChangelist();
+	Hasher.Update(&GameVersion, sizeof(GameVersion));
+	Hasher.Update(&Settings.bIncludePreReleases, sizeof(Settings.bIncludePreReleases));
+	HashString(Settings.APIBaseURL);
+	HashString(Settings.VersionSnapshot);
+
+	// Only name, version and dependency ranges are read, the world module reflection done by the scan is skipped
+	TArray<const FModInfo*> SortedMods;
+	for (const FModInfo& ModInfo : LoadedMods)
+	{
+		SortedMods.Add(&ModInfo);
+	}
+	SortedMods.Sort([](const FModInfo& A, const FModInfo& B) { return A.Name < B.Name; });
+
+	for (const FModInfo* ModInfo : SortedMods)
+	{
+		HashString(ModInfo->Name);
+		HashString(ModInfo->Version.ToString());
+
+		if (const auto* Metadata = ModLoadingLibrary->PluginMetadata.Find(ModInfo->Name))
+		{
+			TArray<FString> Dependencies;
+			for (const auto& ModDependencyVersion : Metadata->DependenciesVersions)
+			{
+				Dependencies.Add(ModDependencyVersion.Key + TEXT("@") + ModDependencyVersion.Value.ToString());
+			}
+			Dependencies.Sort();
+
+			for (const FString& Dependency : Dependencies)
+			{
+				HashString(Dependency);
+			}
+		}
+	}
+
+	return FString::Printf(TEXT("%016llx"), Hasher.Finalize().Hash);
+}
+
+bool UMUNUpdateChecker::RestoreCheckResults()
+{
+	const FMUNModTable* CheckResults = VersionCache->FindCheckResults(InstalledFingerprint, Settings.VersionCacheTTL);
+	if (!CheckResults)
+	{
+		return false;
+	}
+
+	if (Settings.bDebugLogging)
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Installed mods are unchanged since the last check, using its results for %d mods."), CheckResults->Num());
+	}
+
+	ModTable = *CheckResults;
+	NumRequested = ModTable.Num();
+	PendingScanMods.Empty();
+	bScanComplete = true;
+
+	// Changelogs live with the version entries, only take them if they still belong to the remote version
+	for (FMUNModRecord& ModRecord : ModTable.Records)
+	{
+		const FMUNCachedModVersion* CachedVersion = VersionCache->Find(ModRecord.ModReference);
+		if (CachedVersion && !CachedVersion->Changelog.IsEmpty() && CachedVersion->HighestVersion.Compare(ModRecord.CompatibleVersion) == 0)
+		{
+			ModRecord.Changelog = CachedVersion->Changelog;
+			ModRecord.ChangelogState = EMUNChangelogState::Fetched;
+		}
+	}
+
+	for (int32 RecordIndex = 0; RecordIndex < ModTable.Num(); RecordIndex++)
+	{
+		INC_DWORD_STAT(STAT_MUN_ModsRetrieved);
+		if (Settings.bRecordReport)
+		{
+			FMUNCheckReport::Get().RecordModRetrieved(ModTable.Records[RecordIndex].ModReference, true);
+		}
+
+		NumRetrieved++;
+		BroadcastModChecked(RecordIndex);
+	}
+
+	bCompleteBroadcast = true;
+	OnCheckComplete.Broadcast();
+	return true;
+}
+
+bool UMUNUpdateChecker::IsUpdateAvailable(const int32 RecordIndex) const
+{
+	const FMUNModRecord& ModRecord = ModTable.Records[RecordIndex];
+	return IsUpdateAvailable(ModRecord, ModRecord.InstalledVersion);
+}
+
+bool UMUNUpdateChecker::IsUpdateAvailable(const FMUNModRecord& ModRecord, const FVersion& InstalledVersion)
+{
+	// Releases outside a dependent's range don't count, only the newest version every dependent allows is offered
+	return ModRecord.CompatibleVersion.Compare(InstalledVersion) == 1;
+}
+
+namespace
+{
+	struct FModuleProperties
+	{
+		FBoolProperty* OptOut = nullptr; // ModUpdateNotifier_OptOut, null if the module doesn't declare it
+		FStrProperty* SupportURL = nullptr; // ModUpdateNotifier_Support_URL
+	};
+
+	// World module classes don't change while the game runs, so their properties are looked up once per class
+	TMap<TWeakObjectPtr<UClass>, FModuleProperties> ModulePropertyCache;
+
+	const FModuleProperties& FindModuleProperties(UClass* ModuleClass)
+	{
+		if (const FModuleProperties* CachedProperties = ModulePropertyCache.Find(ModuleClass))
+		{
+			return *CachedProperties;
+		}
+
+		// Based on this post: https://forums.unrealengine.com/t/how-to-get-a-string-property-by-name/266008
+		FModuleProperties Properties;
+		Properties.OptOut = CastField<FBoolProperty>(ModuleClass->FindPropertyByName("ModUpdateNotifier_OptOut"));
+		Properties.SupportURL = CastField<FStrProperty>(ModuleClass->FindPropertyByName("ModUpdateNotifier_Support_URL"));
+		return ModulePropertyCache.Add(ModuleClass, Properties);
+	}
+}
+
+bool UMUNUpdateChecker::ScanNextMods(float DeltaTime)
+{
+	MUN_SCOPE_GAME_THREAD();
+	MUN_SCOPE_PHASE(ModScan, TEXT("Mod scan"));
+
+	UModLoadingLibrary* ModLoadingLibrary = ScanModLoadingLibrary.Get();
+	UWorldModuleManager* WorldModuleManager = ScanWorldModuleManager.Get();
+
+	// Scan until the frame's budget is used up and pick up where we left off next frame
+	const double SliceEndTime = FPlatformTime::Seconds() + ScanBudgetSeconds;
+	TArray<FString> DiscoveredMods;
+
+	while (ModLoadingLibrary && ScanIndex < PendingScanMods.Num())
+	{
+		if (ScanMod(PendingScanMods[ScanIndex++], ModLoadingLibrary, WorldModuleManager))
+		{
+			DiscoveredMods.Add(ModTable.Records.Last().ModReference);
+		}
+
+		if (FPlatformTime::Seconds() >= SliceEndTime)
+		{
+			break;
+		}
+	}
+
+	// Mods found so far are resolved from the snapshot or the cache right away, requests go out once a batch is full
+	if (!DiscoveredMods.IsEmpty())
+	{
+		DispatchVersionRequests(DiscoveredMods);
+	}
+
+	if (ModLoadingLibrary && ScanIndex < PendingScanMods.Num())
+	{
+		return true;
+	}
+
+	ScanTickHandle.Reset();
+	FinishScan();
+	return false;
+}
+
+bool UMUNUpdateChecker::ScanMod(const FModInfo& ModInfo, UModLoadingLibrary* ModLoadingLibrary, UWorldModuleManager* WorldModuleManager)
+{
+	FMUNModRecord ModRecord;
+
+	if (Settings.bDebugLogging)
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Detected mod: %s."), *ModInfo.FriendlyName);
+	}
+
+	// Mods can opt out of update checking and supply a support URL through properties on their world module
+	if (UWorldModule* Mod = WorldModuleManager ? WorldModuleManager->FindModule(FName(*ModInfo.Name)) : nullptr)
+	{
+		const FModuleProperties& Properties = FindModuleProperties(Mod->GetClass());
+
+		if (Properties.OptOut && Properties.OptOut->GetPropertyValue_InContainer(Mod))
+		{
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Mod opted-out of update checking: %s"), *ModInfo.FriendlyName);
+			return false;
+		}
+
+		if (Properties.SupportURL)
+		{
+			ModRecord.SupportURL = Properties.SupportURL->GetPropertyValue_InContainer(Mod);
+			ModRecord.bHasSupportURL = true;
+
+			if (Settings.bDebugLogging)
+			{
+				UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Successfully loaded Support URL for mod: %s"), *ModInfo.FriendlyName);
+			}
+		}
+		else if (Settings.bDebugLogging)
+		{
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Could not find Support_URL field for mod: %s"), *ModInfo.FriendlyName);
+		}
+	}
+
+	NumRequested++;
+	ModRecord.ModReference = ModInfo.Name;
+	ModRecord.InstalledVersion = ModInfo.Version;
+	ModRecord.FriendlyName = ModInfo.FriendlyName;
+	ModRecord.Author = ModInfo.CreatedBy;
+	ModTable.Add(MoveTemp(ModRecord));
+	return true;
+}
+
+void UMUNUpdateChecker::FinishScan()
+{
+	bScanComplete = true;
+	PendingScanMods.Empty();
+
+	if (Settings.bDebugLogging)
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Scan complete, %d mods take part in update checking."), NumRequested);
+	}
+
+	FlushVersionRequests();
+	BroadcastIfComplete();
+}
+
+void UMUNUpdateChecker::DispatchVersionRequests(const TArray<FString>& ModReferences)
+{
+	MUN_SCOPE_PHASE(RequestDispatch, TEXT("Request dispatch"));
+
+	// If the last check got through without network errors, stale mods only need their versions fetched if one was released since
+	const FDateTime LastSuccessfulCheck = VersionCache->GetLastSuccessfulCheck(FEngineVersion::Current().GetChangelist());
+
+	// Mods in the snapshot are resolved without the network, the API is only asked for the rest
+	TMap<FString, TArray<FVersion>> SnapshotVersions;
+	if (VersionSnapshot.IsValid())
+	{
+		MUN_SCOPE_PHASE(SnapshotLookup, TEXT("Snapshot lookup"));
+
+		TArray<FMUNVersionEntry> Versions;
+		for (const FString& CurrentModReference : ModReferences)
+		{
+			const FTCHARToUTF8 ModReference(*CurrentModReference);
+			if (VersionSnapshot->Find(FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(ModReference.Get()), ModReference.Length()), Versions))
+			{
+				SnapshotVersions.Add(CurrentModReference, SelectRecentVersions(Versions, Settings.bIncludePreReleases, Settings.bDebugLogging));
+			}
+		}
+
+		if (!SnapshotVersions.IsEmpty())
+		{
+			OldestConfirmation = FMath::Min(OldestConfirmation, VersionSnapshot->GetGeneratedAt());
+		}
+	}
+
+	TArray<FString> UncachedMods;
+	TArray<FString> FreshMods;
+	TArray<FString> StaleMods;
+
+	for (const FString& CurrentModReference : ModReferences)
+	{
+		if (SnapshotVersions.Contains(CurrentModReference))
+		{
+			continue;
+		}
+
+		if (const FMUNCachedModVersion* CachedVersion = VersionCache->Find(CurrentModReference))
+		{
+			// Fresh entries don't need the network at all
+			if (CachedVersion->IsFresh(Settings.VersionCacheTTL))
+			{
+				FreshMods.Add(CurrentModReference);
+				OldestConfirmation = FMath::Min(OldestConfirmation, CachedVersion->FetchedAt);
+				continue;
+			}
+
+			// Without a baseline to ask what changed since, stale entries are fetched again with the uncached ones
+			if (LastSuccessfulCheck > FDateTime::MinValue())
+			{
+				StaleMods.Add(CurrentModReference);
+				continue;
+			}
+		}
+
+		UncachedMods.Add(CurrentModReference);
+	}
+
+	if (Settings.bDebugLogging)
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Version cache: %d from snapshot, %d fresh, %d uncached, %d stale."), SnapshotVersions.Num(), FreshMods.Num(), UncachedMods.Num(), StaleMods.Num());
+	}
+
+	// Requests are collected over the slices of the scan, so they go out in as few queries as without it
+	PendingStaleMods.Append(MoveTemp(StaleMods));
+	PendingUncachedMods.Append(MoveTemp(UncachedMods));
+
+	if (bScanComplete)
+	{
+		FlushVersionRequests();
+	}
+	else if (PendingUncachedMods.Num() >= VersionQueryBatchSize)
+	{
+		// Full batches don't get any cheaper by waiting for the rest of the scan
+		const int32 NumBatched = PendingUncachedMods.Num() - PendingUncachedMods.Num() % VersionQueryBatchSize;
+		RequestModVersionsBatched(TArray<FString>(PendingUncachedMods.GetData(), NumBatched));
+		PendingUncachedMods.RemoveAt(0, NumBatched);
+	}
+
+	for (const FString& CurrentModReference : FreshMods)
+	{
+		RetrieveFromCache(CurrentModReference);
+	}
+
+	for (const auto& SnapshotVersion : SnapshotVersions)
+	{
+		OnModVersionRetrieved(SnapshotVersion.Key, SnapshotVersion.Value, true);
+	}
+}
+
+void UMUNUpdateChecker::FlushVersionRequests()
+{
+	// One small query tells us which stale mods have had a release since the last check, the rest are still current
+	if (!PendingStaleMods.IsEmpty())
+	{
+		RequestUpdatedMods(PendingStaleMods, VersionCache->GetLastSuccessfulCheck(FEngineVersion::Current().GetChangelist()), 0);
+		PendingStaleMods.Reset();
+	}
+
+	// Ask the ficsit.app GraphQL API for the latest versions of all uncached mods at once, falling back to the REST API per mod if that fails
+	if (!PendingUncachedMods.IsEmpty())
+	{
+		RequestModVersionsBatched(PendingUncachedMods);
+		PendingUncachedMods.Reset();
+	}
+}
+
+void UMUNUpdateChecker::RetrieveFromCache(const FString& ModReference)
+{
+	OnModVersionRetrieved(ModReference, VersionCache->Find(ModReference)->RecentVersions, true);
+}
+
+void UMUNUpdateChecker::RequestUpdatedMods(const TArray<FString>& ModReferences, const FDateTime& Since, const int32 Offset)
+{
+	TArray<TSharedPtr<FJsonValue>> ReferenceValues;
+	for (const FString& ModReference : ModReferences)
+	{
+		ReferenceValues.Add(MakeShared<FJsonValueString>(ModReference));
+	}
+
+	const TSharedRef<FJsonObject> VariablesObj = MakeShared<FJsonObject>();
+	VariablesObj->SetArrayField(TEXT("references"), ReferenceValues);
+
+	// Newest releases first, so a single page covers every mod released since the last check on all but the busiest days
+	const TSharedRef<FJsonObject> RequestObj = MakeShared<FJsonObject>();
+	RequestObj->SetStringField(TEXT("query"), FString::Printf(TEXT("query UpdatedMods($references: [String!]) { getMods(filter: { references: $references, limit: %d, offset: %d, order_by: last_version_date, order: desc }) { mods { mod_reference last_version_date } } }"), DeltaQueryPageSize, Offset));
+	RequestObj->SetObjectField(TEXT("variables"), VariablesObj);
+
+	FString RequestBody;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBody);
+	FJsonSerializer::Serialize(RequestObj, Writer);
+
+	const FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
+	Request->SetURL(Settings.APIBaseURL + "/v2/query");
+	Request->SetContentAsString(RequestBody);
+	Request->SetVerb("POST");
+	Request->SetHeader(TEXT("User-Agent"), "X-UE5-ModUpdateNotifier-Agent");
+	Request->SetHeader("Content-Type", TEXT("application/json"));
+
+	if (Settings.bDebugLogging)
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Asking which of %d mods have been updated since %s."), ModReferences.Num(), *Since.ToIso8601());
+	}
+
+	PendingRequests->Enqueue(Request, FHttpRequestCompleteDelegate::CreateUObject(this, &UMUNUpdateChecker::OnUpdatedModsReceived, ModReferences, Since, Offset), FString::Printf(TEXT("updated mods of %d"), ModReferences.Num()));
+}
+
+void UMUNUpdateChecker::OnUpdatedModsReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful, TArray<FString> ModReferences, FDateTime Since, int32 Offset)
+{
+	if (!bWasSuccessful || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		OnUpdatedModsParsed(false, MoveTemp(ModReferences), Since, Offset, {}, false);
+		return;
+	}
+
+	TWeakObjectPtr<UMUNUpdateChecker> WeakThis = this;
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Response, ModReferences = MoveTemp(ModReferences), Since, Offset]() mutable
+	{
+		TArray<FString> ChangedMods;
+		bool bReachedOlderMods = false;
+		TArray<uint8> Decompressed;
+		const bool bValid = ParseUpdatedMods(FMUNRequestScheduler::GetContent(Response, Decompressed), Since, ChangedMods, bReachedOlderMods);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bValid, ModReferences = MoveTemp(ModReferences), Since, Offset, ChangedMods = MoveTemp(ChangedMods), bReachedOlderMods]() mutable
+		{
+			if (UMUNUpdateChecker* This = WeakThis.Get())
+			{
+				This->OnUpdatedModsParsed(bValid, MoveTemp(ModReferences), Since, Offset, MoveTemp(ChangedMods), bReachedOlderMods);
+			}
+		});
+	}, UE::Tasks::ETaskPriority::BackgroundLow);
+}
+
+bool UMUNUpdateChecker::ParseUpdatedMods(const TConstArrayView<uint8> Content, const FDateTime& Since, TArray<FString>& OutChangedMods, bool& bOutReachedOlderMods)
+{
+	MUN_SCOPE_PHASE(ParseVersions, TEXT("Parse versions"));
+
+	int32 NumMods = 0;
+	const bool bValid = FMUNVersionsReader::ReadLastVersionDates(Content, [&](const FUtf8StringView ModReference, const FUtf8StringView LastVersionDate)
+	{
+		NumMods++;
+
+		// Mods without any release have nothing to update to
+		FDateTime ReleaseTime;
+		if (LastVersionDate.IsEmpty() || !FDateTime::ParseIso8601(*FMUNVersionsReader::ToString(LastVersionDate), ReleaseTime))
+		{
+			bOutReachedOlderMods = true;
+			return;
+		}
+
+		if (ReleaseTime > Since)
+		{
+			OutChangedMods.Add(FMUNVersionsReader::ToString(ModReference));
+		}
+		else
+		{
+			bOutReachedOlderMods = true;
+		}
+	});
+
+	// A short page is the last one
+	bOutReachedOlderMods |= NumMods < DeltaQueryPageSize;
+	return bValid;
+}
+
+void UMUNUpdateChecker::OnUpdatedModsParsed(const bool bValid, TArray<FString> ModReferences, const FDateTime& Since, const int32 Offset, TArray<FString> ChangedMods, const bool bReachedOlderMods)
+{
+	MUN_SCOPE_GAME_THREAD();
+
+	if (!bValid)
+	{
+		// Fall back to fetching every mod that hasn't been asked for yet
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Updated mods query failed, fetching the versions of all stale mods."));
+
+		TArray<FString> RemainingMods;
+		for (const FString& ModReference : ModReferences)
+		{
+			if (!DeltaChangedMods.Contains(ModReference))
+			{
+				RemainingMods.Add(ModReference);
+			}
+		}
+
+		if (!RemainingMods.IsEmpty())
+		{
+			RequestModVersionsBatched(RemainingMods);
+		}
+		return;
+	}
+
+	// Fetch the versions of changed mods right away instead of waiting for the last page
+	DeltaChangedMods.Append(ChangedMods);
+	if (!ChangedMods.IsEmpty())
+	{
+		RequestModVersionsBatched(ChangedMods);
+	}
+
+	if (!bReachedOlderMods)
+	{
+		RequestUpdatedMods(ModReferences, Since, Offset + DeltaQueryPageSize);
+		return;
+	}
+
+	// Everything else hasn't had a release since the last check, so the cached version is still current
+	for (const FString& ModReference : ModReferences)
+	{
+		if (!DeltaChangedMods.Contains(ModReference))
+		{
+			VersionCache->Touch(ModReference);
+			RetrieveFromCache(ModReference);
+		}
+	}
+
+	if (Settings.bDebugLogging)
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("%d of %d stale mods have been updated since the last check."), DeltaChangedMods.Num(), ModReferences.Num());
+	}
+}
+
+void UMUNUpdateChecker::RequestModVersionsBatched(const TArray<FString>& ModReferences, const int32 VersionWindow)
+{
+	// Split the mod list into chunks, the API limits how many mods a single query may return
+	for (int32 ChunkStart = 0; ChunkStart < ModReferences.Num(); ChunkStart += VersionQueryBatchSize)
+	{
+		const int32 ChunkSize = FMath::Min(VersionQueryBatchSize, ModReferences.Num() - ChunkStart);
+		TArray<FString> ChunkReferences(ModReferences.GetData() + ChunkStart, ChunkSize);
+
+		// Pass the mod references as a GraphQL variable so they are escaped properly
+		TArray<TSharedPtr<FJsonValue>> ReferenceValues;
+		for (const FString& ModReference : ChunkReferences)
+		{
+			ReferenceValues.Add(MakeShared<FJsonValueString>(ModReference));
+		}
+
+		const TSharedRef<FJsonObject> VariablesObj = MakeShared<FJsonObject>();
+		VariablesObj->SetArrayField(TEXT("references"), ReferenceValues);
+
+		const TSharedRef<FJsonObject> RequestObj = MakeShared<FJsonObject>();
+		// Only the fields version selection reads and the logo for the notification, newest first so a small window holds the versions that matter
+		RequestObj->SetStringField(TEXT("query"), FString::Printf(TEXT("query ModVersions($references: [String!]) { getMods(filter: { references: $references, limit: %d }) { mods { mod_reference logo versions(filter: { limit: %d, order_by: created_at, order: desc }) { version game_version } } } }"), VersionQueryBatchSize, VersionWindow));
+		RequestObj->SetObjectField(TEXT("variables"), VariablesObj);
+
+		FString RequestBody;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBody);
+		FJsonSerializer::Serialize(RequestObj, Writer);
+
+		// Create an HTTP POST request
+		const FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
+		Request->SetURL(Settings.APIBaseURL + "/v2/query");
+		Request->SetContentAsString(RequestBody);
+		Request->SetVerb("POST");
+		Request->SetHeader(TEXT("User-Agent"), "X-UE5-ModUpdateNotifier-Agent");
+		Request->SetHeader("Content-Type", TEXT("application/json"));
+
+		if (Settings.bDebugLogging)
+		{
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Requesting the newest %d versions for %d mods in a single query."), VersionWindow, ChunkReferences.Num());
+		}
+
+		PendingRequests->Enqueue(Request, FHttpRequestCompleteDelegate::CreateUObject(this, &UMUNUpdateChecker::OnBatchedVersionsReceived, ChunkReferences, VersionWindow), FString::Printf(TEXT("versions of %d mods"), ChunkReferences.Num()));
+	}
+}
+
+void UMUNUpdateChecker::RequestModVersions(const FString& ModReference, const bool bFullHistory)
+{
+	// Create an HTTP GET request to the ficsit.app REST API to get the newest versions of a single mod, or all of them if those weren't enough
+	const FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
+	if (bFullHistory)
+	{
+		Request->SetURL(Settings.APIBaseURL + "/v1/mod/" + ModReference + "/versions/all");
+	}
+	else
+	{
+		Request->SetURL(FString::Printf(TEXT("%s/v1/mod/%s/versions?limit=%d&order_by=created_at&order=desc"), *Settings.APIBaseURL, *ModReference, VersionWindowSize));
+	}
+	Request->SetVerb("GET");
+	Request->SetHeader(TEXT("User-Agent"), "X-UE5-ModUpdateNotifier-Agent");
+
+	PendingRequests->Enqueue(Request, FHttpRequestCompleteDelegate::CreateUObject(this, &UMUNUpdateChecker::OnResponseReceived, ModReference, bFullHistory), ModReference);
+}
+
+// Parse the GraphQL response containing the versions of a whole chunk of mods
+void UMUNUpdateChecker::OnBatchedVersionsReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful, TArray<FString> ModReferences, int32 VersionWindow)
+{
+	if (!bWasSuccessful || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		OnBatchedVersionsParsed(false, MoveTemp(ModReferences), {}, {}, {});
+		return;
+	}
+
+	// Deserializing and walking every version is expensive for large responses, so do it on a worker thread and only send the results back
+	TWeakObjectPtr<UMUNUpdateChecker> WeakThis = this;
+	const bool bAllowPreReleases = Settings.bIncludePreReleases;
+	const bool bLogVerbose = Settings.bDebugLogging;
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Response, ModReferences = MoveTemp(ModReferences), VersionWindow, bAllowPreReleases, bLogVerbose]() mutable
+	{
+		TArray<uint8> Decompressed;
+		TMap<FString, TArray<FVersion>> RecentVersions;
+		TMap<FString, FString> Logos;
+		TArray<FString> NeedWiderWindow;
+		const bool bValid = ParseBatchedVersions(FMUNRequestScheduler::GetContent(Response, Decompressed), VersionWindow, RecentVersions, Logos, NeedWiderWindow, bAllowPreReleases, bLogVerbose);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bValid, ModReferences = MoveTemp(ModReferences), RecentVersions = MoveTemp(RecentVersions), Logos = MoveTemp(Logos), NeedWiderWindow = MoveTemp(NeedWiderWindow)]() mutable
+		{
+			if (UMUNUpdateChecker* This = WeakThis.Get())
+			{
+				This->OnBatchedVersionsParsed(bValid, MoveTemp(ModReferences), MoveTemp(RecentVersions), MoveTemp(Logos), MoveTemp(NeedWiderWindow));
+			}
+		});
+	}, UE::Tasks::ETaskPriority::BackgroundLow);
+}
+
+bool UMUNUpdateChecker::ParseBatchedVersions(const TConstArrayView<uint8> Content, const int32 VersionWindow, TMap<FString, TArray<FVersion>>& OutRecentVersions, TMap<FString, FString>& OutLogos, TArray<FString>& OutNeedWiderWindow, const bool bIncludePreReleases, const bool bLogVerbose)
+{
+	MUN_SCOPE_PHASE(ParseVersions, TEXT("Parse versions"));
+
+	// Anything other than a well-formed result without errors is treated as a failed query
+	return FMUNVersionsReader::ReadBatchedVersions(Content, [&, VersionWindow, bIncludePreReleases, bLogVerbose](const FUtf8StringView ModReference, const FUtf8StringView Logo, const TConstArrayView<FMUNVersionEntry> Versions)
+	{
+		if (!Logo.IsEmpty())
+		{
+			OutLogos.Add(FMUNVersionsReader::ToString(ModReference), FMUNVersionsReader::ToString(Logo));
+		}
+
+		TArray<FVersion> RecentVersions = SelectRecentVersions(Versions, bIncludePreReleases, bLogVerbose);
+
+		// Nothing compatible among the newest versions, but there are older ones we haven't seen
+		if (RecentVersions.IsEmpty() && Versions.Num() >= VersionWindow && VersionWindow < WideVersionWindowSize)
+		{
+			OutNeedWiderWindow.Add(FMUNVersionsReader::ToString(ModReference));
+			return;
+		}
+
+		OutRecentVersions.Add(FMUNVersionsReader::ToString(ModReference), MoveTemp(RecentVersions));
+	});
+}
+
+void UMUNUpdateChecker::OnBatchedVersionsParsed(const bool bValid, TArray<FString> ModReferences, TMap<FString, TArray<FVersion>> RecentVersions, TMap<FString, FString> Logos, TArray<FString> NeedWiderWindow)
+{
+	MUN_SCOPE_GAME_THREAD();
+
+	// Fall back to asking for each mod individually
+	if (!bValid)
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Batched version query failed, falling back to per-mod requests for %d mods."), ModReferences.Num());
+
+		for (const FString& ModReference : ModReferences)
+		{
+			RequestModVersions(ModReference);
+		}
+		return;
+	}
+
+	if (!NeedWiderWindow.IsEmpty())
+	{
+		if (Settings.bDebugLogging)
+		{
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("No compatible version among the newest %d for %d mods, asking for more."), VersionWindowSize, NeedWiderWindow.Num());
+		}
+
+		RequestModVersionsBatched(NeedWiderWindow, WideVersionWindowSize);
+	}
+
+	// Only accept mods we asked for in this chunk, so each of them is counted exactly once
+	for (const FString& ModReference : ModReferences)
+	{
+		if (NeedWiderWindow.Contains(ModReference))
+		{
+			continue;
+		}
+
+		TArray<FVersion> ModVersions;
+
+		if (TArray<FVersion>* FoundVersions = RecentVersions.Find(ModReference))
+		{
+			ModVersions = MoveTemp(*FoundVersions);
+		}
+		else if (Settings.bDebugLogging)
+		{
+			// Mods that are not listed on SMR are missing from the result, they still count as retrieved
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Mod was not found on SMR: %s"), *ModReference);
+		}
+
+		VersionCache->UpdateVersion(ModReference, ModVersions);
+		VersionCache->UpdateLogo(ModReference, Logos.FindRef(ModReference));
+		OnModVersionRetrieved(ModReference, ModVersions);
+	}
+}
+
+// Parse the HTTP response to extract the data we want: "mod_reference" and "version"
+void UMUNUpdateChecker::OnResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful, FString ModReference, bool bFullHistory)
+{
+	const int32 ResponseCode = bWasSuccessful && Response.IsValid() ? Response->GetResponseCode() : 0;
+
+	// Errors that outlasted the retries, like a 404 for a mod that isn't on SMR or a 5xx, have no versions to parse
+	if (!EHttpResponseCodes::IsOk(ResponseCode))
+	{
+		if (ResponseCode == 0)
+		{
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Unable to connect to the API, user may be offline."));
+		}
+		else
+		{
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("API answered %d for %s."), ResponseCode, *ModReference);
+		}
+		bHadFailures = true;
+
+		// The request failed for good, count it anyway so the other mods still get their notification. Fall back to the cached version if we have one.
+		const FMUNCachedModVersion* CachedVersion = VersionCache->Find(ModReference);
+		OnModVersionRetrieved(ModReference, CachedVersion ? CachedVersion->RecentVersions : TArray<FVersion>());
+		return;
+	}
+
+	// Parse and select the highest version on a worker thread, only the result comes back to the game thread
+	TWeakObjectPtr<UMUNUpdateChecker> WeakThis = this;
+	const bool bAllowPreReleases = Settings.bIncludePreReleases;
+	const bool bLogVerbose = Settings.bDebugLogging;
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Response, ModReference, bFullHistory, bAllowPreReleases, bLogVerbose]()
+	{
+		TArray<uint8> Decompressed;
+		int32 NumVersions = 0;
+		// The full history is only asked for when the newest versions weren't enough, keep every compatible version in it
+		const int32 MaxVersions = bFullHistory ? MAX_int32 : MaxRecentVersions;
+		TOptional<TArray<FVersion>> RecentVersions = ParseModVersions(FMUNRequestScheduler::GetContent(Response, Decompressed), NumVersions, MaxVersions, bAllowPreReleases, bLogVerbose);
+
+		// Nothing compatible among the newest versions, but there are older ones we haven't seen
+		const bool bNeedsFullHistory = !bFullHistory && RecentVersions.IsSet() && RecentVersions->IsEmpty() && NumVersions >= VersionWindowSize;
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, ModReference, RecentVersions = MoveTemp(RecentVersions), bNeedsFullHistory]()
+		{
+			if (UMUNUpdateChecker* This = WeakThis.Get())
+			{
+				This->OnModVersionsParsed(ModReference, RecentVersions, bNeedsFullHistory);
+			}
+		});
+	}, UE::Tasks::ETaskPriority::BackgroundLow);
+}
+
+TOptional<TArray<FVersion>> UMUNUpdateChecker::ParseModVersions(const TConstArrayView<uint8> Content, int32& OutNumVersions, const int32 MaxVersions, const bool bIncludePreReleases, const bool bLogVerbose)
+{
+	MUN_SCOPE_PHASE(ParseVersions, TEXT("Parse versions"));
+
+	// Only "version" and "game_version" are read from each element, straight from the response bytes
+	TArray<FMUNVersionEntry> Versions;
+	FMUNDecodedStrings DecodedStrings;
+	if (FMUNVersionsReader::ReadVersionsAll(Content, Versions, DecodedStrings))
+	{
+		OutNumVersions = Versions.Num();
+		return SelectRecentVersions(Versions, bIncludePreReleases, bLogVerbose, MaxVersions);
+	}
+
+	return {};
+}
+
+void UMUNUpdateChecker::OnModVersionsParsed(const FString& ModReference, const TOptional<TArray<FVersion>>& RecentVersions, const bool bNeedsFullHistory)
+{
+	MUN_SCOPE_GAME_THREAD();
+
+	if (bNeedsFullHistory)
+	{
+		RequestModVersions(ModReference, true);
+		return;
+	}
+
+	if (RecentVersions.IsSet())
+	{
+		VersionCache->UpdateVersion(ModReference, RecentVersions.GetValue());
+
+		OnModVersionRetrieved(ModReference, RecentVersions.GetValue());
+	}
+	else
+	{
+		if (Settings.bDebugLogging)
+		{
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Invalid response: no field \"data\" found."));
+		}
+
+		bHadFailures = true;
+		OnModVersionRetrieved(ModReference, {});
+	}
+}
+
+// Find the newest versions in a list of SMR versions that support the current game version. Safe to call from any thread.
+TArray<FVersion> UMUNUpdateChecker::SelectRecentVersions(const TConstArrayView<FMUNVersionEntry> Versions, const bool bIncludePreReleases, const bool bLogVerbose, const int32 MaxVersions)
+{
+	MUN_SCOPE_PHASE(VersionSelection, TEXT("Version selection"));
+
+	const FMUNUtf8SemVer GameVersion = {FEngineVersion::Current().GetChangelist(), 0, 0};
+
+	TArray<FMUNUtf8SemVer, TInlineAllocator<VersionWindowSize>> CompatibleVersions;
+
+	for (const FMUNVersionEntry& Entry : Versions)
+	{
+		FMUNUtf8SemVer Version;
+		if (!FMUNUtf8SemVer::Parse(Entry.Version, Version))
+		{
+			if (bLogVerbose)
+			{
+				UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Version %s is not a valid semantic version, excluding."), *FMUNVersionsReader::ToString(Entry.Version));
+			}
+			continue;
+		}
+
+		// Check if the mod supports our current game version (Useful for not showing versions exclusive to the Experimental branch)
+		if (!FMUNVersionRange::Matches(Entry.GameVersion, GameVersion))
+		{
+			if (bLogVerbose)
+			{
+				UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Version %s is newer than the game version, excluding."), *FMUNVersionsReader::ToString(Entry.Version));
+			}
+			continue;
+		}
+
+		if (Version.IsPreRelease() && !bIncludePreReleases)
+		{
+			if (bLogVerbose)
+			{
+				UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Version %s is a pre-release, excluding."), *FMUNVersionsReader::ToString(Entry.Version));
+			}
+			continue;
+		}
+
+		CompatibleVersions.Add(Version);
+	}
+
+	// SMR usually lists versions newest first already, but the order isn't guaranteed
+	CompatibleVersions.Sort([](const FMUNUtf8SemVer& A, const FMUNUtf8SemVer& B) { return A.Compare(B) > 0; });
+
+	TArray<FVersion> RecentVersions;
+	RecentVersions.Reserve(FMath::Min(CompatibleVersions.Num(), MaxVersions));
+	for (int32 VersionIndex = 0; VersionIndex < CompatibleVersions.Num() && VersionIndex < MaxVersions; VersionIndex++)
+	{
+		RecentVersions.Add(CompatibleVersions[VersionIndex].ToVersion());
+	}
+	return RecentVersions;
+}
+
+void UMUNUpdateChecker::OnModVersionRetrieved(const FString& ModReference, const TArray<FVersion>& RecentVersions, const bool bFromCache)
+{
+	const int32 RecordIndex = ModTable.IndexOf(ModReference);
+	if (RecordIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Installed mods that depend on this one may not accept its newest release, offer the newest one all of them accept
+	FName BlockingDependent;
+	const FVersion NewestAllowed = DependencyGraph.FindNewestAllowed(FName(*ModReference), RecentVersions, &BlockingDependent);
+
+	// A full window of recent versions may have cut off the older release the dependents allow, look through all of them once
+	if (NewestAllowed.Compare(FVersion{0,0,0}) == 0 && RecentVersions.Num() == MaxRecentVersions && !WidenedMods.Contains(ModReference))
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("None of the %d newest versions of %s is allowed by %s, asking for all of its versions."), RecentVersions.Num(), *ModReference, *BlockingDependent.ToString());
+
+		WidenedMods.Add(ModReference);
+		RequestModVersions(ModReference, true);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_MUN_ModsRetrieved);
+	if (Settings.bRecordReport)
+	{
+		FMUNCheckReport::Get().RecordModRetrieved(ModReference, bFromCache);
+	}
+
+	FMUNModRecord& ModRecord = ModTable.Records[RecordIndex];
+	ModRecord.APIVersion = RecentVersions.IsEmpty() ? FVersion{0,0,0} : RecentVersions[0];
+	ModRecord.CompatibleVersion = NewestAllowed;
+	ModTable.SetLocked(RecordIndex, ModRecord.CompatibleVersion.Compare(ModRecord.APIVersion) != 0);
+
+	if (Settings.bDebugLogging)
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("%s: %s"), *ModReference, *ModRecord.APIVersion.ToString());
+
+		if (ModTable.IsLocked(RecordIndex))
+		{
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("%s %s is outside the range %s allows, offering %s instead."), *ModReference, *ModRecord.APIVersion.ToString(), *BlockingDependent.ToString(), *ModRecord.CompatibleVersion.ToString());
+		}
+	}
+
+	const FMUNCachedModVersion* CachedVersion = VersionCache->Find(ModReference);
+	if (CachedVersion)
+	{
+		ModRecord.LogoURL = CachedVersion->LogoURL;
+	}
+
+	// The cached changelog belongs to the highest version, it can only be used if that is the one offered
+	if (ModRecord.ChangelogState != EMUNChangelogState::Fetched)
+	{
+		if (CachedVersion && !CachedVersion->Changelog.IsEmpty() && CachedVersion->HighestVersion.Compare(ModRecord.CompatibleVersion) == 0)
+		{
+			ModRecord.Changelog = CachedVersion->Changelog;
+			ModRecord.ChangelogState = EMUNChangelogState::Fetched;
+		}
+	}
+
+	NumRetrieved++;
+
+	// Let listeners evaluate every mod as soon as it arrives instead of waiting for the slowest response
+	BroadcastModChecked(RecordIndex);
+	BroadcastIfComplete();
+}
+
+void UMUNUpdateChecker::BroadcastModChecked(const int32 RecordIndex)
+{
+	CheckedMods.Add(RecordIndex);
+	OnModChecked.Broadcast(RecordIndex);
+}
+
+void UMUNUpdateChecker::BroadcastIfComplete()
+{
+	if (IsComplete() && !bCompleteBroadcast)
+	{
+		bCompleteBroadcast = true;
+
+		// Only a check where every mod was confirmed can be the baseline for the next one, otherwise releases could be missed
+		if (!bHadFailures && Settings.bRecordBaseline)
+		{
+			VersionCache->SetLastSuccessfulCheck(OldestConfirmation, FEngineVersion::Current().GetChangelist());
+
+			if (!InstalledFingerprint.IsEmpty())
+			{
+				VersionCache->SetCheckResults(InstalledFingerprint, ModTable, OldestConfirmation);
+			}
+		}
+
+		VersionCache->SaveAsync();
+		OnCheckComplete.Broadcast();
+	}
+}
+
+void UMUNUpdateChecker::RequestChangelogs(const TArray<FString>& ModReferences)
+{
+	TArray<FString> ModsToFetch;
+	for (const FString& ModReference : ModReferences)
+	{
+		FMUNModRecord* ModRecord = ModTable.Find(ModReference);
+		if (ModRecord && (ModRecord->ChangelogState == EMUNChangelogState::NotFetched || ModRecord->ChangelogState == EMUNChangelogState::Failed))
+		{
+			ModRecord->ChangelogState = EMUNChangelogState::Fetching;
+			ModsToFetch.Add(ModReference);
+		}
+	}
+
+	for (int32 ChunkStart = 0; ChunkStart < ModsToFetch.Num(); ChunkStart += ChangelogQueryBatchSize)
+	{
+		const int32 ChunkSize = FMath::Min(ChangelogQueryBatchSize, ModsToFetch.Num() - ChunkStart);
+		TArray<FString> ChunkReferences(ModsToFetch.GetData() + ChunkStart, ChunkSize);
+
+		// One aliased getModByReference per mod, all in a single query
+		FString Query = TEXT("{");
+		for (int32 Index = 0; Index < ChunkReferences.Num(); Index++)
+		{
+			const FMUNModRecord* ModRecord = ModTable.Find(ChunkReferences[Index]);
+			Query += FString::Printf(TEXT(" m%d: getModByReference(modReference: \"%s\") { mod_reference version(version: \"%s\") { changelog } }"), Index, *ModRecord->ModReference.ReplaceCharWithEscapedChar(), *ModRecord->CompatibleVersion.ToString());
+		}
+		Query += TEXT(" }");
+
+		const TSharedRef<FJsonObject> RequestObj = MakeShared<FJsonObject>();
+		RequestObj->SetStringField(TEXT("query"), Query);
+
+		FString RequestBody;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&RequestBody);
+		FJsonSerializer::Serialize(RequestObj, Writer);
+
+		// Create an HTTP POST request
+		const FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
+		Request->SetURL(Settings.APIBaseURL + "/v2/query");
+		Request->SetContentAsString(RequestBody);
+		Request->SetVerb("POST");
+		Request->SetHeader(TEXT("User-Agent"), "X-UE5-ModUpdateNotifier-Agent");
+		Request->SetHeader("Content-Type", TEXT("application/json"));
+
+		if (Settings.bDebugLogging)
+		{
+			UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Requesting changelogs for %d mods in a single query."), ChunkReferences.Num());
+		}
+
+		PendingRequests->Enqueue(Request, FHttpRequestCompleteDelegate::CreateUObject(this, &UMUNUpdateChecker::OnChangelogsReceived, ChunkReferences), FString::Printf(TEXT("changelogs of %d mods"), ChunkReferences.Num()));
+	}
+}
+
+void UMUNUpdateChecker::OnChangelogsReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful, TArray<FString> ModReferences)
+{
+	if (!bWasSuccessful || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Unable to connect to the API, user may be offline."));
+		OnChangelogsParsed(false, ModReferences, {});
+		return;
+	}
+
+	// Changelogs can be large, parse them on a worker thread like the version responses
+	TWeakObjectPtr<UMUNUpdateChecker> WeakThis = this;
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Response, ModReferences = MoveTemp(ModReferences)]() mutable
+	{
+		TMap<FString, FString> Changelogs;
+		TArray<uint8> Decompressed;
+		const TConstArrayView<uint8> Content = FMUNRequestScheduler::GetContent(Response, Decompressed);
+		const FUTF8ToTCHAR ContentString(reinterpret_cast<const ANSICHAR*>(Content.GetData()), Content.Num());
+		const bool bValid = ParseChangelogs(FString(ContentString.Length(), ContentString.Get()), Changelogs);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bValid, ModReferences = MoveTemp(ModReferences), Changelogs = MoveTemp(Changelogs)]()
+		{
+			if (UMUNUpdateChecker* This = WeakThis.Get())
+			{
+				This->OnChangelogsParsed(bValid, ModReferences, Changelogs);
+			}
+		});
+	}, UE::Tasks::ETaskPriority::BackgroundLow);
+}
+
+bool UMUNUpdateChecker::ParseChangelogs(const FString& Content, TMap<FString, FString>& OutChangelogs)
+{
+	MUN_SCOPE_PHASE(ParseChangelogs, TEXT("Parse changelogs"));
+
+	// Create our JSON object
+	TSharedPtr<FJsonObject> ResponseObj;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Content);
+	FJsonSerializer::Deserialize(Reader, ResponseObj);
+
+	const TSharedPtr<FJsonObject>* DataObj = nullptr;
+	if (!ResponseObj.IsValid() || !ResponseObj->TryGetObjectField(TEXT("data"), DataObj))
+	{
+		return false;
+	}
+
+	// Every aliased field holds one mod, mods or versions that weren't found are null and skipped
+	for (const auto& ModField : (*DataObj)->Values)
+	{
+		const TSharedPtr<FJsonObject>* ModObj = nullptr;
+		const TSharedPtr<FJsonObject>* VersionObj = nullptr;
+		FString ModReference;
+		FString Changelog;
+
+		if (ModField.Value->TryGetObject(ModObj)
+			&& (*ModObj)->TryGetStringField(TEXT("mod_reference"), ModReference)
+			&& (*ModObj)->TryGetObjectField(TEXT("version"), VersionObj))
+		{
+			(*VersionObj)->TryGetStringField(TEXT("changelog"), Changelog);
+
+			if (Changelog.Len() > MaxChangelogCharacters)
+			{
+				// Cut at a line break so the markdown of the last line kept isn't split
+				Changelog.LeftInline(MaxChangelogCharacters);
+
+				int32 LineBreak = INDEX_NONE;
+				if (Changelog.FindLastChar(TEXT('\n'), LineBreak) && LineBreak > 0)
+				{
+					Changelog.LeftInline(LineBreak);
+				}
+				Changelog += TEXT("\n\n...");
+			}
+
+			OutChangelogs.Add(ModReference, Changelog);
+		}
+	}
+
+	return true;
+}
+
+void UMUNUpdateChecker::OnChangelogsParsed(const bool bValid, const TArray<FString>& ModReferences, const TMap<FString, FString>& Changelogs)
+{
+	MUN_SCOPE_GAME_THREAD();
+
+	for (const FString& ModReference : ModReferences)
+	{
+		const int32 RecordIndex = ModTable.IndexOf(ModReference);
+		if (RecordIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		FMUNModRecord& ModRecord = ModTable.Records[RecordIndex];
+		const FString* Changelog = Changelogs.Find(ModReference);
+
+		if (bValid && Changelog)
+		{
+			ModRecord.Changelog = *Changelog;
+			ModRecord.ChangelogState = EMUNChangelogState::Fetched;
+
+			// The cache only holds changelogs of the highest version
+			if (!ModTable.IsLocked(RecordIndex))
+			{
+				VersionCache->UpdateChangelog(ModReference, *Changelog);
+			}
+		}
+		else
+		{
+			ModRecord.ChangelogState = EMUNChangelogState::Failed;
+		}
+
+		OnChangelogFetched.Broadcast(RecordIndex);
+	}
+
+	VersionCache->SaveAsync();
+}
+
+void UMUNUpdateChecker::CancelPendingRequests()
+{
+	bCancelled = true;
+
+	if (ScanTickHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(ScanTickHandle);
+		ScanTickHandle.Reset();
+	}
+
+	if (PendingRequests.IsValid())
+	{
+		PendingRequests->CancelAll();
+	}
+}
+void UMUNUpdateChecker::BeginDestroy()
+{
+	CancelPendingRequests();
+	Super::BeginDestroy();
+}
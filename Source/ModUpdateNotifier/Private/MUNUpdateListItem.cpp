@@ -0,0 +1,193 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNUpdateListItem.h"
+
+#include "MUNIconCache.h"
+#include "MUNUpdateSubsystem.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/HorizontalBox.h"
+#include "Components/HorizontalBoxSlot.h"
+#include "Components/Image.h"
+#include "Components/SizeBox.h"
+#include "Components/TextBlock.h"
+#include "Components/VerticalBox.h"
+#include "Components/VerticalBoxSlot.h"
+#include "Engine/GameInstance.h"
+
+bool UMUNUpdateListItem::GetUpdateInfo(FAvailableUpdateInfo& OutUpdateInfo) const
+{
+	const UMUNMenuModule* Module = MenuModule.Get();
+	return Module && Module->GetAvailableUpdate(UpdateIndex, OutUpdateInfo);
+}
+
+void UMUNUpdateEntryWidget::NativeOnListItemObjectSet(UObject* ListItemObject)
+{
+	IUserObjectListEntry::NativeOnListItemObjectSet(ListItemObject);
+
+	// The entry is being recycled for another row
+	ReleaseIcon();
+
+	FAvailableUpdateInfo UpdateInfo;
+	if (const UMUNUpdateListItem* ListItem = Cast<UMUNUpdateListItem>(ListItemObject); ListItem && ListItem->GetUpdateInfo(UpdateInfo))
+	{
+		NativeOnUpdateInfoSet(UpdateInfo);
+		RequestIcon(UpdateInfo.ModLogoURL);
+	}
+}
+
+void UMUNUpdateEntryWidget::NativeOnEntryReleased()
+{
+	ReleaseIcon();
+
+	IUserObjectListEntry::NativeOnEntryReleased();
+}
+
+void UMUNUpdateEntryWidget::NativeDestruct()
+{
+	ReleaseIcon();
+
+	if (UMUNIconCache* Cache = IconCache.Get())
+	{
+		Cache->OnIconLoaded.Remove(IconLoadedHandle);
+	}
+	IconLoadedHandle.Reset();
+
+	Super::NativeDestruct();
+}
+
+void UMUNUpdateEntryWidget::NativeOnUpdateInfoSet(const FAvailableUpdateInfo& UpdateInfo)
+{
+	OnUpdateInfoSet(UpdateInfo);
+}
+
+void UMUNUpdateEntryWidget::RequestIcon(const FString& LogoURL)
+{
+	if (!IconCache.IsValid())
+	{
+		const UGameInstance* GameInstance = GetGameInstance();
+		UMUNUpdateSubsystem* UpdateSubsystem = GameInstance ? GameInstance->GetSubsystem<UMUNUpdateSubsystem>() : nullptr;
+		if (!UpdateSubsystem)
+		{
+			NativeOnIconSet(nullptr);
+			return;
+		}
+
+		IconCache = UpdateSubsystem->GetIconCache();
+		IconLoadedHandle = IconCache->OnIconLoaded.AddUObject(this, &UMUNUpdateEntryWidget::OnIconLoaded);
+	}
+
+	UTexture2D* Icon = nullptr;
+	bWaitingForIcon = !IconCache->RequestIcon(LogoURL, Icon);
+	HeldLogoURL = LogoURL;
+
+	// Clears the icon of the row this entry showed before
+	NativeOnIconSet(Icon);
+}
+
+void UMUNUpdateEntryWidget::ReleaseIcon()
+{
+	if (HeldLogoURL.IsEmpty())
+	{
+		return;
+	}
+
+	if (UMUNIconCache* Cache = IconCache.Get())
+	{
+		Cache->ReleaseIcon(HeldLogoURL);
+	}
+	HeldLogoURL.Empty();
+	bWaitingForIcon = false;
+}
+
+void UMUNUpdateEntryWidget::NativeOnIconSet(UTexture2D* Icon)
+{
+	OnIconSet(Icon);
+}
+
+void UMUNUpdateEntryWidget::OnIconLoaded(const FString& LogoURL, UTexture2D* Icon)
+{
+	if (bWaitingForIcon && LogoURL == HeldLogoURL)
+	{
+		bWaitingForIcon = false;
+		NativeOnIconSet(Icon);
+	}
+}
+
+void UMUNUpdateRowWidget::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
+
+	// Native widgets get an empty widget tree, a blueprint subclass brings its own
+	if (!WidgetTree || WidgetTree->RootWidget)
+	{
+		return;
+	}
+
+	UHorizontalBox* Row = WidgetTree->ConstructWidget<UHorizontalBox>();
+
+	// The size box keeps rows aligned while icons are loading or missing
+	USizeBox* IconBox = WidgetTree->ConstructWidget<USizeBox>();
+	IconBox->SetWidthOverride(IconDisplaySize);
+	IconBox->SetHeightOverride(IconDisplaySize);
+	IconImage = WidgetTree->ConstructWidget<UImage>();
+	IconImage->SetVisibility(ESlateVisibility::Hidden);
+	IconBox->AddChild(IconImage);
+	UHorizontalBoxSlot* IconSlot = Row->AddChildToHorizontalBox(IconBox);
+	IconSlot->SetPadding(FMargin(0.0f, 0.0f, 8.0f, 0.0f));
+	IconSlot->SetVerticalAlignment(VAlign_Center);
+
+	UVerticalBox* TextBox = WidgetTree->ConstructWidget<UVerticalBox>();
+	NameText = WidgetTree->ConstructWidget<UTextBlock>();
+	VersionText = WidgetTree->ConstructWidget<UTextBlock>();
+	TextBox->AddChildToVerticalBox(NameText);
+	TextBox->AddChildToVerticalBox(VersionText)->SetPadding(FMargin(0.0f, 2.0f, 0.0f, 0.0f));
+	UHorizontalBoxSlot* TextSlot = Row->AddChildToHorizontalBox(TextBox);
+	TextSlot->SetSize(FSlateChildSize(ESlateSizeRule::Fill));
+	TextSlot->SetVerticalAlignment(VAlign_Center);
+
+	WidgetTree->RootWidget = Row;
+}
+
+void UMUNUpdateRowWidget::NativeOnUpdateInfoSet(const FAvailableUpdateInfo& UpdateInfo)
+{
+	Super::NativeOnUpdateInfoSet(UpdateInfo);
+
+	if (NameText)
+	{
+		NameText->SetText(UpdateInfo.ModAuthor.IsEmpty() ? FText::FromString(UpdateInfo.ModFriendlyName)
+			: FText::FromString(FString::Printf(TEXT("%s by %s"), *UpdateInfo.ModFriendlyName, *UpdateInfo.ModAuthor)));
+	}
+
+	if (VersionText)
+	{
+		VersionText->SetText(FText::FromString(FString::Printf(TEXT("%s \u2192 %s"), *UpdateInfo.ModExistingVersion, *UpdateInfo.ModAvailableVersion)));
+	}
+}
+
+void UMUNUpdateRowWidget::NativeOnIconSet(UTexture2D* Icon)
+{
+	Super::NativeOnIconSet(Icon);
+
+	if (!IconImage)
+	{
+		return;
+	}
+
+	if (Icon)
+	{
+		IconImage->SetBrushFromTexture(Icon);
+		IconImage->SetVisibility(ESlateVisibility::HitTestInvisible);
+	}
+	else
+	{
+		// The brush would keep the previous row's icon from being collected once the cache drops it
+		IconImage->SetBrushResourceObject(nullptr);
+		IconImage->SetVisibility(ESlateVisibility::Hidden);
+	}
+}
+
+UMUNUpdateListView::UMUNUpdateListView(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	EntryWidgetClass = UMUNUpdateRowWidget::StaticClass();
+}
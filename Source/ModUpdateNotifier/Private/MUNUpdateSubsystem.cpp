@@ -0,0 +1,289 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNUpdateSubsystem.h"
+
+#include "ModUpdateNotifier.h"
+#include "Async/Async.h"
+#include "Tasks/Task.h"
+#include "FGBlueprintFunctionLibrary.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+void UMUNUpdateSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	VersionCache = MakeShared<FMUNVersionCache>();
+
+	// Servers write new updates to their report instead
+	if (!IsRunningDedicatedServer())
+	{
+		OnNewUpdatesFound.AddDynamic(this, &UMUNUpdateSubsystem::ShowNewUpdatesNotice);
+	}
+}
+
+void UMUNUpdateSubsystem::Deinitialize()
+{
+	if (RecheckHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(RecheckHandle);
+		RecheckHandle.Reset();
+	}
+
+	if (MenuChecker)
+	{
+		MenuChecker->CancelPendingRequests();
+	}
+
+	if (ServerChecker)
+	{
+		ServerChecker->CancelPendingRequests();
+	}
+
+	if (IconCache)
+	{
+		IconCache->CancelPendingRequests();
+	}
+
+	if (RecheckChecker)
+	{
+		RecheckChecker->CancelPendingRequests();
+	}
+
+	// The cache is written on a worker, the game may exit right after this
+	VersionCache->Flush();
+
+	Super::Deinitialize();
+}
+
+UMUNUpdateChecker* UMUNUpdateSubsystem::GetMenuChecker(const FMUNCheckSettings& Settings)
+{
+	if (!MenuChecker)
+	{
+		// The check report belongs to the check behind the notification
+		FMUNCheckSettings MenuSettings = Settings;
+		MenuSettings.bRecordReport = true;
+
+		MenuChecker = NewObject<UMUNUpdateChecker>(this);
+		MenuChecker->Initialize(MenuSettings, VersionCache.ToSharedRef());
+
+		// Bound before any menu, so re-checks don't depend on a menu being around when the check completes
+		MenuChecker->OnCheckComplete.AddUObject(this, &UMUNUpdateSubsystem::OnMenuCheckComplete);
+	}
+
+	return MenuChecker;
+}
+
+void UMUNUpdateSubsystem::OnMenuCheckComplete()
+{
+	// Keep an eye out for updates released while the game is running, long after the menu is gone
+	MenuChecker->OnCheckComplete.RemoveAll(this);
+	StartPeriodicRecheck(MenuChecker->GetSettings(), *MenuChecker);
+}
+
+UMUNIconCache* UMUNUpdateSubsystem::GetIconCache()
+{
+	if (!IconCache)
+	{
+		IconCache = NewObject<UMUNIconCache>(this);
+		IconCache->Initialize();
+	}
+
+	return IconCache;
+}
+
+void UMUNUpdateSubsystem::StartServerCheck(const FMUNCheckSettings& Settings, UModLoadingLibrary* ModLoadingLibrary, UWorldModuleManager* WorldModuleManager)
+{
+	if (ServerChecker)
+	{
+		return;
+	}
+
+	UE_LOG(LogModUpdateNotifier, Display, TEXT("Checking installed mods for updates in the background."));
+
+	FMUNCheckSettings ServerSettings = Settings;
+	ServerSettings.RequestSettings.MaxConcurrentRequests = FMath::Min(ServerSettings.RequestSettings.MaxConcurrentRequests, ServerMaxConcurrentRequests);
+
+	ServerChecker = NewObject<UMUNUpdateChecker>(this);
+	ServerChecker->Initialize(ServerSettings, VersionCache.ToSharedRef());
+	ServerChecker->OnCheckComplete.AddUObject(this, &UMUNUpdateSubsystem::OnServerCheckComplete);
+	ServerChecker->StartCheck(ModLoadingLibrary, WorldModuleManager);
+}
+
+void UMUNUpdateSubsystem::OnServerCheckComplete()
+{
+	WriteServerReport(*ServerChecker);
+	StartPeriodicRecheck(ServerChecker->GetSettings(), *ServerChecker);
+}
+
+void UMUNUpdateSubsystem::WriteServerReport(const UMUNUpdateChecker& Checker)
+{
+	const FMUNModTable& ModTable = Checker.GetModTable();
+
+	// Only copy what the report needs, building and writing it happens on a worker so the server tick never waits on disk
+	TArray<FMUNModRecord> OutdatedMods;
+	for (int32 RecordIndex = 0; RecordIndex < ModTable.Num(); RecordIndex++)
+	{
+		if (Checker.IsUpdateAvailable(RecordIndex))
+		{
+			OutdatedMods.Add(ModTable.Records[RecordIndex]);
+		}
+	}
+
+	const int32 NumModsChecked = ModTable.Num();
+	const FString APIBaseURL = Checker.GetSettings().APIBaseURL;
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [OutdatedMods = MoveTemp(OutdatedMods), NumModsChecked, APIBaseURL]()
+	{
+		TArray<TSharedPtr<FJsonValue>> OutdatedValues;
+		for (const FMUNModRecord& ModRecord : OutdatedMods)
+		{
+			const TSharedRef<FJsonObject> ModObj = MakeShared<FJsonObject>();
+			ModObj->SetStringField(TEXT("mod_reference"), ModRecord.ModReference);
+			ModObj->SetStringField(TEXT("name"), ModRecord.FriendlyName);
+			ModObj->SetStringField(TEXT("author"), ModRecord.Author);
+			ModObj->SetStringField(TEXT("installed_version"), ModRecord.InstalledVersion.ToString());
+			ModObj->SetStringField(TEXT("available_version"), ModRecord.CompatibleVersion.ToString());
+			ModObj->SetStringField(TEXT("newest_version"), ModRecord.APIVersion.ToString());
+			if (ModRecord.bHasSupportURL)
+			{
+				ModObj->SetStringField(TEXT("support_url"), ModRecord.SupportURL);
+			}
+			OutdatedValues.Add(MakeShared<FJsonValueObject>(ModObj));
+
+			UE_LOG(LogModUpdateNotifier, Display, TEXT("Update available for %s (%s): %s -> %s"), *ModRecord.FriendlyName, *ModRecord.ModReference, *ModRecord.InstalledVersion.ToString(), *ModRecord.CompatibleVersion.ToString());
+		}
+
+		const TSharedRef<FJsonObject> ReportObj = MakeShared<FJsonObject>();
+		ReportObj->SetStringField(TEXT("generated_at"), FDateTime::UtcNow().ToIso8601());
+		ReportObj->SetStringField(TEXT("api_base_url"), APIBaseURL);
+		ReportObj->SetNumberField(TEXT("mods_checked"), NumModsChecked);
+		ReportObj->SetNumberField(TEXT("updates_available"), OutdatedValues.Num());
+		ReportObj->SetArrayField(TEXT("outdated_mods"), OutdatedValues);
+
+		FString Report;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Report);
+		FJsonSerializer::Serialize(ReportObj, Writer);
+
+		const FString ReportPath = GetServerReportPath();
+		if (FFileHelper::SaveStringToFile(Report, *ReportPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+		{
+			UE_LOG(LogModUpdateNotifier, Display, TEXT("%d of %d mods have updates available, wrote report to %s"), OutdatedValues.Num(), NumModsChecked, *ReportPath);
+		}
+		else
+		{
+			UE_LOG(LogModUpdateNotifier, Warning, TEXT("Unable to write update report: %s"), *ReportPath);
+		}
+	}, UE::Tasks::ETaskPriority::BackgroundLow);
+}
+
+void UMUNUpdateSubsystem::StartPeriodicRecheck(const FMUNCheckSettings& Settings, const UMUNUpdateChecker& CompletedCheck)
+{
+	if (Settings.RecheckIntervalSeconds <= 0.0f || RecheckHandle.IsValid())
+	{
+		return;
+	}
+
+	RecheckSettings = Settings;
+	RecheckSettings.bRecordReport = false;
+	RecheckSettings.RequestSettings.MaxConcurrentRequests = RecheckMaxConcurrentRequests;
+	RecheckSettings.RequestSettings.MinDispatchIntervalSeconds = RecheckDispatchIntervalSeconds;
+
+	// The completed check is the baseline, only versions that differ from it are worth a notification
+	RecheckMods = CompletedCheck.GetModTable();
+	RecheckFingerprint = CompletedCheck.GetInstalledFingerprint();
+	RecheckDependencies = CompletedCheck.GetDependencyGraph();
+	for (const FMUNModRecord& ModRecord : RecheckMods.Records)
+	{
+		KnownVersions.Add(ModRecord.ModReference, ModRecord.CompatibleVersion);
+	}
+
+	UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Checking %d mods for updates again every %.0f minutes."), RecheckMods.Num(), Settings.RecheckIntervalSeconds / 60.0f);
+
+	RecheckHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UMUNUpdateSubsystem::OnRecheckTimer), Settings.RecheckIntervalSeconds);
+}
+
+bool UMUNUpdateSubsystem::OnRecheckTimer(float DeltaTime)
+{
+	// A slow re-check is still running, skip this round rather than piling up requests
+	if (RecheckChecker && !RecheckChecker->IsComplete())
+	{
+		return true;
+	}
+
+	// Stale cache entries are confirmed by a single updated mods query, fresh ones don't touch the network at all
+	RecheckChecker = NewObject<UMUNUpdateChecker>(this);
+	RecheckChecker->Initialize(RecheckSettings, VersionCache.ToSharedRef());
+	RecheckChecker->OnCheckComplete.AddUObject(this, &UMUNUpdateSubsystem::OnRecheckComplete);
+	RecheckChecker->StartCheck(RecheckMods, RecheckFingerprint, RecheckDependencies);
+
+	return true;
+}
+
+void UMUNUpdateSubsystem::OnRecheckComplete()
+{
+	const FMUNModTable& ModTable = RecheckChecker->GetModTable();
+
+	TArray<FMUNModRecord> NewUpdates;
+	for (int32 RecordIndex = 0; RecordIndex < ModTable.Num(); RecordIndex++)
+	{
+		const FMUNModRecord& ModRecord = ModTable.Records[RecordIndex];
+
+		// Failed requests come back as 0.0.0 and say nothing about the remote version
+		if (ModRecord.APIVersion.Compare(FVersion{0,0,0}) == 0)
+		{
+			continue;
+		}
+
+		const FVersion* KnownVersion = KnownVersions.Find(ModRecord.ModReference);
+		const bool bVersionChanged = !KnownVersion || KnownVersion->Compare(ModRecord.CompatibleVersion) != 0;
+		KnownVersions.Add(ModRecord.ModReference, ModRecord.CompatibleVersion);
+
+		if (bVersionChanged && RecheckChecker->IsUpdateAvailable(RecordIndex))
+		{
+			UE_LOG(LogModUpdateNotifier, Display, TEXT("Update released during this session for %s (%s): %s -> %s"), *ModRecord.FriendlyName, *ModRecord.ModReference, *ModRecord.InstalledVersion.ToString(), *ModRecord.CompatibleVersion.ToString());
+			NewUpdates.Add(ModRecord);
+		}
+	}
+
+	if (RecheckSettings.bDebugLogging)
+	{
+		UE_LOG(LogModUpdateNotifier, Verbose, TEXT("Periodic re-check complete, %d new updates."), NewUpdates.Num());
+	}
+
+	if (NewUpdates.IsEmpty())
+	{
+		return;
+	}
+
+	if (GetGameInstance()->IsDedicatedServerInstance())
+	{
+		WriteServerReport(*RecheckChecker);
+	}
+
+	OnNewUpdatesFound.Broadcast(NewUpdates);
+}
+
+void UMUNUpdateSubsystem::ShowNewUpdatesNotice(const TArray<FMUNModRecord>& NewUpdates)
+{
+	APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController();
+	if (!PlayerController)
+	{
+		return;
+	}
+
+	FString Body = TEXT("Updates were released for your mods while the game was running:\n");
+	for (const FMUNModRecord& ModRecord : NewUpdates)
+	{
+		Body += FString::Printf(TEXT("\n%s: %s -> %s"), *ModRecord.FriendlyName, *ModRecord.InstalledVersion.ToString(), *ModRecord.CompatibleVersion.ToString());
+	}
+
+	const FPopupClosed CloseDelegate;
+	UFGBlueprintFunctionLibrary::AddPopupWithCloseDelegate(PlayerController, FText::FromString("Mod Update Notifier"), FText::FromString(Body), CloseDelegate, PID_OK, nullptr, this, false);
+}
+
+FString UMUNUpdateSubsystem::GetServerReportPath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ModUpdateNotifier"), TEXT("ServerUpdateReport.json"));
+}
@@ -0,0 +1,416 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNVersionCache.h"
+
+#include "ModUpdateNotifier.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace
+{
+	TSharedRef<FJsonObject> WriteVersion(const FVersion& Version)
+	{
+		const TSharedRef<FJsonObject> VersionObj = MakeShared<FJsonObject>();
+		VersionObj->SetNumberField(TEXT("major"), Version.Major);
+		VersionObj->SetNumberField(TEXT("minor"), Version.Minor);
+		VersionObj->SetNumberField(TEXT("patch"), Version.Patch);
+		VersionObj->SetStringField(TEXT("pre_release"), Version.PreRelease);
+		return VersionObj;
+	}
+
+	FVersion ReadVersion(const TSharedPtr<FJsonObject>& VersionObj)
+	{
+		if (!VersionObj.IsValid())
+		{
+			return {0,0,0};
+		}
+
+		FVersion Version = {
+			static_cast<int64>(VersionObj->GetNumberField(TEXT("major"))),
+			static_cast<int64>(VersionObj->GetNumberField(TEXT("minor"))),
+			static_cast<int64>(VersionObj->GetNumberField(TEXT("patch"))),
+		};
+		VersionObj->TryGetStringField(TEXT("pre_release"), Version.PreRelease);
+		return Version;
+	}
+
+	FVersion ReadVersionField(const TSharedPtr<FJsonObject>& Obj, const TCHAR* FieldName)
+	{
+		const TSharedPtr<FJsonObject>* VersionObj = nullptr;
+		return Obj->TryGetObjectField(FieldName, VersionObj) ? ReadVersion(*VersionObj) : FVersion{0,0,0};
+	}
+}
+
+FMUNVersionCache::FMUNVersionCache(const FString& InFilePath)
+	: FilePath(InFilePath)
+{
+}
+
+FMUNVersionCache::~FMUNVersionCache()
+{
+	Flush();
+}
+
+void FMUNVersionCache::LoadAsync(TUniqueFunction<void()>&& OnLoaded)
+{
+	if (bLoaded)
+	{
+		OnLoaded();
+		return;
+	}
+
+	// Checks starting while the file is being read wait for the same read
+	LoadCallbacks.Add(MoveTemp(OnLoaded));
+	if (LoadCallbacks.Num() > 1)
+	{
+		return;
+	}
+
+	TWeakPtr<FMUNVersionCache> WeakThis = AsShared();
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, CacheFilePath = FilePath]()
+	{
+		FContents LoadedContents;
+		ReadFile(CacheFilePath, LoadedContents);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, LoadedContents = MoveTemp(LoadedContents)]() mutable
+		{
+			if (const TSharedPtr<FMUNVersionCache> This = WeakThis.Pin())
+			{
+				This->OnLoaded(MoveTemp(LoadedContents));
+			}
+		});
+	}, UE::Tasks::ETaskPriority::BackgroundLow);
+}
+
+void FMUNVersionCache::OnLoaded(FContents&& LoadedContents)
+{
+	// Every user waits for the load, so nothing has been written to the cache yet
+	Contents = MoveTemp(LoadedContents);
+	bLoaded = true;
+	bDirty = false;
+
+	// Files written before changelogs were bounded may hold any number of them
+	TrimChangelogs();
+
+	TArray<TUniqueFunction<void()>> Callbacks = MoveTemp(LoadCallbacks);
+	for (TUniqueFunction<void()>& Callback : Callbacks)
+	{
+		Callback();
+	}
+}
+
+void FMUNVersionCache::SaveAsync()
+{
+	// Writing before the file has been read would throw away everything in it
+	if (!bDirty || !bLoaded)
+	{
+		return;
+	}
+
+	bDirty = false;
+
+	auto Write = [CacheFilePath = FilePath, Snapshot = Contents]()
+	{
+		WriteFile(CacheFilePath, Snapshot);
+	};
+
+	if (SaveTask.IsValid())
+	{
+		SaveTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, MoveTemp(Write), UE::Tasks::Prerequisites(SaveTask), UE::Tasks::ETaskPriority::BackgroundLow);
+	}
+	else
+	{
+		SaveTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, MoveTemp(Write), UE::Tasks::ETaskPriority::BackgroundLow);
+	}
+}
+
+void FMUNVersionCache::Flush()
+{
+	if (SaveTask.IsValid())
+	{
+		SaveTask.Wait();
+	}
+}
+
+void FMUNVersionCache::ReadFile(const FString& CacheFilePath, FContents& OutContents)
+{
+	FString CacheContents;
+	if (!FFileHelper::LoadFileToString(CacheContents, *CacheFilePath))
+	{
+		return;
+	}
+
+	TSharedPtr<FJsonObject> CacheObj;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(CacheContents);
+	const TSharedPtr<FJsonObject>* ModsObj = nullptr;
+
+	if (!FJsonSerializer::Deserialize(Reader, CacheObj) || !CacheObj.IsValid() || !CacheObj->TryGetObjectField(TEXT("mods"), ModsObj))
+	{
+		UE_LOG(LogModUpdateNotifier, Warning, TEXT("Version cache is corrupt, ignoring it: %s"), *CacheFilePath);
+		return;
+	}
+
+	FString LastCheck;
+	if (CacheObj->TryGetStringField(TEXT("last_successful_check"), LastCheck) && FDateTime::ParseIso8601(*LastCheck, OutContents.LastSuccessfulCheck))
+	{
+		CacheObj->TryGetNumberField(TEXT("last_check_game_version"), OutContents.LastCheckGameVersion);
+	}
+	else
+	{
+		OutContents.LastSuccessfulCheck = FDateTime::MinValue();
+	}
+
+	for (const auto& ModEntry : (*ModsObj)->Values)
+	{
+		const TSharedPtr<FJsonObject> EntryObj = ModEntry.Value->AsObject();
+		if (!EntryObj.IsValid())
+		{
+			continue;
+		}
+
+		FMUNCachedModVersion& Entry = OutContents.Entries.Add(ModEntry.Key);
+		Entry.HighestVersion = ReadVersion(EntryObj);
+
+		const TArray<TSharedPtr<FJsonValue>>* RecentVersions = nullptr;
+		if (EntryObj->TryGetArrayField(TEXT("recent_versions"), RecentVersions))
+		{
+			for (const TSharedPtr<FJsonValue>& RecentVersion : *RecentVersions)
+			{
+				Entry.RecentVersions.Add(ReadVersion(RecentVersion->AsObject()));
+			}
+		}
+
+		EntryObj->TryGetStringField(TEXT("changelog"), Entry.Changelog);
+		EntryObj->TryGetStringField(TEXT("logo"), Entry.LogoURL);
+
+		FString FetchedAt;
+		if (!EntryObj->TryGetStringField(TEXT("fetched_at"), FetchedAt) || !FDateTime::ParseIso8601(*FetchedAt, Entry.FetchedAt))
+		{
+			Entry.FetchedAt = FDateTime::MinValue();
+		}
+	}
+
+	const TSharedPtr<FJsonObject>* ResultsObj = nullptr;
+	const TArray<TSharedPtr<FJsonValue>>* ResultMods = nullptr;
+	FString CheckedAt;
+	if (CacheObj->TryGetObjectField(TEXT("check_results"), ResultsObj) && (*ResultsObj)->TryGetStringField(TEXT("fingerprint"), OutContents.ResultsFingerprint)
+		&& (*ResultsObj)->TryGetStringField(TEXT("checked_at"), CheckedAt) && FDateTime::ParseIso8601(*CheckedAt, OutContents.ResultsCheckedAt)
+		&& (*ResultsObj)->TryGetArrayField(TEXT("mods"), ResultMods))
+	{
+		for (const TSharedPtr<FJsonValue>& ResultMod : *ResultMods)
+		{
+			const TSharedPtr<FJsonObject> ModObj = ResultMod->AsObject();
+			FMUNModRecord ModRecord;
+			if (!ModObj.IsValid() || !ModObj->TryGetStringField(TEXT("mod_reference"), ModRecord.ModReference))
+			{
+				continue;
+			}
+
+			ModObj->TryGetStringField(TEXT("name"), ModRecord.FriendlyName);
+			ModObj->TryGetStringField(TEXT("author"), ModRecord.Author);
+			ModRecord.InstalledVersion = ReadVersionField(ModObj, TEXT("installed_version"));
+			ModRecord.APIVersion = ReadVersionField(ModObj, TEXT("api_version"));
+			ModRecord.CompatibleVersion = ReadVersionField(ModObj, TEXT("compatible_version"));
+			ModRecord.bHasSupportURL = ModObj->TryGetStringField(TEXT("support_url"), ModRecord.SupportURL);
+			ModObj->TryGetStringField(TEXT("logo"), ModRecord.LogoURL);
+
+			bool bLocked = false;
+			ModObj->TryGetBoolField(TEXT("locked"), bLocked);
+			OutContents.CheckResults.SetLocked(OutContents.CheckResults.Add(MoveTemp(ModRecord)), bLocked);
+		}
+	}
+	else
+	{
+		OutContents.ResultsFingerprint.Empty();
+	}
+}
+
+void FMUNVersionCache::WriteFile(const FString& CacheFilePath, const FContents& FileContents)
+{
+	const TSharedRef<FJsonObject> ModsObj = MakeShared<FJsonObject>();
+	for (const auto& ModEntry : FileContents.Entries)
+	{
+		const FMUNCachedModVersion& Entry = ModEntry.Value;
+
+		const TSharedRef<FJsonObject> EntryObj = WriteVersion(Entry.HighestVersion);
+		TArray<TSharedPtr<FJsonValue>> RecentVersions;
+		for (const FVersion& RecentVersion : Entry.RecentVersions)
+		{
+			RecentVersions.Add(MakeShared<FJsonValueObject>(WriteVersion(RecentVersion)));
+		}
+		EntryObj->SetArrayField(TEXT("recent_versions"), RecentVersions);
+		EntryObj->SetStringField(TEXT("changelog"), Entry.Changelog);
+		EntryObj->SetStringField(TEXT("logo"), Entry.LogoURL);
+		EntryObj->SetStringField(TEXT("fetched_at"), Entry.FetchedAt.ToIso8601());
+
+		ModsObj->SetObjectField(ModEntry.Key, EntryObj);
+	}
+
+	const TSharedRef<FJsonObject> CacheObj = MakeShared<FJsonObject>();
+	CacheObj->SetObjectField(TEXT("mods"), ModsObj);
+	if (FileContents.LastSuccessfulCheck > FDateTime::MinValue())
+	{
+		CacheObj->SetStringField(TEXT("last_successful_check"), FileContents.LastSuccessfulCheck.ToIso8601());
+		CacheObj->SetNumberField(TEXT("last_check_game_version"), FileContents.LastCheckGameVersion);
+	}
+
+	if (!FileContents.ResultsFingerprint.IsEmpty())
+	{
+		TArray<TSharedPtr<FJsonValue>> ResultMods;
+		for (int32 RecordIndex = 0; RecordIndex < FileContents.CheckResults.Num(); RecordIndex++)
+		{
+			const FMUNModRecord& ModRecord = FileContents.CheckResults.Records[RecordIndex];
+
+			const TSharedRef<FJsonObject> ModObj = MakeShared<FJsonObject>();
+			ModObj->SetStringField(TEXT("mod_reference"), ModRecord.ModReference);
+			ModObj->SetStringField(TEXT("name"), ModRecord.FriendlyName);
+			ModObj->SetStringField(TEXT("author"), ModRecord.Author);
+			ModObj->SetObjectField(TEXT("installed_version"), WriteVersion(ModRecord.InstalledVersion));
+			ModObj->SetObjectField(TEXT("api_version"), WriteVersion(ModRecord.APIVersion));
+			ModObj->SetObjectField(TEXT("compatible_version"), WriteVersion(ModRecord.CompatibleVersion));
+			if (ModRecord.bHasSupportURL)
+			{
+				ModObj->SetStringField(TEXT("support_url"), ModRecord.SupportURL);
+			}
+			ModObj->SetStringField(TEXT("logo"), ModRecord.LogoURL);
+			ModObj->SetBoolField(TEXT("locked"), FileContents.CheckResults.IsLocked(RecordIndex));
+
+			ResultMods.Add(MakeShared<FJsonValueObject>(ModObj));
+		}
+
+		const TSharedRef<FJsonObject> ResultsObj = MakeShared<FJsonObject>();
+		ResultsObj->SetStringField(TEXT("fingerprint"), FileContents.ResultsFingerprint);
+		ResultsObj->SetStringField(TEXT("checked_at"), FileContents.ResultsCheckedAt.ToIso8601());
+		ResultsObj->SetArrayField(TEXT("mods"), ResultMods);
+		CacheObj->SetObjectField(TEXT("check_results"), ResultsObj);
+	}
+
+	FString CacheContents;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&CacheContents);
+	FJsonSerializer::Serialize(CacheObj, Writer);
+
+	// Write next to the cache file and swap it in, so a crash or a full disk never leaves a half written cache behind
+	const FString TempFilePath = CacheFilePath + TEXT(".tmp");
+	if (!FFileHelper::SaveStringToFile(CacheContents, *TempFilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM)
+		|| !IFileManager::Get().Move(*CacheFilePath, *TempFilePath, true))
+	{
+		UE_LOG(LogModUpdateNotifier, Warning, TEXT("Unable to write version cache: %s"), *CacheFilePath);
+		IFileManager::Get().Delete(*TempFilePath, false, false, true);
+	}
+}
+
+void FMUNVersionCache::UpdateVersion(const FString& ModReference, const TArray<FVersion>& RecentVersions)
+{
+	FMUNCachedModVersion& Entry = Contents.Entries.FindOrAdd(ModReference);
+	Entry.RecentVersions = RecentVersions;
+
+	const FVersion HighestVersion = RecentVersions.IsEmpty() ? FVersion{0,0,0} : RecentVersions[0];
+
+	if (Entry.HighestVersion.Compare(HighestVersion) != 0)
+	{
+		Entry.HighestVersion = HighestVersion;
+		Entry.Changelog.Empty();
+	}
+
+	Entry.FetchedAt = FDateTime::UtcNow();
+	bDirty = true;
+}
+
+void FMUNVersionCache::Touch(const FString& ModReference)
+{
+	if (FMUNCachedModVersion* Entry = Contents.Entries.Find(ModReference))
+	{
+		Entry->FetchedAt = FDateTime::UtcNow();
+		bDirty = true;
+	}
+}
+
+void FMUNVersionCache::UpdateChangelog(const FString& ModReference, const FString& Changelog)
+{
+	if (FMUNCachedModVersion* Entry = Contents.Entries.Find(ModReference))
+	{
+		Entry->Changelog = Changelog;
+		bDirty = true;
+
+		TrimChangelogs();
+	}
+}
+
+void FMUNVersionCache::TrimChangelogs()
+{
+	int64 NumCharacters = 0;
+	TArray<FMUNCachedModVersion*> EntriesWithChangelogs;
+
+	for (auto& Entry : Contents.Entries)
+	{
+		if (!Entry.Value.Changelog.IsEmpty())
+		{
+			NumCharacters += Entry.Value.Changelog.Len();
+			EntriesWithChangelogs.Add(&Entry.Value);
+		}
+	}
+
+	if (NumCharacters <= ChangelogBudgetCharacters)
+	{
+		return;
+	}
+
+	EntriesWithChangelogs.Sort([](const FMUNCachedModVersion& A, const FMUNCachedModVersion& B) { return A.FetchedAt < B.FetchedAt; });
+
+	for (FMUNCachedModVersion* Entry : EntriesWithChangelogs)
+	{
+		if (NumCharacters <= ChangelogBudgetCharacters)
+		{
+			break;
+		}
+
+		NumCharacters -= Entry->Changelog.Len();
+		Entry->Changelog.Empty();
+	}
+
+	bDirty = true;
+}
+
+void FMUNVersionCache::UpdateLogo(const FString& ModReference, const FString& LogoURL)
+{
+	FMUNCachedModVersion& Entry = Contents.Entries.FindOrAdd(ModReference);
+	if (Entry.LogoURL != LogoURL)
+	{
+		Entry.LogoURL = LogoURL;
+		bDirty = true;
+	}
+}
+
+void FMUNVersionCache::SetLastSuccessfulCheck(const FDateTime& CheckTime, const uint32 GameVersion)
+{
+	Contents.LastSuccessfulCheck = CheckTime;
+	Contents.LastCheckGameVersion = GameVersion;
+	bDirty = true;
+}
+
+const FMUNModTable* FMUNVersionCache::FindCheckResults(const FString& InstalledFingerprint, const FTimespan& TimeToLive) const
+{
+	if (Contents.ResultsFingerprint.IsEmpty() || Contents.ResultsFingerprint != InstalledFingerprint || FDateTime::UtcNow() - Contents.ResultsCheckedAt >= TimeToLive)
+	{
+		return nullptr;
+	}
+
+	return &Contents.CheckResults;
+}
+
+void FMUNVersionCache::SetCheckResults(const FString& InstalledFingerprint, const FMUNModTable& ModTable, const FDateTime& CheckedAt)
+{
+	Contents.ResultsFingerprint = InstalledFingerprint;
+	Contents.ResultsCheckedAt = CheckedAt;
+	Contents.CheckResults = ModTable;
+	bDirty = true;
+}
+
+FString FMUNVersionCache::GetCacheFilePath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ModUpdateNotifier"), TEXT("VersionCache.json"));
+}
@@ -0,0 +1,288 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNVersionSnapshot.h"
+
+#include "ModUpdateNotifier.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	// Every field is little-endian and 4-byte aligned, which all platforms the game ships on read natively
+	constexpr uint32 SnapshotMagic = 0x534E554D; // "MUNS"
+	constexpr uint32 SnapshotFormatVersion = 1;
+
+	struct FSnapshotHeader
+	{
+		uint32 Magic;
+		uint32 FormatVersion;
+		int64 GeneratedAtTicks;
+		uint32 NumMods;
+		uint32 NumVersions;
+		uint32 StringsSize;
+		uint32 Reserved;
+	};
+
+	struct FSnapshotMod
+	{
+		uint32 ReferenceOffset;
+		uint32 ReferenceLength;
+		uint32 FirstVersion;
+		uint32 NumVersions;
+	};
+
+	struct FSnapshotVersion
+	{
+		uint32 VersionOffset;
+		uint32 VersionLength;
+		uint32 GameVersionOffset;
+		uint32 GameVersionLength;
+	};
+
+	static_assert(sizeof(FSnapshotHeader) == 32 && sizeof(FSnapshotMod) == 16 && sizeof(FSnapshotVersion) == 16, "Snapshot layout must not depend on the compiler");
+
+	// Byte-wise ordering, the writer sorts by the same rule the reader searches with
+	int32 CompareReferences(const FUtf8StringView A, const FUtf8StringView B)
+	{
+		if (const int32 Result = FMemory::Memcmp(A.GetData(), B.GetData(), FMath::Min(A.Len(), B.Len())))
+		{
+			return Result;
+		}
+		return A.Len() - B.Len();
+	}
+}
+
+FMUNVersionSnapshot::~FMUNVersionSnapshot() = default;
+
+TSharedPtr<FMUNVersionSnapshot> FMUNVersionSnapshot::LoadFromFile(const FString& FilePath)
+{
+	TSharedPtr<FMUNVersionSnapshot> Snapshot = MakeShareable(new FMUNVersionSnapshot());
+
+	Snapshot->MappedHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+	if (Snapshot->MappedHandle.IsValid())
+	{
+		Snapshot->MappedRegion.Reset(Snapshot->MappedHandle->MapRegion());
+	}
+
+	bool bValid;
+	if (Snapshot->MappedRegion.IsValid())
+	{
+		bValid = Snapshot->Initialize(Snapshot->MappedRegion->GetMappedPtr(), Snapshot->MappedRegion->GetMappedSize());
+	}
+	else if (FFileHelper::LoadFileToArray(Snapshot->LoadedData, *FilePath, FILEREAD_Silent))
+	{
+		bValid = Snapshot->Initialize(Snapshot->LoadedData.GetData(), Snapshot->LoadedData.Num());
+	}
+	else
+	{
+		UE_LOG(LogModUpdateNotifier, Warning, TEXT("Version snapshot not found: %s"), *FilePath);
+		return nullptr;
+	}
+
+	if (!bValid)
+	{
+		UE_LOG(LogModUpdateNotifier, Warning, TEXT("Version snapshot is malformed or was written by an incompatible version: %s"), *FilePath);
+		return nullptr;
+	}
+
+	return Snapshot;
+}
+
+TSharedPtr<FMUNVersionSnapshot> FMUNVersionSnapshot::LoadFromMemory(TArray<uint8>&& Data)
+{
+	TSharedPtr<FMUNVersionSnapshot> Snapshot = MakeShareable(new FMUNVersionSnapshot());
+	Snapshot->LoadedData = MoveTemp(Data);
+
+	if (!Snapshot->Initialize(Snapshot->LoadedData.GetData(), Snapshot->LoadedData.Num()))
+	{
+		UE_LOG(LogModUpdateNotifier, Warning, TEXT("Downloaded version snapshot is malformed or was written by an incompatible version."));
+		return nullptr;
+	}
+
+	return Snapshot;
+}
+
+bool FMUNVersionSnapshot::Initialize(const uint8* InData, const int64 InSize)
+{
+	if (InSize < static_cast<int64>(sizeof(FSnapshotHeader)))
+	{
+		return false;
+	}
+
+	const FSnapshotHeader* Header = reinterpret_cast<const FSnapshotHeader*>(InData);
+	if (Header->Magic != SnapshotMagic || Header->FormatVersion != SnapshotFormatVersion)
+	{
+		return false;
+	}
+
+	const int64 ModsOffset = sizeof(FSnapshotHeader);
+	const int64 VersionsOffset = ModsOffset + static_cast<int64>(Header->NumMods) * sizeof(FSnapshotMod);
+	const int64 StringsOffset = VersionsOffset + static_cast<int64>(Header->NumVersions) * sizeof(FSnapshotVersion);
+	if (StringsOffset + Header->StringsSize != InSize)
+	{
+		return false;
+	}
+
+	const auto IsStringInBounds = [Header](const uint32 Offset, const uint32 Length)
+	{
+		return static_cast<uint64>(Offset) + Length <= Header->StringsSize;
+	};
+
+	const FSnapshotMod* Mods = reinterpret_cast<const FSnapshotMod*>(InData + ModsOffset);
+	for (uint32 ModIndex = 0; ModIndex < Header->NumMods; ModIndex++)
+	{
+		const FSnapshotMod& Mod = Mods[ModIndex];
+		if (!IsStringInBounds(Mod.ReferenceOffset, Mod.ReferenceLength) || static_cast<uint64>(Mod.FirstVersion) + Mod.NumVersions > Header->NumVersions)
+		{
+			return false;
+		}
+	}
+
+	const FSnapshotVersion* Versions = reinterpret_cast<const FSnapshotVersion*>(InData + VersionsOffset);
+	for (uint32 VersionIndex = 0; VersionIndex < Header->NumVersions; VersionIndex++)
+	{
+		const FSnapshotVersion& Version = Versions[VersionIndex];
+		if (!IsStringInBounds(Version.VersionOffset, Version.VersionLength) || !IsStringInBounds(Version.GameVersionOffset, Version.GameVersionLength))
+		{
+			return false;
+		}
+	}
+
+	Data = InData;
+	Size = InSize;
+	NumMods = Header->NumMods;
+	GeneratedAt = FDateTime(Header->GeneratedAtTicks);
+	return true;
+}
+
+FUtf8StringView FMUNVersionSnapshot::GetString(const uint32 Offset, const uint32 Length) const
+{
+	const FSnapshotHeader* Header = reinterpret_cast<const FSnapshotHeader*>(Data);
+	const int64 StringsOffset = Size - Header->StringsSize;
+	return FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Data + StringsOffset + Offset), Length);
+}
+
+bool FMUNVersionSnapshot::Find(const FUtf8StringView ModReference, TArray<FMUNVersionEntry>& OutVersions) const
+{
+	const FSnapshotHeader* Header = reinterpret_cast<const FSnapshotHeader*>(Data);
+	const FSnapshotMod* Mods = reinterpret_cast<const FSnapshotMod*>(Data + sizeof(FSnapshotHeader));
+	const FSnapshotVersion* Versions = reinterpret_cast<const FSnapshotVersion*>(Mods + Header->NumMods);
+
+	int32 Low = 0;
+	int32 High = NumMods - 1;
+
+	while (Low <= High)
+	{
+		const int32 Middle = Low + (High - Low) / 2;
+		const FSnapshotMod& Mod = Mods[Middle];
+		const int32 Comparison = CompareReferences(GetString(Mod.ReferenceOffset, Mod.ReferenceLength), ModReference);
+
+		if (Comparison < 0)
+		{
+			Low = Middle + 1;
+		}
+		else if (Comparison > 0)
+		{
+			High = Middle - 1;
+		}
+		else
+		{
+			OutVersions.Reset(Mod.NumVersions);
+			for (uint32 VersionIndex = Mod.FirstVersion; VersionIndex < Mod.FirstVersion + Mod.NumVersions; VersionIndex++)
+			{
+				const FSnapshotVersion& Version = Versions[VersionIndex];
+				OutVersions.Add({GetString(Version.VersionOffset, Version.VersionLength), GetString(Version.GameVersionOffset, Version.GameVersionLength)});
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+FString FMUNVersionSnapshot::GetDefaultPath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ModUpdateNotifier"), TEXT("VersionSnapshot.bin"));
+}
+
+FMUNVersionSnapshotWriter::FStringRef FMUNVersionSnapshotWriter::AddString(const FUtf8StringView String)
+{
+	const FString Key = FMUNVersionsReader::ToString(String);
+	if (const FStringRef* Existing = StringOffsets.Find(Key))
+	{
+		return *Existing;
+	}
+
+	const FStringRef Ref = {static_cast<uint32>(Strings.Num()), static_cast<uint32>(String.Len())};
+	Strings.Append(reinterpret_cast<const uint8*>(String.GetData()), String.Len());
+	StringOffsets.Add(Key, Ref);
+	return Ref;
+}
+
+void FMUNVersionSnapshotWriter::AddMod(const FUtf8StringView ModReference, const TConstArrayView<FMUNVersionEntry> Versions)
+{
+	FPendingMod& Mod = Mods.AddDefaulted_GetRef();
+	Mod.Reference = AddString(ModReference);
+
+	for (const FMUNVersionEntry& Entry : Versions)
+	{
+		Mod.Versions.Add({AddString(Entry.Version), AddString(Entry.GameVersion)});
+	}
+}
+
+bool FMUNVersionSnapshotWriter::Save(const FString& FilePath, const FDateTime& GeneratedAt) const
+{
+	const auto GetReference = [this](const FPendingMod& Mod)
+	{
+		return FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Strings.GetData() + Mod.Reference.Offset), Mod.Reference.Length);
+	};
+
+	TArray<const FPendingMod*> SortedMods;
+	for (const FPendingMod& Mod : Mods)
+	{
+		SortedMods.Add(&Mod);
+	}
+	// Stable, so duplicates stay in the order they were added and the first one is the one kept below
+	SortedMods.StableSort([&GetReference](const FPendingMod& A, const FPendingMod& B) { return CompareReferences(GetReference(A), GetReference(B)) < 0; });
+
+	TArray<FSnapshotMod> ModTable;
+	TArray<FSnapshotVersion> VersionTable;
+
+	for (const FPendingMod* Mod : SortedMods)
+	{
+		// A mod can show up twice if the catalog shifted between pages, the first one is kept
+		if (!ModTable.IsEmpty())
+		{
+			const FSnapshotMod& Previous = ModTable.Last();
+			if (Previous.ReferenceOffset == Mod->Reference.Offset)
+			{
+				continue;
+			}
+		}
+
+		ModTable.Add({Mod->Reference.Offset, Mod->Reference.Length, static_cast<uint32>(VersionTable.Num()), static_cast<uint32>(Mod->Versions.Num())});
+		for (const TPair<FStringRef, FStringRef>& Version : Mod->Versions)
+		{
+			VersionTable.Add({Version.Key.Offset, Version.Key.Length, Version.Value.Offset, Version.Value.Length});
+		}
+	}
+
+	const FSnapshotHeader Header = {SnapshotMagic, SnapshotFormatVersion, GeneratedAt.GetTicks(), static_cast<uint32>(ModTable.Num()), static_cast<uint32>(VersionTable.Num()), static_cast<uint32>(Strings.Num()), 0};
+
+	TArray<uint8> FileData;
+	FileData.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	FileData.Append(reinterpret_cast<const uint8*>(ModTable.GetData()), ModTable.Num() * sizeof(FSnapshotMod));
+	FileData.Append(reinterpret_cast<const uint8*>(VersionTable.GetData()), VersionTable.Num() * sizeof(FSnapshotVersion));
+	FileData.Append(Strings);
+
+	const FString TempPath = FilePath + TEXT(".tmp");
+	if (!FFileHelper::SaveArrayToFile(FileData, *TempPath))
+	{
+		return false;
+	}
+
+	return IFileManager::Get().Move(*FilePath, *TempPath, true);
+}
@@ -0,0 +1,133 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNVersionSnapshotCommandlet.h"
+
+#include "ModUpdateNotifier.h"
+#include "MUNRequestScheduler.h"
+#include "MUNUpdateChecker.h"
+#include "MUNVersionSnapshot.h"
+#include "Http.h"
+#include "Containers/Ticker.h"
+#include "Misc/Parse.h"
+#include "Serialization/JsonSerializer.h"
+
+UMUNVersionSnapshotCommandlet::UMUNVersionSnapshotCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UMUNVersionSnapshotCommandlet::Main(const FString& Params)
+{
+	// Same API base URL and request settings as the in-game check, including the -MUNApiBaseURL= override
+	const FMUNCheckSettings Settings = FMUNCheckSettings::FromConfig(FMUNCheckSettings::LoadConfigFile());
+
+	FString OutputPath = FMUNVersionSnapshot::GetDefaultPath();
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	FString ModList;
+	TArray<FString> ModReferences;
+	if (FParse::Value(*Params, TEXT("Mods="), ModList, false))
+	{
+		ModList.ParseIntoArray(ModReferences, TEXT(","));
+	}
+
+	const TSharedRef<FMUNRequestScheduler> Scheduler = MakeShared<FMUNRequestScheduler>(Settings.RequestSettings);
+	FMUNVersionSnapshotWriter Writer;
+	const FDateTime GeneratedAt = FDateTime::UtcNow();
+
+	// Either the whole catalog page by page until a short page comes back, or the given mods one chunk at a time
+	const bool bWholeCatalog = ModReferences.IsEmpty();
+	int32 Offset = 0;
+
+	while (true)
+	{
+		const TSharedRef<FJsonObject> RequestObj = MakeShared<FJsonObject>();
+
+		if (bWholeCatalog)
+		{
+			RequestObj->SetStringField(TEXT("query"), FString::Printf(TEXT("query SnapshotVersions { getMods(filter: { limit: %d, offset: %d, order_by: created_at, order: asc }) { mods { mod_reference versions(filter: { limit: 100, order_by: created_at, order: desc }) { version game_version } } } }"), SnapshotPageSize, Offset));
+		}
+		else
+		{
+			TArray<TSharedPtr<FJsonValue>> ReferenceValues;
+			for (int32 Index = Offset; Index < FMath::Min(Offset + SnapshotPageSize, ModReferences.Num()); Index++)
+			{
+				ReferenceValues.Add(MakeShared<FJsonValueString>(ModReferences[Index]));
+			}
+
+			const TSharedRef<FJsonObject> VariablesObj = MakeShared<FJsonObject>();
+			VariablesObj->SetArrayField(TEXT("references"), ReferenceValues);
+
+			RequestObj->SetStringField(TEXT("query"), FString::Printf(TEXT("query SnapshotVersions($references: [String!]) { getMods(filter: { references: $references, limit: %d }) { mods { mod_reference versions(filter: { limit: 100, order_by: created_at, order: desc }) { version game_version } } } }"), SnapshotPageSize));
+			RequestObj->SetObjectField(TEXT("variables"), VariablesObj);
+		}
+
+		FString RequestBody;
+		const TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&RequestBody);
+		FJsonSerializer::Serialize(RequestObj, JsonWriter);
+
+		const FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
+		Request->SetURL(Settings.APIBaseURL + "/v2/query");
+		Request->SetContentAsString(RequestBody);
+		Request->SetVerb("POST");
+		Request->SetHeader(TEXT("User-Agent"), "X-UE5-ModUpdateNotifier-Agent");
+		Request->SetHeader("Content-Type", TEXT("application/json"));
+
+		bool bPageComplete = false;
+		bool bPageValid = false;
+		int32 NumModsInPage = 0;
+
+		Scheduler->Enqueue(Request, FHttpRequestCompleteDelegate::CreateLambda([&](FHttpRequestPtr, FHttpResponsePtr Response, const bool bWasSuccessful)
+		{
+			bPageComplete = true;
+
+			if (bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+			{
+				TArray<uint8> Decompressed;
+				bPageValid = FMUNVersionsReader::ReadBatchedVersions(FMUNRequestScheduler::GetContent(Response, Decompressed), [&](const FUtf8StringView ModReference, FUtf8StringView, const TConstArrayView<FMUNVersionEntry> Versions)
+				{
+					Writer.AddMod(ModReference, Versions);
+					NumModsInPage++;
+				});
+			}
+		}), FString::Printf(TEXT("snapshot page at %d"), Offset));
+
+		// There is no game loop in a commandlet, so drive HTTP and the scheduler's retry timers by hand
+		double LastTickTime = FPlatformTime::Seconds();
+		while (!bPageComplete)
+		{
+			FPlatformProcess::Sleep(0.01f);
+
+			const double Now = FPlatformTime::Seconds();
+			FHttpModule::Get().GetHttpManager().Tick(Now - LastTickTime);
+			FTSTicker::GetCoreTicker().Tick(Now - LastTickTime);
+			LastTickTime = Now;
+		}
+
+		if (!bPageValid)
+		{
+			UE_LOG(LogModUpdateNotifier, Error, TEXT("Unable to download versions from %s, the snapshot was not written."), *Settings.APIBaseURL);
+			return 1;
+		}
+
+		Offset += SnapshotPageSize;
+		UE_LOG(LogModUpdateNotifier, Display, TEXT("Downloaded versions of %d mods."), Writer.Num());
+
+		if (bWholeCatalog ? NumModsInPage < SnapshotPageSize : Offset >= ModReferences.Num())
+		{
+			break;
+		}
+	}
+
+	if (!Writer.Save(OutputPath, GeneratedAt))
+	{
+		UE_LOG(LogModUpdateNotifier, Error, TEXT("Unable to write version snapshot: %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogModUpdateNotifier, Display, TEXT("Wrote versions of %d mods to %s"), Writer.Num(), *OutputPath);
+	return 0;
+}
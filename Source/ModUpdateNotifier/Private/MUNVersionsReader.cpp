@@ -0,0 +1,514 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNVersionsReader.h"
+
+namespace
+{
+	// Minimal pull scanner over UTF-8 JSON. Strings are returned as views of the raw bytes, only strings containing escape
+	// sequences are decoded, into DecodedStrings.
+	class FJsonScanner
+	{
+	public:
+		FJsonScanner(const TConstArrayView<uint8> Content, FMUNDecodedStrings& InDecodedStrings)
+			: Current(Content.GetData())
+			, End(Content.GetData() + Content.Num())
+			, DecodedStrings(InDecodedStrings)
+		{
+		}
+
+		bool Consume(const uint8 Character)
+		{
+			SkipWhitespace();
+			if (Current < End && *Current == Character)
+			{
+				++Current;
+				return true;
+			}
+			return false;
+		}
+
+		bool IsNext(const uint8 Character)
+		{
+			SkipWhitespace();
+			return Current < End && *Current == Character;
+		}
+
+		bool ReadString(FUtf8StringView& OutString)
+		{
+			const uint8* Start = nullptr;
+			const uint8* StringEnd = nullptr;
+			bool bHasEscapes = false;
+			if (!ScanString(Start, StringEnd, bHasEscapes))
+			{
+				return false;
+			}
+
+			if (bHasEscapes)
+			{
+				return DecodeString(Start, StringEnd, OutString);
+			}
+
+			OutString = FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Start), static_cast<int32>(StringEnd - Start));
+			return true;
+		}
+
+		// Reads a string value, or skips any other value and leaves OutString empty
+		bool ReadStringOrSkip(FUtf8StringView& OutString)
+		{
+			if (IsNext('"'))
+			{
+				return ReadString(OutString);
+			}
+
+			OutString.Reset();
+			return SkipValue();
+		}
+
+		bool SkipValue()
+		{
+			SkipWhitespace();
+			if (Current >= End)
+			{
+				return false;
+			}
+
+			if (*Current == '"')
+			{
+				return SkipString();
+			}
+
+			if (*Current == '{' || *Current == '[')
+			{
+				// Skip the whole container by depth, only strings need special care since they may contain brackets
+				int32 Depth = 0;
+				while (Current < End)
+				{
+					const uint8 Character = *Current;
+					if (Character == '"')
+					{
+						if (!SkipString())
+						{
+							return false;
+						}
+						continue;
+					}
+
+					++Current;
+					if (Character == '{' || Character == '[')
+					{
+						++Depth;
+					}
+					else if ((Character == '}' || Character == ']') && --Depth == 0)
+					{
+						return true;
+					}
+				}
+				return false;
+			}
+
+			// Numbers, true, false and null
+			const uint8* Start = Current;
+			while (Current < End && *Current != ',' && *Current != '}' && *Current != ']' && !IsWhitespace(*Current))
+			{
+				++Current;
+			}
+			return Current != Start;
+		}
+
+		// Calls Visitor(Key) for every member of an object, the visitor must consume the member's value
+		template <typename VisitorType>
+		bool ForEachMember(VisitorType&& Visitor)
+		{
+			if (!Consume('{'))
+			{
+				return false;
+			}
+			if (Consume('}'))
+			{
+				return true;
+			}
+
+			do
+			{
+				FUtf8StringView Key;
+				if (!ReadString(Key) || !Consume(':') || !Visitor(Key))
+				{
+					return false;
+				}
+			}
+			while (Consume(','));
+
+			return Consume('}');
+		}
+
+		// Calls Visitor() for every element of an array, the visitor must consume the element
+		template <typename VisitorType>
+		bool ForEachElement(VisitorType&& Visitor)
+		{
+			if (!Consume('['))
+			{
+				return false;
+			}
+			if (Consume(']'))
+			{
+				return true;
+			}
+
+			do
+			{
+				if (!Visitor())
+				{
+					return false;
+				}
+			}
+			while (Consume(','));
+
+			return Consume(']');
+		}
+
+	private:
+		// Finds the end of the string starting at the next quote and moves past it. Start and StringEnd exclude the quotes.
+		bool ScanString(const uint8*& OutStart, const uint8*& OutEnd, bool& bOutHasEscapes)
+		{
+			if (!Consume('"'))
+			{
+				return false;
+			}
+
+			OutStart = Current;
+			while (Current < End)
+			{
+				if (*Current == '\\')
+				{
+					// A backslash at the very end is a cut off payload, not an escape
+					if (Current + 1 >= End)
+					{
+						return false;
+					}
+
+					bOutHasEscapes = true;
+					Current += 2;
+					continue;
+				}
+				if (*Current == '"')
+				{
+					OutEnd = Current;
+					++Current;
+					return true;
+				}
+				++Current;
+			}
+			return false;
+		}
+
+		// Strings that are skipped are never decoded
+		bool SkipString()
+		{
+			const uint8* Start = nullptr;
+			const uint8* StringEnd = nullptr;
+			bool bHasEscapes = false;
+			return ScanString(Start, StringEnd, bHasEscapes);
+		}
+
+		// Decodes the escape sequences of a scanned string, returns false if one of them is invalid
+		bool DecodeString(const uint8* Start, const uint8* StringEnd, FUtf8StringView& OutString)
+		{
+			TArray<UTF8CHAR>& Decoded = DecodedStrings.AddDefaulted_GetRef();
+			Decoded.Reserve(static_cast<int32>(StringEnd - Start));
+
+			// ScanString made sure every backslash is followed by another character
+			for (const uint8* Character = Start; Character < StringEnd; ++Character)
+			{
+				if (*Character != '\\')
+				{
+					Decoded.Add(static_cast<UTF8CHAR>(*Character));
+					continue;
+				}
+
+				switch (*++Character)
+				{
+				case '"':
+				case '\\':
+				case '/':
+					Decoded.Add(static_cast<UTF8CHAR>(*Character));
+					break;
+				case 'b':
+					Decoded.Add(static_cast<UTF8CHAR>('\b'));
+					break;
+				case 'f':
+					Decoded.Add(static_cast<UTF8CHAR>('\f'));
+					break;
+				case 'n':
+					Decoded.Add(static_cast<UTF8CHAR>('\n'));
+					break;
+				case 'r':
+					Decoded.Add(static_cast<UTF8CHAR>('\r'));
+					break;
+				case 't':
+					Decoded.Add(static_cast<UTF8CHAR>('\t'));
+					break;
+				case 'u':
+				{
+					uint32 CodePoint = 0;
+					if (!ReadHex4(Character + 1, StringEnd, CodePoint))
+					{
+						return false;
+					}
+					Character += 4;
+
+					// Characters outside the basic multilingual plane are escaped as a surrogate pair, lone halves become U+FFFD
+					uint32 LowSurrogate = 0;
+					if (CodePoint >= 0xD800 && CodePoint < 0xDC00 && Character + 2 < StringEnd && Character[1] == '\\' && Character[2] == 'u'
+						&& ReadHex4(Character + 3, StringEnd, LowSurrogate) && LowSurrogate >= 0xDC00 && LowSurrogate < 0xE000)
+					{
+						CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (LowSurrogate - 0xDC00);
+						Character += 6;
+					}
+					else if (CodePoint >= 0xD800 && CodePoint < 0xE000)
+					{
+						CodePoint = 0xFFFD;
+					}
+
+					AppendUtf8(Decoded, CodePoint);
+					break;
+				}
+				default:
+					return false;
+				}
+			}
+
+			OutString = FUtf8StringView(Decoded.GetData(), Decoded.Num());
+			return true;
+		}
+
+		static bool ReadHex4(const uint8* Digits, const uint8* StringEnd, uint32& OutValue)
+		{
+			if (StringEnd - Digits < 4)
+			{
+				return false;
+			}
+
+			OutValue = 0;
+			for (int32 Index = 0; Index < 4; Index++)
+			{
+				const uint8 Digit = Digits[Index];
+				const uint8 Lower = Digit | 0x20;
+				if (Digit >= '0' && Digit <= '9')
+				{
+					OutValue = (OutValue << 4) | (Digit - '0');
+				}
+				else if (Lower >= 'a' && Lower <= 'f')
+				{
+					OutValue = (OutValue << 4) | (Lower - 'a' + 10);
+				}
+				else
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		static void AppendUtf8(TArray<UTF8CHAR>& Out, const uint32 CodePoint)
+		{
+			if (CodePoint < 0x80)
+			{
+				Out.Add(static_cast<UTF8CHAR>(CodePoint));
+			}
+			else if (CodePoint < 0x800)
+			{
+				Out.Add(static_cast<UTF8CHAR>(0xC0 | (CodePoint >> 6)));
+				Out.Add(static_cast<UTF8CHAR>(0x80 | (CodePoint & 0x3F)));
+			}
+			else if (CodePoint < 0x10000)
+			{
+				Out.Add(static_cast<UTF8CHAR>(0xE0 | (CodePoint >> 12)));
+				Out.Add(static_cast<UTF8CHAR>(0x80 | ((CodePoint >> 6) & 0x3F)));
+				Out.Add(static_cast<UTF8CHAR>(0x80 | (CodePoint & 0x3F)));
+			}
+			else
+			{
+				Out.Add(static_cast<UTF8CHAR>(0xF0 | (CodePoint >> 18)));
+				Out.Add(static_cast<UTF8CHAR>(0x80 | ((CodePoint >> 12) & 0x3F)));
+				Out.Add(static_cast<UTF8CHAR>(0x80 | ((CodePoint >> 6) & 0x3F)));
+				Out.Add(static_cast<UTF8CHAR>(0x80 | (CodePoint & 0x3F)));
+			}
+		}
+
+		static bool IsWhitespace(const uint8 Character)
+		{
+			return Character == ' ' || Character == '\t' || Character == '\r' || Character == '\n';
+		}
+
+		void SkipWhitespace()
+		{
+			while (Current < End && IsWhitespace(*Current))
+			{
+				++Current;
+			}
+		}
+
+		const uint8* Current;
+		const uint8* End;
+		FMUNDecodedStrings& DecodedStrings;
+	};
+
+	template <int32 N>
+	bool IsKey(const FUtf8StringView Key, const ANSICHAR (&Literal)[N])
+	{
+		return Key.Len() == N - 1 && FMemory::Memcmp(Key.GetData(), Literal, N - 1) == 0;
+	}
+
+	// Reads an array of version objects, keeping only "version" and "game_version"
+	bool ReadVersionArray(FJsonScanner& Scanner, TArray<FMUNVersionEntry>& OutVersions)
+	{
+		return Scanner.ForEachElement([&Scanner, &OutVersions]()
+		{
+			FMUNVersionEntry& Entry = OutVersions.AddDefaulted_GetRef();
+			return Scanner.ForEachMember([&Scanner, &Entry](const FUtf8StringView Key)
+			{
+				if (IsKey(Key, "version"))
+				{
+					return Scanner.ReadStringOrSkip(Entry.Version);
+				}
+				if (IsKey(Key, "game_version"))
+				{
+					return Scanner.ReadStringOrSkip(Entry.GameVersion);
+				}
+				return Scanner.SkipValue();
+			});
+		});
+	}
+
+	// Walks { "data": { "getMods": { "mods": [ ... ] } } }, calling ReadMod for every element of "mods".
+	// Fails if the payload is malformed, has no mods array or the query returned errors.
+	bool ReadGetMods(FJsonScanner& Scanner, const TFunctionRef<bool()> ReadMod)
+	{
+		bool bFoundMods = false;
+		bool bHasErrors = false;
+
+		const bool bValid = Scanner.ForEachMember([&](const FUtf8StringView RootKey)
+		{
+			if (IsKey(RootKey, "errors"))
+			{
+				bHasErrors = true;
+				return Scanner.SkipValue();
+			}
+			if (!IsKey(RootKey, "data") || !Scanner.IsNext('{'))
+			{
+				return Scanner.SkipValue();
+			}
+
+			return Scanner.ForEachMember([&](const FUtf8StringView DataKey)
+			{
+				if (!IsKey(DataKey, "getMods") || !Scanner.IsNext('{'))
+				{
+					return Scanner.SkipValue();
+				}
+
+				return Scanner.ForEachMember([&](const FUtf8StringView GetModsKey)
+				{
+					if (!IsKey(GetModsKey, "mods") || !Scanner.IsNext('['))
+					{
+						return Scanner.SkipValue();
+					}
+
+					bFoundMods = true;
+					return Scanner.ForEachElement(ReadMod);
+				});
+			});
+		});
+
+		return bValid && bFoundMods && !bHasErrors;
+	}
+}
+
+bool FMUNVersionsReader::ReadVersionsAll(const TConstArrayView<uint8> Content, TArray<FMUNVersionEntry>& OutVersions, FMUNDecodedStrings& OutDecodedStrings)
+{
+	FJsonScanner Scanner(Content, OutDecodedStrings);
+	bool bFoundData = false;
+
+	const bool bValid = Scanner.ForEachMember([&Scanner, &OutVersions, &bFoundData](const FUtf8StringView Key)
+	{
+		if (IsKey(Key, "data") && Scanner.IsNext('['))
+		{
+			bFoundData = true;
+			return ReadVersionArray(Scanner, OutVersions);
+		}
+		return Scanner.SkipValue();
+	});
+
+	return bValid && bFoundData;
+}
+
+bool FMUNVersionsReader::ReadBatchedVersions(const TConstArrayView<uint8> Content, const TFunctionRef<void(FUtf8StringView ModReference, FUtf8StringView Logo, TConstArrayView<FMUNVersionEntry> Versions)> Visitor)
+{
+	FMUNDecodedStrings DecodedStrings;
+	FJsonScanner Scanner(Content, DecodedStrings);
+
+	// Reused for every mod, so the whole response costs a single growing allocation
+	TArray<FMUNVersionEntry> Versions;
+
+	return ReadGetMods(Scanner, [&Scanner, &Versions, &DecodedStrings, &Visitor]()
+	{
+		FUtf8StringView ModReference;
+		FUtf8StringView Logo;
+		Versions.Reset();
+		DecodedStrings.Reset();
+
+		const bool bValidMod = Scanner.ForEachMember([&Scanner, &Versions, &ModReference, &Logo](const FUtf8StringView Key)
+		{
+			if (IsKey(Key, "mod_reference"))
+			{
+				return Scanner.ReadStringOrSkip(ModReference);
+			}
+			if (IsKey(Key, "logo"))
+			{
+				return Scanner.ReadStringOrSkip(Logo);
+			}
+			if (IsKey(Key, "versions") && Scanner.IsNext('['))
+			{
+				return ReadVersionArray(Scanner, Versions);
+			}
+			return Scanner.SkipValue();
+		});
+
+		if (bValidMod && !ModReference.IsEmpty())
+		{
+			Visitor(ModReference, Logo, Versions);
+		}
+		return bValidMod;
+	});
+}
+
+bool FMUNVersionsReader::ReadLastVersionDates(const TConstArrayView<uint8> Content, const TFunctionRef<void(FUtf8StringView ModReference, FUtf8StringView LastVersionDate)> Visitor)
+{
+	FMUNDecodedStrings DecodedStrings;
+	FJsonScanner Scanner(Content, DecodedStrings);
+
+	return ReadGetMods(Scanner, [&Scanner, &DecodedStrings, &Visitor]()
+	{
+		FUtf8StringView ModReference;
+		FUtf8StringView LastVersionDate;
+		DecodedStrings.Reset();
+
+		const bool bValidMod = Scanner.ForEachMember([&Scanner, &ModReference, &LastVersionDate](const FUtf8StringView Key)
+		{
+			if (IsKey(Key, "mod_reference"))
+			{
+				return Scanner.ReadStringOrSkip(ModReference);
+			}
+			if (IsKey(Key, "last_version_date"))
+			{
+				return Scanner.ReadStringOrSkip(LastVersionDate);
+			}
+			return Scanner.SkipValue();
+		});
+
+		if (bValidMod && !ModReference.IsEmpty())
+		{
+			Visitor(ModReference, LastVersionDate);
+		}
+		return bValidMod;
+	});
+}
@@ -0,0 +1,67 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+
+// What a changelog is rendered for: a rich text block, or a plain text block that would show the markup as is
+enum class EMUNChangelogFormat : uint8
+{
+	RichText,
+	PlainText,
+};
+
+// A changelog converted to rich text markup or plain text, split at line boundaries so it can be shown a chunk at a time
+struct FMUNRenderedChangelog
+{
+	TArray<FString> Chunks;
+	int64 NumBytes = 0; // Memory held by the chunks, counted against the cache budget
+};
+
+// Turns the markdown of SMR changelogs into markup for a rich text block styled with DT_TextDecorators.
+// Headings and **bold** use the Bold style, list markers become bullets, links keep their text and everything else is escaped.
+// Plain text is rendered the same way, without styles or escapes.
+class MODUPDATENOTIFIER_API FMUNChangelogRenderer
+{
+public:
+	// Runs on a worker thread, it only touches its arguments
+	static TSharedRef<const FMUNRenderedChangelog> Render(const FString& Markdown, int32 ChunkCharacters, EMUNChangelogFormat Format = EMUNChangelogFormat::RichText);
+
+private:
+	static void RenderInline(FStringView Line, bool bAllowStyles, EMUNChangelogFormat Format, FString& Out);
+	static void AppendText(FStringView Text, EMUNChangelogFormat Format, FString& Out);
+};
+
+// Rendered changelogs, most recently shown first, evicted once they add up to more than the byte budget.
+// Only used on the game thread.
+class MODUPDATENOTIFIER_API FMUNChangelogCache
+{
+public:
+	FMUNChangelogCache();
+
+	// Evicts right away if the cache is already over the new budget
+	void SetBudget(int64 InBudgetBytes);
+
+	// Marks the changelog as most recently used
+	TSharedPtr<const FMUNRenderedChangelog> Find(const FString& ModReference);
+
+	// A changelog larger than the whole budget is still kept until the next one is added, so it can be shown
+	void Add(const FString& ModReference, const TSharedRef<const FMUNRenderedChangelog>& Changelog);
+
+	void Remove(const FString& ModReference);
+	void Reset();
+
+	int64 GetNumBytes() const { return NumBytes; }
+	int32 Num() const { return Entries.Num(); }
+
+private:
+	// Entries are bounded by bytes, the count limit only has to be out of reach so the LRU never evicts on its own
+	static constexpr int32 MaxEntries = 4096;
+
+	void EvictToBudget(int64 ReservedBytes);
+
+	TLruCache<FString, TSharedPtr<const FMUNRenderedChangelog>> Entries;
+	int64 BudgetBytes = 0;
+	int64 NumBytes = 0;
+};
@@ -0,0 +1,37 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Util/SemVersion.h"
+
+class UModLoadingLibrary;
+struct FModInfo;
+
+// Which installed mods depend on which, and the version range each dependent allows. Built once per check from the
+// plugin metadata of the loaded mods. Ranges are kept parsed, so resolving a version only compares numbers.
+class MODUPDATENOTIFIER_API FMUNDependencyGraph
+{
+public:
+	void Build(const UModLoadingLibrary& ModLoadingLibrary, TConstArrayView<FModInfo> LoadedMods);
+
+	// Records that Dependent only accepts versions of Dependency within Range. Build calls this for every dependency of the
+	// loaded mods, tests and tools use it to describe mods that aren't loaded.
+	void AddDependency(FName Dependency, FName Dependent, const FVersionRange& Range);
+
+	// Finds the newest of Versions, which must be sorted newest first, allowed by the range of every installed mod depending on
+	// ModReference. Returns {0,0,0} if none of them is allowed. OutBlockingDependent is set to a dependent that excluded the newest version.
+	FVersion FindNewestAllowed(FName ModReference, TConstArrayView<FVersion> Versions, FName* OutBlockingDependent = nullptr) const;
+
+	int32 NumEdges() const { return NumDependencyEdges; }
+
+private:
+	struct FEdge
+	{
+		FName Dependent;
+		FVersionRange Range;
+	};
+
+	TMap<FName, TArray<FEdge>> Dependents; // Dependency -> installed mods depending on it
+	int32 NumDependencyEdges = 0;
+};
@@ -0,0 +1,128 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Containers/Ticker.h"
+#include "MUNRequestScheduler.h"
+#include "MUNIconCache.generated.h"
+
+class IImageWrapperModule;
+class UTexture2D;
+
+// Mod logos downscaled to thumbnails and stored as PNG in Saved/ModUpdateNotifier/Icons, named after a hash of the logo URL.
+// The least recently used thumbnails are deleted once the directory grows past its byte budget. Thread safe, only used on workers.
+class MODUPDATENOTIFIER_API FMUNIconDiskCache
+{
+public:
+	FMUNIconDiskCache(const FString& InDirectory, IImageWrapperModule& InImageWrapperModule);
+
+	// Decodes a cached thumbnail into BGRA pixels and marks it as recently used, returns false if there is none
+	bool Load(const FString& LogoURL, TArray<uint8>& OutPixels, int32& OutWidth, int32& OutHeight);
+
+	// Decodes a downloaded logo in any format the engine reads, downscales it so neither side exceeds MaxSize and stores the
+	// thumbnail. Returns false if the logo can't be decoded.
+	bool DecodeAndStore(const FString& LogoURL, TConstArrayView<uint8> Content, int32 MaxSize, TArray<uint8>& OutPixels, int32& OutWidth, int32& OutHeight);
+
+	void SetBudget(int64 InBudgetBytes);
+
+	// Deletes the least recently used thumbnails until the directory fits the budget. Only one trim runs at a time.
+	void Trim();
+
+	static FString GetDefaultDirectory();
+
+private:
+	FString GetThumbnailPath(const FString& LogoURL) const;
+
+	const FString Directory;
+	IImageWrapperModule& ImageWrapperModule;
+
+	std::atomic<int64> BudgetBytes = 0;
+	std::atomic<int64> NumBytes = -1; // Size of the directory, -1 until the first trim has measured it
+	std::atomic<bool> bTrimming = false;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FMUNOnIconLoaded, const FString& /* LogoURL */, UTexture2D* /* Icon */);
+
+// Mod logos of the notification, loaded only for the rows that ask for them. Thumbnails come from the disk cache or SMR,
+// are decoded on workers, and become textures a few per frame, so opening a long list never stalls the game thread.
+// Owned by the update subsystem. Icons no row shows anymore are kept for rows scrolled back into view, the least recently
+// released are dropped past MaxUnusedIcons and loaded from the disk cache again when asked for.
+UCLASS()
+class MODUPDATENOTIFIER_API UMUNIconCache : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	void Initialize();
+
+	void SetDiskBudget(int64 BudgetBytes);
+
+	// Returns true if the icon is known right away: OutIcon is the loaded icon, or null if there is no logo or it couldn't be decoded
+	// before. Logos that failed to download are asked for again.
+	// Otherwise the icon is loaded and OnIconLoaded is broadcast once it is ready, unless every request for it is released first.
+	// Every request of a logo URL has to be released once the row stops showing the icon.
+	bool RequestIcon(const FString& LogoURL, UTexture2D*& OutIcon);
+
+	// The row showing or waiting for the icon scrolled out of view. Icons nobody waits for anymore are skipped unless they are
+	// already loading, loaded icons nobody shows become unused.
+	void ReleaseIcon(const FString& LogoURL);
+
+	void CancelPendingRequests();
+
+	FMUNOnIconLoaded OnIconLoaded; // The icon is null if it couldn't be loaded
+
+protected:
+	virtual void BeginDestroy() override;
+
+private:
+	// Longest side of a thumbnail in pixels, a list row never shows icons larger than this
+	static constexpr int32 IconSize = 64;
+
+	// Icons loaded at the same time, each takes a worker and possibly a request
+	static constexpr int32 MaxConcurrentLoads = 4;
+
+	// Textures created per frame, creating one copies its pixels and sends them to the render thread
+	static constexpr int32 MaxTexturesPerFrame = 4;
+
+	// Loaded icons kept while no row shows them, a thumbnail texture takes 16 KB so this is about a screen of rows to scroll back to
+	static constexpr int32 MaxUnusedIcons = 32;
+
+	struct FDecodedIcon
+	{
+		FString LogoURL;
+		TArray<uint8> Pixels; // BGRA, empty if the icon couldn't be loaded
+		int32 Width = 0;
+		int32 Height = 0;
+	};
+
+	// Starts loading the most recently requested icons until MaxConcurrentLoads are in flight
+	void PumpQueue();
+
+	// Downloads a logo that isn't in the disk cache yet
+	void RequestLogo(const FString& LogoURL);
+	void OnLogoReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, FString LogoURL);
+
+	// Back on the game thread, queues the pixels for texture creation
+	void OnIconDecoded(FDecodedIcon&& DecodedIcon);
+
+	bool CreateTextures(float DeltaTime);
+
+	// Marks a loaded icon as unused and drops the least recently released ones past MaxUnusedIcons
+	void AddUnusedIcon(const FString& LogoURL);
+
+	UPROPERTY()
+	TMap<FString, TObjectPtr<UTexture2D>> Icons; // Loaded icons by logo URL
+
+	TMap<FString, int32> Interest; // Rows showing or waiting for each icon
+	TArray<FString> UnusedIcons; // Loaded icons no row shows, least recently released first
+	TArray<FString> Queue; // Requested icons not loading yet, most recent last
+	TSet<FString> Loading;
+	TSet<FString> FailedIcons; // Couldn't be decoded, not asked for again this session
+	TArray<FDecodedIcon> DecodedIcons; // Waiting for texture creation
+	FTSTicker::FDelegateHandle CreateTexturesHandle;
+
+	TSharedPtr<FMUNIconDiskCache> DiskCache;
+	TSharedPtr<FMUNRequestScheduler> PendingRequests;
+};
@@ -4,9 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "Module/MenuWorldModule.h"
-#include "Util/SemVersion.h"
-#include "Http.h"
 #include "ModUpdateNotifier_ConfigStruct.h"
+#include "MUNChangelogCache.h"
+#include "MUNModRecord.h"
+#include "MUNUpdateChecker.h"
 #include "Blueprint/UserWidget.h"
 #include "MUNMenuModule.generated.h"
 
@@ -38,8 +39,17 @@ struct FAvailableUpdateInfo // Struct containing all info from the arrays for ea
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FString ModAuthor;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FString ModLogoURL; // Empty if the mod has no logo, UMUNUpdateEntryWidget loads it for visible rows
 };
 
+class UMUNUpdateListItem;
+class UMUNUpdateListView;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMUNOnUpdateFound, const FAvailableUpdateInfo&, UpdateInfo);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMUNOnUpdateItemAdded, UMUNUpdateListItem*, ListItem);
+
 UCLASS()
 class MODUPDATENOTIFIER_API UMUNMenuModule : public UMenuWorldModule
 {
@@ -59,68 +69,165 @@ public:
 	int APIIndexRetrieved; // Index of API Versions we've received
 
 	UPROPERTY(BlueprintReadOnly)
-	TArray<FString> InstalledModFriendlyNames; // Human-readable names of installed mods
+	TArray<FAvailableUpdateInfo> AvailableUpdates; // Known versions of installed mods
 
-	UPROPERTY(BlueprintReadOnly)
-	TArray<FString> InstalledMods; // Mods that are installed
+	FModUpdateNotifier_ConfigStruct ModNotifierConfig; // Our global mod configuration structure
 
-	UPROPERTY(BlueprintReadOnly)
-	TArray<FString> InstalledModIDs; // Satisfactory Mod Repository (https://ficsit.app) Mod IDs used in the REST API
+	bool bShowNotifications; // Whether the player has chosen to opt out of receiving notifications
 
-	UPROPERTY(BlueprintReadOnly)
-	TArray<FVersion> InstalledModVersions; // Known versions of installed mods
+	bool bDebugLogging; // Opt-in for debug logging to not spam the log during normal operation
 
-	UPROPERTY(BlueprintReadOnly)
-	TArray<FString> ModChangelogs; // Previously fetched mod changelogs
+	bool bDisableNotifications; // Legacy thingy dont touch
 
-	UPROPERTY(BlueprintReadOnly)
-	TArray<FVersion> APIVersions; // Remote versions of installed mods from the Satisfactory Mod Repository (https://ficsit.app)
+	FMUNCheckSettings CheckSettings; // Settings for the update checker, read from the config
 
-	UPROPERTY(BlueprintReadOnly)
-	TArray<FString> ModAuthors; // Mod Authors
+	float NotificationDeadlineSeconds; // How long to wait for slow responses before showing the notification with the updates found so far
 
-	UPROPERTY(BlueprintReadOnly)
-	TArray<FString> SupportURLs; // Supplied URLs for mod donation platforms. Filled with "none" if no URL is supplied.
+	UPROPERTY(BlueprintAssignable, Category = "Mod Update Notifier")
+	FMUNOnUpdateFound OnUpdateFound; // Broadcast for updates found after the notification has been shown, so the open widget can add them
 
-	UPROPERTY(BlueprintReadOnly)
-	TArray<bool> HasSupportURLs; // Whether a mod has supplied a support URL
+	UPROPERTY(BlueprintAssignable, Category = "Mod Update Notifier")
+	FMUNOnUpdateItemAdded OnUpdateItemAdded; // Same as OnUpdateFound, with the list item to add to a list view
 
-	UPROPERTY(BlueprintReadOnly)
-	TArray<FString> LockedDependencies;
+	UFUNCTION(BlueprintCallable, Category = "Mod Update Notifier", Exec)
+	void CheckForModUpdates(); // Initialize the module in subclasses
 
-	UPROPERTY(BlueprintReadOnly)
-	TArray<FAvailableUpdateInfo> AvailableUpdates; // Known versions of installed mods
+	UFUNCTION(BlueprintCallable, Category = "Mod Update Notifier", Exec)
+	void ModUpdateReport(); // Logs timings of the last update check: request latency, time per phase and the slowest mods
 
-	FModUpdateNotifier_ConfigStruct ModNotifierConfig; // Our global mod configuration structure
+	UFUNCTION(BlueprintCallable, Category = "Mod Update Notifier", Exec)
+	void ModUpdateReportCsv(); // Same as ModUpdateReport, also writing every sample to Saved/ModUpdateNotifier/CheckReport.csv
 
-	bool bShowNotifications; // Whether the player has chosen to opt out of receiving notifications
+	UFUNCTION(BlueprintCallable, Category = "Mod Update Notifier")
+	void GetAvailableUpdates(TArray<FAvailableUpdateInfo>& OutAvailableUpdates) const; // Allows the widget to retrieve update information after it has been created. ONLY CALL THIS FROM Widget_MUN_Notification
 
-	bool bDebugLogging; // Opt-in for debug logging to not spam the log during normal operation
+	UFUNCTION(BlueprintPure, Category = "Mod Update Notifier")
+	int32 GetNumAvailableUpdates() const { return AvailableUpdates.Num(); }
 
-	bool bDisableNotifications; // Legacy thingy dont touch
+	UFUNCTION(BlueprintCallable, Category = "Mod Update Notifier")
+	bool GetAvailableUpdate(int32 Index, FAvailableUpdateInfo& OutUpdateInfo) const; // Retrieves a single update, so widgets only copy the rows they show
 
-	UFUNCTION(BlueprintCallable, Category = "Mod Update Notifier", Exec)
-	void CheckForModUpdates(); // Initialize the module in subclasses
+	UFUNCTION(BlueprintCallable, Category = "Mod Update Notifier")
+	void GetAvailableUpdatesPage(int32 FirstIndex, int32 Count, TArray<FAvailableUpdateInfo>& OutAvailableUpdates) const; // Retrieves up to Count updates starting at FirstIndex
 
 	UFUNCTION(BlueprintCallable, Category = "Mod Update Notifier")
-	void GetAvailableUpdates(TArray<FAvailableUpdateInfo>& OutAvailableUpdates) const; // Allows the widget to retrieve update information after it has been created. ONLY CALL THIS FROM Widget_MUN_Notification
+	TArray<UMUNUpdateListItem*> GetUpdateListItems() const; // One item per available update, to pass to a list view with SetListItems
+
+	UFUNCTION(BlueprintPure, Category = "Mod Update Notifier")
+	int32 GetModCount() const; // Number of mods taking part in update checking
+
+	UFUNCTION(BlueprintCallable, Category = "Mod Update Notifier")
+	bool GetModRecord(int32 Index, FMUNModRecord& OutModRecord) const; // Retrieves a mod by its index in the mod table
+
+	UFUNCTION(BlueprintCallable, Category = "Mod Update Notifier")
+	bool FindModRecord(const FString& ModReference, FMUNModRecord& OutModRecord) const; // Retrieves a mod by its mod reference
 
 	UFUNCTION(BlueprintCallable, Category = "Mod Update Notifier")
 	void GetChangelog(FString ModReference); // Allows the widget to retrieve a specific mod's changelog
 
+	// Allows the widget to retrieve a specific mod's changelog. Widgets not implementing ChangelogChunkReady get it as plain text,
+	// a screen at first and then called again every frame with another screen added until the whole changelog is shown.
 	UFUNCTION(BlueprintCallable, BlueprintImplementableEvent)
-	void ChangelogProcessed(const FString& Changelog); // Allows the widget to retrieve a specific mod's changelog
+	void ChangelogProcessed(const FString& Changelog);
 
-	// Triggered when we receive a response from the Satisfactory Mod Repository (https://api.ficsit.app/v1/) REST API for mod updates
-	void OnResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful);
-
-	// Triggered when we receive a response containing a mod changelog
-	void OnChangelogReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful);
+	// Appends the next part of the changelog passed to ChangelogProcessed, one part per frame. Widgets implementing this
+	// get changelogs as rich text markup a screen at a time.
+	UFUNCTION(BlueprintCallable, BlueprintImplementableEvent)
+	void ChangelogChunkReady(const FString& ChangelogChunk);
 
 protected:
 	virtual void BeginDestroy() override;
 
 private:
-	void CancelPendingRequests();
-	TArray<FHttpRequestPtr> PendingRequests;
+	// Used when the config doesn't specify a notification deadline
+	static constexpr float DefaultNotificationDeadlineSeconds = 3.0f;
+
+	// Used when the config doesn't specify a changelog cache budget
+	static constexpr int32 DefaultChangelogCacheBudgetKB = 4096;
+
+	// Used when the config doesn't specify an icon cache budget, a thumbnail takes a few KB on disk
+	static constexpr int32 DefaultIconCacheBudgetMB = 32;
+
+	// Changelogs fetched ahead of time, the first rows of the notification. Changelogs of the other rows are fetched when the
+	// widget asks for them, so long update lists don't hold every changelog in memory.
+	static constexpr int32 MaxPrefetchedChangelogs = 25;
+
+	// Roughly a screen of changelog, the first chunk is shown right away and the rest follow a chunk per frame
+	static constexpr int32 ChangelogChunkCharacters = 4096;
+
+	// How often to look for the notification widget while its popup waits behind others
+	static constexpr float AttachUpdateListIntervalSeconds = 0.1f;
+
+	// Custom event of Widget_MUN_Notification that shows an update's changelog and support links, takes the index in AvailableUpdates
+	static inline const FName LoadInfoPanelName = TEXT("Load Info Panel");
+
+	// Hands the check over to the headless server path, which never touches the popup or widgets
+	void StartServerCheck();
+
+	// Called by the checker as soon as the remote version of a mod is known, adding it to AvailableUpdates if it is out of date
+	void EvaluateModUpdate(int32 RecordIndex);
+
+	// Called once every mod we've asked for has been retrieved
+	void OnAllVersionsRetrieved();
+
+	// Called when the notification deadline passes before every mod has been retrieved
+	void OnNotificationDeadline();
+
+	// Shows the notification popup if there is anything to show and it isn't open yet
+	void ShowNotification();
+
+	// Replaces the rows the notification widget builds for every update with a UMUNUpdateListView, once the popup has been
+	// created. Popups are queued, so this polls until it is on screen.
+	void AttachUpdateList();
+
+	// Opens the clicked update in the notification's info panel
+	void OnUpdateItemClicked(UObject* Item);
+
+	// Fetches the changelogs of the first MaxPrefetchedChangelogs available updates, so opening one of them in the widget is instant
+	void PrefetchChangelogs();
+
+	// Called by the checker when a changelog has been fetched, or has failed to
+	void OnChangelogFetched(int32 RecordIndex);
+
+	// Converts a changelog to rich text markup or plain text on a worker thread, then caches it and shows it if it is still wanted
+	void RenderChangelog(const FString& ModReference, const FString& Changelog);
+	void OnChangelogRendered(const FString& ModReference, const TSharedRef<const FMUNRenderedChangelog>& Rendered);
+
+	// Shows the first chunk of a rendered changelog and schedules the rest
+	void ShowRenderedChangelog(const TSharedRef<const FMUNRenderedChangelog>& Rendered);
+	void ShowNextChangelogChunk();
+
+	// Stops appending chunks of the previously shown changelog
+	void StopChangelogChunks();
+
+	// Widgets with a rich text block implement ChangelogChunkReady, the others get plain text through ChangelogProcessed
+	bool WantsRenderedChangelogs() const;
+
+	FString DisplayedChangelog; // Mod the widget asked to see the changelog of, shown as soon as it arrives
+
+	TSet<FString> RenderingChangelogs; // Changelogs being rendered on a worker thread, so they aren't rendered twice
+
+	TSharedPtr<const FMUNRenderedChangelog> ShownChangelog; // Changelog whose remaining chunks are still being appended
+	FString ShownChangelogText; // Plain text chunks shown so far, passed to ChangelogProcessed as a whole every frame
+	int32 NextChangelogChunk = 0;
+	FTimerHandle ChangelogChunkHandle;
+
+	TWeakObjectPtr<UWorld> TimerWorld; // World our timers are set in, null once it is destroyed
+
+	FTimerHandle NotificationDeadlineHandle;
+	FTimerHandle AttachUpdateListHandle;
+	bool bNotificationDeadlinePassed = false;
+	bool bNotificationShown = false;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UMUNUpdateListItem>> UpdateListItems; // One per entry in AvailableUpdates, in the same order
+
+	TWeakObjectPtr<UUserWidget> NotificationWidget; // The open notification, null until AttachUpdateList has found it
+	TWeakObjectPtr<UMUNUpdateListView> UpdateListView;
+
+	// Shared by every main menu of the session, bounded by the ChangelogCacheBudgetKB config option
+	FMUNChangelogCache& GetChangelogCache() const;
+
+	UPROPERTY()
+	TObjectPtr<UMUNUpdateChecker> Checker; // This session's menu check, owned by the update subsystem so it outlives this menu. Null until CheckForModUpdates
 };
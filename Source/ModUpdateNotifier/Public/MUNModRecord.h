@@ -0,0 +1,112 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Util/SemVersion.h"
+#include "MUNModRecord.generated.h"
+
+UENUM(BlueprintType)
+enum class EMUNChangelogState : uint8
+{
+	NotFetched,
+	Fetching, // A request for the changelog is in flight, don't send another one
+	Fetched,
+	Failed // The last request failed, asking for the changelog again will retry it
+};
+
+USTRUCT(BlueprintType)
+struct FMUNModRecord // Everything we know about a single installed mod that takes part in update checking
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	FString ModReference; // Mod reference on the Satisfactory Mod Repository (https://ficsit.app)
+
+	UPROPERTY(BlueprintReadOnly)
+	FString FriendlyName; // Human-readable name of the mod
+
+	UPROPERTY(BlueprintReadOnly)
+	FString Author;
+
+	UPROPERTY(BlueprintReadOnly)
+	FVersion InstalledVersion;
+
+	UPROPERTY(BlueprintReadOnly)
+	FVersion APIVersion = {0,0,0}; // Newest remote version for this game version, {0,0,0} until it has been retrieved
+
+	UPROPERTY(BlueprintReadOnly)
+	FVersion CompatibleVersion = {0,0,0}; // Newest remote version allowed by every installed mod depending on this one, the one updates are offered for
+
+	UPROPERTY(BlueprintReadOnly)
+	FString Changelog; // Changelog of CompatibleVersion, only valid once ChangelogState is Fetched
+
+	UPROPERTY(BlueprintReadOnly)
+	EMUNChangelogState ChangelogState = EMUNChangelogState::NotFetched;
+
+	UPROPERTY(BlueprintReadOnly)
+	FString LogoURL; // Logo on SMR, empty if the mod has none or it hasn't been retrieved
+
+	UPROPERTY(BlueprintReadOnly)
+	FString SupportURL = TEXT("none"); // Supplied URL for mod donation platforms, "none" if no URL is supplied
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bHasSupportURL = false;
+};
+
+USTRUCT(BlueprintType)
+struct FMUNModTable // Contiguous table of mod records with constant time lookup by mod reference
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	TArray<FMUNModRecord> Records;
+
+	// Adds a record and indexes it by its mod reference, returns its index
+	int32 Add(FMUNModRecord&& Record)
+	{
+		const int32 RecordIndex = Records.Add(MoveTemp(Record));
+		RecordIndices.Add(FName(*Records[RecordIndex].ModReference), RecordIndex);
+		LockedDependencies.Add(false);
+		return RecordIndex;
+	}
+
+	int32 IndexOf(const FString& ModReference) const
+	{
+		const int32* RecordIndex = RecordIndices.Find(FName(*ModReference, FNAME_Find));
+		return RecordIndex ? *RecordIndex : INDEX_NONE;
+	}
+
+	FMUNModRecord* Find(const FString& ModReference)
+	{
+		const int32 RecordIndex = IndexOf(ModReference);
+		return RecordIndex != INDEX_NONE ? &Records[RecordIndex] : nullptr;
+	}
+
+	const FMUNModRecord* Find(const FString& ModReference) const
+	{
+		const int32 RecordIndex = IndexOf(ModReference);
+		return RecordIndex != INDEX_NONE ? &Records[RecordIndex] : nullptr;
+	}
+
+	// Locked mods have a newer release than CompatibleVersion that another installed mod's dependency range doesn't allow
+	void SetLocked(const int32 RecordIndex, const bool bLocked)
+	{
+		LockedDependencies[RecordIndex] = bLocked;
+	}
+
+	bool IsLocked(const int32 RecordIndex) const { return LockedDependencies[RecordIndex]; }
+
+	int32 Num() const { return Records.Num(); }
+
+	void Reset()
+	{
+		Records.Reset();
+		RecordIndices.Reset();
+		LockedDependencies.Reset();
+	}
+
+private:
+	TMap<FName, int32> RecordIndices; // Interned mod reference to index in Records
+	TBitArray<> LockedDependencies; // One bit per record
+};
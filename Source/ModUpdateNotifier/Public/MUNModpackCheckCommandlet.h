@@ -0,0 +1,53 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Util/SemVersion.h"
+#include "MUNModpackCheckCommandlet.generated.h"
+
+class UMUNUpdateChecker;
+
+// Mods of a single modpack profile, read from a manifest file
+struct FMUNModpackProfile
+{
+	struct FMod
+	{
+		FString ModReference;
+		FVersion InstalledVersion;
+	};
+
+	FString Name; // Taken from the manifest's "name" field, or its file name if there is none
+	FString ManifestPath;
+	TArray<FMod> Mods;
+
+	// Reads a manifest listing mods either as [{ "mod_reference": "...", "version": "..." }] or as { "<reference>": "<version>" }
+	// under "mods". Entries whose version isn't a semantic version are skipped with a warning.
+	static bool LoadFromFile(const FString& ManifestPath, FMUNModpackProfile& OutProfile);
+};
+
+// Checks the mods of many modpack profiles without launching the game for each of them. Every mod is asked for once no
+// matter how many profiles list it, then the profiles are compared against the results in parallel and a report is written
+// for each of them. -Profiles= takes manifest files and directories of them (*.json).
+// Uses the API base URL and request settings of the mod config saved on this machine, -MUNApiBaseURL= overrides the URL.
+// Usage: -run=MUNModpackCheck -Profiles=<paths> [-OutputDir=<path>] [-Format=json|csv|both] [-IncludePreReleases] [-MUNApiBaseURL=<url>]
+UCLASS()
+class MODUPDATENOTIFIER_API UMUNModpackCheckCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMUNModpackCheckCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	static FString GetDefaultOutputDir();
+
+private:
+	// Writes the report of one profile, returns false if a file couldn't be written. Safe to call from worker threads.
+	static bool WriteProfileReport(const FMUNModpackProfile& Profile, const UMUNUpdateChecker& CompletedCheck, const FString& OutputDir, bool bWriteJson, bool bWriteCsv);
+
+	UPROPERTY()
+	TObjectPtr<UMUNUpdateChecker> Checker; // Shared by every profile
+};
@@ -0,0 +1,72 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Http.h"
+
+struct FMUNRequestSettings
+{
+	int32 MaxConcurrentRequests = 8; // Requests allowed in flight at the same time, the rest wait in a queue
+	float TimeoutSeconds = 15.0f; // Time allowed for a single attempt
+	int32 MaxRetries = 3; // Attempts after the first one before a request is reported as failed
+	float BaseBackoffSeconds = 1.0f; // Delay before the first retry, doubled for each further retry
+	float MaxBackoffSeconds = 30.0f;
+	float MinDispatchIntervalSeconds = 0.0f; // Spreads requests out over time instead of sending them in a burst, 0 to dispatch as fast as slots free up
+	bool bRecordReport = true; // Add completed requests to the check report
+};
+
+// Dispatches HTTP requests with a cap on concurrency, per-attempt timeouts and retries with exponential backoff.
+// Every enqueued request completes exactly once, either with its final response or as a failure once all retries are used up.
+class MODUPDATENOTIFIER_API FMUNRequestScheduler : public TSharedFromThis<FMUNRequestScheduler>
+{
+public:
+	explicit FMUNRequestScheduler(const FMUNRequestSettings& InSettings);
+	~FMUNRequestScheduler();
+
+	// Queues a request, it must not be bound or processed by the caller. OnComplete is called on the game thread.
+	// Label names the request in the check report, the URL is used if it is empty.
+	void Enqueue(const FHttpRequestRef& Request, const FHttpRequestCompleteDelegate& OnComplete, const FString& Label = FString());
+
+	// Cancels all queued, in-flight and waiting requests without calling their completion delegates
+	void CancelAll();
+
+	// Returns the body of a response, decompressed if the server gzipped it. Decompressed bytes are kept in Storage,
+	// which must outlive the returned view. Returns an empty view if the body can't be decompressed. Safe to call from any thread.
+	static TConstArrayView<uint8> GetContent(const FHttpResponsePtr& Response, TArray<uint8>& Storage);
+
+	int32 NumInFlight() const { return InFlight.Num(); }
+	int32 NumQueued() const { return Queue.Num() + Waiting.Num(); }
+
+private:
+	// Decompressed responses larger than this are rejected, the size is taken from the gzip trailer which the server controls
+	static constexpr uint32 MaxDecompressedBytes = 64 * 1024 * 1024;
+
+	struct FScheduledRequest
+	{
+		FHttpRequestPtr Request;
+		FHttpRequestCompleteDelegate OnComplete;
+		int32 Attempt = 0;
+		FString Label;
+		double FirstDispatchTime = 0.0; // 0 until the first attempt has been dispatched
+		FTSTicker::FDelegateHandle RetryHandle;
+	};
+
+	void PumpQueue();
+	void ScheduleResume(float Delay);
+	void OnRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, TSharedRef<FScheduledRequest> Scheduled);
+	void ScheduleRetry(const TSharedRef<FScheduledRequest>& Scheduled, float Delay);
+	float GetRetryDelay(int32 Attempt, const FHttpResponsePtr& Response) const;
+	FHttpRequestRef CloneRequest(const FHttpRequestPtr& Source) const;
+
+	FMUNRequestSettings Settings;
+
+	TArray<TSharedRef<FScheduledRequest>> Queue; // Waiting for a free slot
+	TArray<TSharedRef<FScheduledRequest>> InFlight; // Currently being processed
+	TArray<TSharedRef<FScheduledRequest>> Waiting; // Backing off before the next attempt
+
+	double ResumeTime = 0.0; // The server asked us to slow down, don't dispatch anything before this time
+	double LastDispatchTime = 0.0;
+	FTSTicker::FDelegateHandle ResumeHandle;
+};
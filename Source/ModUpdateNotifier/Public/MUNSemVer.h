@@ -0,0 +1,390 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StringView.h"
+#include "Util/SemVersion.h"
+
+namespace MUNSemVerPrivate
+{
+	template <typename CharType>
+	bool IsDigit(const CharType Character) { return Character >= '0' && Character <= '9'; }
+
+	template <typename CharType>
+	bool IsSpace(const CharType Character) { return Character == ' ' || Character == '\t'; }
+
+	// Parses a run of digits starting at Index and advances past it. Fails if there are no digits or the number overflows.
+	template <typename CharType>
+	bool ParseNumber(const TStringView<CharType> Text, int32& Index, uint64& OutNumber)
+	{
+		const int32 Start = Index;
+		uint64 Number = 0;
+
+		while (Index < Text.Len() && IsDigit(Text[Index]))
+		{
+			const uint64 Digit = Text[Index] - '0';
+			if (Number > (MAX_uint64 - Digit) / 10)
+			{
+				return false;
+			}
+			Number = Number * 10 + Digit;
+			++Index;
+		}
+
+		OutNumber = Number;
+		return Index != Start;
+	}
+
+	// Finds the end of the dot-separated identifier starting at Start, and whether it is purely numeric
+	template <typename CharType>
+	int32 FindIdentifierEnd(const TStringView<CharType> Text, const int32 Start, bool& bOutNumeric)
+	{
+		int32 End = Start;
+		bOutNumeric = true;
+		while (End < Text.Len() && Text[End] != '.')
+		{
+			bOutNumeric &= IsDigit(Text[End]);
+			++End;
+		}
+		bOutNumeric &= End > Start;
+		return End;
+	}
+
+	// SemVer 2.0 pre-release precedence. An empty pre-release is a release, which ranks above any of its pre-releases.
+	template <typename LeftCharType, typename RightCharType>
+	int32 ComparePreRelease(const TStringView<LeftCharType> Left, const TStringView<RightCharType> Right)
+	{
+		if (Left.IsEmpty() || Right.IsEmpty())
+		{
+			return Left.IsEmpty() == Right.IsEmpty() ? 0 : (Left.IsEmpty() ? 1 : -1);
+		}
+
+		int32 LeftIndex = 0;
+		int32 RightIndex = 0;
+		while (LeftIndex < Left.Len() && RightIndex < Right.Len())
+		{
+			bool bLeftNumeric;
+			bool bRightNumeric;
+			const int32 LeftEnd = FindIdentifierEnd(Left, LeftIndex, bLeftNumeric);
+			const int32 RightEnd = FindIdentifierEnd(Right, RightIndex, bRightNumeric);
+			const int32 LeftLen = LeftEnd - LeftIndex;
+			const int32 RightLen = RightEnd - RightIndex;
+
+			// Numeric identifiers always rank below alphanumeric ones
+			if (bLeftNumeric != bRightNumeric)
+			{
+				return bLeftNumeric ? -1 : 1;
+			}
+
+			// Numeric identifiers have no leading zeroes, so a longer one is larger
+			if (bLeftNumeric && LeftLen != RightLen)
+			{
+				return LeftLen < RightLen ? -1 : 1;
+			}
+
+			for (int32 Offset = 0; Offset < FMath::Min(LeftLen, RightLen); ++Offset)
+			{
+				const int32 LeftCharacter = static_cast<int32>(Left[LeftIndex + Offset]);
+				const int32 RightCharacter = static_cast<int32>(Right[RightIndex + Offset]);
+				if (LeftCharacter != RightCharacter)
+				{
+					return LeftCharacter < RightCharacter ? -1 : 1;
+				}
+			}
+
+			if (LeftLen != RightLen)
+			{
+				return LeftLen < RightLen ? -1 : 1;
+			}
+
+			LeftIndex = LeftEnd + 1;
+			RightIndex = RightEnd + 1;
+		}
+
+		// Every shared identifier is equal, so the one with more identifiers ranks higher
+		const bool bLeftHasMore = LeftIndex < Left.Len();
+		const bool bRightHasMore = RightIndex < Right.Len();
+		return bLeftHasMore == bRightHasMore ? 0 : (bLeftHasMore ? 1 : -1);
+	}
+}
+
+// Semantic version parsed without allocating, the pre-release tag is a view into the parsed text
+template <typename CharType>
+struct TMUNSemVer
+{
+	uint64 Major = 0;
+	uint64 Minor = 0;
+	uint64 Patch = 0;
+	TStringView<CharType> PreRelease;
+
+	bool IsPreRelease() const { return !PreRelease.IsEmpty(); }
+
+	// Returns a negative number, zero or a positive number if this version ranks below, equal to or above Other
+	template <typename OtherCharType>
+	int32 Compare(const TMUNSemVer<OtherCharType>& Other) const
+	{
+		if (Major != Other.Major)
+		{
+			return Major < Other.Major ? -1 : 1;
+		}
+		if (Minor != Other.Minor)
+		{
+			return Minor < Other.Minor ? -1 : 1;
+		}
+		if (Patch != Other.Patch)
+		{
+			return Patch < Other.Patch ? -1 : 1;
+		}
+		return MUNSemVerPrivate::ComparePreRelease(PreRelease, Other.PreRelease);
+	}
+
+	FVersion ToVersion() const
+	{
+		FVersion Version = {static_cast<int64>(Major), static_cast<int64>(Minor), static_cast<int64>(Patch)};
+		Version.PreRelease = FString(PreRelease.Len(), PreRelease.GetData());
+		return Version;
+	}
+
+	// Parses "1.2.3", "v1.2.3-beta.1+build" and, with OutNumParts, partial versions like "1" or "1.2" used in ranges
+	static bool Parse(const TStringView<CharType> Text, TMUNSemVer& OutVersion, int32* OutNumParts = nullptr)
+	{
+		using namespace MUNSemVerPrivate;
+
+		OutVersion = TMUNSemVer();
+		int32 Index = 0;
+		int32 NumParts = 1;
+
+		if (Index < Text.Len() && (Text[Index] == 'v' || Text[Index] == 'V'))
+		{
+			++Index;
+		}
+
+		if (!ParseNumber(Text, Index, OutVersion.Major))
+		{
+			return false;
+		}
+
+		if (Index < Text.Len() && Text[Index] == '.')
+		{
+			++Index;
+			if (!ParseNumber(Text, Index, OutVersion.Minor))
+			{
+				return false;
+			}
+			NumParts = 2;
+
+			if (Index < Text.Len() && Text[Index] == '.')
+			{
+				++Index;
+				if (!ParseNumber(Text, Index, OutVersion.Patch))
+				{
+					return false;
+				}
+				NumParts = 3;
+			}
+		}
+
+		if (!OutNumParts && NumParts != 3)
+		{
+			return false;
+		}
+
+		if (Index < Text.Len() && Text[Index] == '-')
+		{
+			const int32 Start = ++Index;
+			while (Index < Text.Len() && Text[Index] != '+')
+			{
+				++Index;
+			}
+			OutVersion.PreRelease = Text.Mid(Start, Index - Start);
+
+			if (OutVersion.PreRelease.IsEmpty())
+			{
+				return false;
+			}
+		}
+
+		// Build metadata doesn't take part in precedence
+		if (Index < Text.Len() && Text[Index] == '+')
+		{
+			Index = Text.Len();
+		}
+
+		if (OutNumParts)
+		{
+			*OutNumParts = NumParts;
+		}
+		return Index == Text.Len();
+	}
+};
+
+using FMUNUtf8SemVer = TMUNSemVer<UTF8CHAR>;
+
+// SML style version ranges: "1.2.3", "=1.2.3", ">=1.2.3", ">1.2", "<2.0.0", "<=2", "^1.2.3", "~1.2", "*",
+// several comparators separated by spaces that must all match, and unions of those separated by "||".
+// Ranges are evaluated straight from the text without allocating.
+struct FMUNVersionRange
+{
+	enum class EComparator : uint8
+	{
+		Equal,
+		Greater,
+		GreaterOrEqual,
+		Less,
+		LessOrEqual,
+		Caret, // Compatible with: same major version, or same minor version while the major version is 0
+		Tilde, // Approximately: same minor version if one is given, same major version otherwise
+		Any
+	};
+
+	template <typename RangeCharType, typename VersionCharType>
+	static bool Matches(const TStringView<RangeCharType> Range, const TMUNSemVer<VersionCharType>& Version)
+	{
+		bool bMatches = false;
+		ForEachAlternative(Range, [&Version, &bMatches](const TStringView<RangeCharType> Alternative)
+		{
+			bool bAlternativeMatches = true;
+			const bool bValid = ForEachComparator(Alternative, [&Version, &bAlternativeMatches](const EComparator Comparator, const TMUNSemVer<RangeCharType>& Bound, const int32 NumParts)
+			{
+				bAlternativeMatches &= MatchesComparator(Comparator, Bound, NumParts, Version);
+			});
+
+			bMatches |= bValid && bAlternativeMatches;
+		});
+		return bMatches;
+	}
+
+private:
+	template <typename RangeCharType, typename VisitorType>
+	static void ForEachAlternative(const TStringView<RangeCharType> Range, VisitorType&& Visitor)
+	{
+		int32 Start = 0;
+		for (int32 Index = 0; Index <= Range.Len(); ++Index)
+		{
+			if (Index == Range.Len() || (Range[Index] == '|' && Index + 1 < Range.Len() && Range[Index + 1] == '|'))
+			{
+				Visitor(Range.Mid(Start, Index - Start));
+				Start = Index + 2;
+				++Index;
+			}
+		}
+	}
+
+	// Calls Visitor(Comparator, Bound, NumParts) for every comparator of an alternative, returns false if any of them is malformed
+	template <typename RangeCharType, typename VisitorType>
+	static bool ForEachComparator(const TStringView<RangeCharType> Alternative, VisitorType&& Visitor)
+	{
+		using namespace MUNSemVerPrivate;
+
+		int32 Index = 0;
+		while (true)
+		{
+			while (Index < Alternative.Len() && IsSpace(Alternative[Index]))
+			{
+				++Index;
+			}
+			if (Index == Alternative.Len())
+			{
+				return true;
+			}
+
+			EComparator Comparator = EComparator::Equal;
+			const RangeCharType First = Alternative[Index];
+			const bool bFollowedByEqual = Index + 1 < Alternative.Len() && Alternative[Index + 1] == '=';
+
+			if (First == '>' || First == '<')
+			{
+				Comparator = First == '>' ? (bFollowedByEqual ? EComparator::GreaterOrEqual : EComparator::Greater) : (bFollowedByEqual ? EComparator::LessOrEqual : EComparator::Less);
+				Index += bFollowedByEqual ? 2 : 1;
+			}
+			else if (First == '^' || First == '~' || First == '=')
+			{
+				Comparator = First == '^' ? EComparator::Caret : (First == '~' ? EComparator::Tilde : EComparator::Equal);
+				++Index;
+			}
+
+			// Allow a space between the operator and the version
+			while (Index < Alternative.Len() && IsSpace(Alternative[Index]))
+			{
+				++Index;
+			}
+
+			const int32 Start = Index;
+			while (Index < Alternative.Len() && !IsSpace(Alternative[Index]))
+			{
+				++Index;
+			}
+			const TStringView<RangeCharType> BoundText = Alternative.Mid(Start, Index - Start);
+
+			TMUNSemVer<RangeCharType> Bound;
+			int32 NumParts = 3;
+
+			if (BoundText.Len() == 1 && (BoundText[0] == '*' || BoundText[0] == 'x' || BoundText[0] == 'X'))
+			{
+				Comparator = EComparator::Any;
+			}
+			else if (!TMUNSemVer<RangeCharType>::Parse(BoundText, Bound, &NumParts))
+			{
+				return false;
+			}
+
+			Visitor(Comparator, Bound, NumParts);
+		}
+	}
+
+	template <typename RangeCharType, typename VersionCharType>
+	static bool MatchesComparator(const EComparator Comparator, const TMUNSemVer<RangeCharType>& Bound, const int32 NumParts, const TMUNSemVer<VersionCharType>& Version)
+	{
+		switch (Comparator)
+		{
+		case EComparator::Any:
+			return true;
+		case EComparator::Greater:
+			return Version.Compare(Bound) > 0;
+		case EComparator::GreaterOrEqual:
+			return Version.Compare(Bound) >= 0;
+		case EComparator::Less:
+			return Version.Compare(Bound) < 0;
+		case EComparator::LessOrEqual:
+			return Version.Compare(Bound) <= 0;
+		case EComparator::Equal:
+			// Partial versions match every version that starts with them
+			if (NumParts == 3)
+			{
+				return Version.Compare(Bound) == 0;
+			}
+			return Version.Major == Bound.Major && (NumParts < 2 || Version.Minor == Bound.Minor) && !Version.IsPreRelease();
+		default:
+			break;
+		}
+
+		// ^ and ~ are a lower bound plus an exclusive upper bound. The upper bound carries the lowest possible pre-release
+		// so pre-releases of the next version are excluded as well.
+		static const RangeCharType LowestPreRelease[] = { '0' };
+		TMUNSemVer<RangeCharType> UpperBound;
+		UpperBound.PreRelease = TStringView<RangeCharType>(LowestPreRelease, 1);
+
+		if (Comparator == EComparator::Caret && (Bound.Major > 0 || NumParts == 1))
+		{
+			UpperBound.Major = Bound.Major + 1;
+		}
+		else if ((Comparator == EComparator::Caret && (Bound.Minor > 0 || NumParts == 2)) || (Comparator == EComparator::Tilde && NumParts >= 2))
+		{
+			UpperBound.Major = Bound.Major;
+			UpperBound.Minor = Bound.Minor + 1;
+		}
+		else if (Comparator == EComparator::Caret)
+		{
+			UpperBound.Major = Bound.Major;
+			UpperBound.Minor = Bound.Minor;
+			UpperBound.Patch = Bound.Patch + 1;
+		}
+		else
+		{
+			UpperBound.Major = Bound.Major + 1;
+		}
+
+		return Version.Compare(Bound) >= 0 && Version.Compare(UpperBound) < 0;
+	}
+};
@@ -0,0 +1,147 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_STATS_GROUP(TEXT("ModUpdateNotifier"), STATGROUP_ModUpdateNotifier, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Mod scan"), STAT_MUN_ModScan, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Request dispatch"), STAT_MUN_RequestDispatch, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Parse versions"), STAT_MUN_ParseVersions, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Version selection"), STAT_MUN_VersionSelection, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Parse changelogs"), STAT_MUN_ParseChangelogs, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Render changelogs"), STAT_MUN_RenderChangelogs, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Snapshot lookup"), STAT_MUN_SnapshotLookup, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Popup creation"), STAT_MUN_PopupCreation, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Decode icons"), STAT_MUN_DecodeIcons, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create icon textures"), STAT_MUN_CreateIconTextures, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Requests in flight"), STAT_MUN_RequestsInFlight, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Requests completed"), STAT_MUN_RequestsCompleted, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Requests failed"), STAT_MUN_RequestsFailed, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Request retries"), STAT_MUN_RequestRetries, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_QWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Bytes received"), STAT_MUN_BytesReceived, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Mods retrieved"), STAT_MUN_ModsRetrieved, STATGROUP_ModUpdateNotifier, MODUPDATENOTIFIER_API);
+
+// Marks a phase of the update check in Unreal Insights, the stat system and the check report at once.
+// Name must match one of the STAT_MUN_ cycle stats above.
+#define MUN_SCOPE_PHASE(Name, PhaseName) \
+	TRACE_CPUPROFILER_EVENT_SCOPE(MUN_##Name); \
+	SCOPE_CYCLE_COUNTER(STAT_MUN_##Name); \
+	const FMUNCheckReport::FScopedPhase ANONYMOUS_VARIABLE(MUNPhase_)(PhaseName)
+
+// Marks code the notifier runs on the game thread: tickers, timers, HTTP callbacks and tasks sent back to the game thread.
+// Only the outermost scope counts, so an entry point can be marked without knowing what it calls.
+#define MUN_SCOPE_GAME_THREAD() \
+	const FMUNCheckReport::FScopedGameThreadWork ANONYMOUS_VARIABLE(MUNGameThreadWork_)
+
+// Timings of the most recent update check, so slow main menus can be diagnosed from a console command.
+// Filled from the game thread and from the parsing workers, every method is thread safe.
+class MODUPDATENOTIFIER_API FMUNCheckReport
+{
+public:
+	static FMUNCheckReport& Get();
+
+	// Discards the previous check and starts timing a new one
+	void Reset();
+
+	// Phases that run more than once, like parsing a response, add up
+	void RecordPhase(const TCHAR* PhaseName, double Seconds);
+
+	// Called once a request has completed for good. Latency covers every attempt, starting from the first dispatch.
+	void RecordRequest(const FString& Label, double LatencySeconds, int64 BytesReceived, int32 Attempts, bool bSucceeded);
+
+	// Called for every gzipped response once it has been decompressed
+	void RecordDecompression(int64 CompressedBytes, int64 DecompressedBytes);
+
+	// Called when the remote version of a mod is known, from the network or from the cache
+	void RecordModRetrieved(const FString& ModReference, bool bFromCache);
+
+	void RecordNotificationShown();
+
+	// Called at the end of the outermost MUN_SCOPE_GAME_THREAD, adding to the total and to the current frame
+	void RecordGameThreadWork(double Seconds);
+
+	// Writes the summary to the log: totals, p50/p95 request latency and size, time spent per phase and the slowest mods
+	void LogSummary() const;
+
+	// Writes every sample to a CSV file, returns false if it couldn't be written
+	bool WriteCsv(const FString& FilePath) const;
+
+	// Totals of the requests recorded so far, for benchmarks and tests
+	int32 GetNumRequests() const;
+	int64 GetBytesReceived() const;
+	int32 GetNumModsRetrieved() const;
+
+	// 0 if the notification hasn't been shown
+	double GetSecondsToNotification() const;
+
+	// Time spent in MUN_SCOPE_GAME_THREAD scopes, in total and in the frame that spent the most
+	double GetGameThreadSeconds() const;
+	double GetLongestGameThreadFrameSeconds() const;
+
+	static FString GetDefaultCsvPath();
+
+	struct FScopedPhase
+	{
+		explicit FScopedPhase(const TCHAR* InPhaseName) : PhaseName(InPhaseName), StartTime(FPlatformTime::Seconds()) {}
+		~FScopedPhase() { Get().RecordPhase(PhaseName, FPlatformTime::Seconds() - StartTime); }
+
+	private:
+		const TCHAR* PhaseName;
+		double StartTime;
+	};
+
+	struct MODUPDATENOTIFIER_API FScopedGameThreadWork
+	{
+		FScopedGameThreadWork();
+		~FScopedGameThreadWork();
+
+	private:
+		double StartTime = 0.0; // Only set for the outermost scope
+	};
+
+private:
+	struct FRequestSample
+	{
+		FString Label;
+		double LatencySeconds = 0.0;
+		int64 BytesReceived = 0;
+		int32 Attempts = 0;
+		bool bSucceeded = false;
+	};
+
+	struct FModSample
+	{
+		FString ModReference;
+		double SecondsSinceStart = 0.0; // Time from the start of the check until the remote version was known
+		bool bFromCache = false;
+	};
+
+	struct FPhaseTotal
+	{
+		double Seconds = 0.0;
+		int32 Count = 0;
+	};
+
+	mutable FCriticalSection Lock;
+
+	TArray<FRequestSample> Requests;
+	TArray<FModSample> Mods;
+	TMap<FString, FPhaseTotal> Phases; // In order of first occurrence
+
+	int32 NumDecompressed = 0;
+	int64 CompressedBytes = 0; // Wire size of the gzipped responses
+	int64 DecompressedBytes = 0; // Their size after decompression
+
+	double CheckStartTime = 0.0;
+	double NotificationShownTime = 0.0; // 0 if the notification hasn't been shown
+
+	double GameThreadSeconds = 0.0;
+	double GameThreadFrameSeconds = 0.0; // Spent in GameThreadFrame so far
+	double LongestGameThreadFrameSeconds = 0.0;
+	uint64 GameThreadFrame = 0;
+};
@@ -0,0 +1,279 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Util/SemVersion.h"
+#include "Http.h"
+#include "Containers/Ticker.h"
+#include "ModLoading/ModLoadingLibrary.h"
+#include "ModUpdateNotifier_ConfigStruct.h"
+#include "MUNDependencyGraph.h"
+#include "MUNVersionCache.h"
+#include "MUNRequestScheduler.h"
+#include "MUNVersionsReader.h"
+#include "MUNVersionSnapshot.h"
+#include "MUNModRecord.h"
+#include "MUNSemVer.h"
+#include "MUNUpdateChecker.generated.h"
+
+class UWorldModuleManager;
+
+struct FMUNCheckSettings
+{
+	FString APIBaseURL; // Base URL of the Satisfactory Mod Repository API, without a trailing slash
+	FTimespan VersionCacheTTL; // How long a cached version is trusted before it is confirmed with the API again
+	FMUNRequestSettings RequestSettings;
+	bool bIncludePreReleases = false; // Offer pre-release versions (e.g. 1.2.0-beta.1) as updates
+	bool bDebugLogging = false;
+	float RecheckIntervalSeconds = 0.0f; // How often to check again during a long session, 0 if periodic re-checks are disabled
+	FString VersionSnapshot; // Path or http(s) URL of a version snapshot to read versions from before asking the API, empty to always ask the API
+	bool bRecordBaseline = true; // Let a check without failures be the baseline of the next launch's updated mods query, only for checks of the installed mods
+	bool bRecordReport = false; // Start the check report over and fill it with this check's requests and mods. Only the menu check does, so the report describes the check behind the notification.
+
+	// Reads the settings from the mod config, falling back to defaults for anything left unset.
+	// The API base URL and version snapshot can also be given on the command line (-MUNApiBaseURL=, -MUNVersionSnapshot=), which take precedence.
+	static FMUNCheckSettings FromConfig(const FModUpdateNotifier_ConfigStruct& Config);
+
+	// Reads the mod config straight from the file the config manager saves it to, for commandlets, which run without the
+	// game instance the config manager lives in. Options missing from the file, or all of them if there is none, keep their defaults.
+	static FModUpdateNotifier_ConfigStruct LoadConfigFile();
+
+	// The config screen only lists the notification toggles, the other options of the config struct are never filled by the
+	// config manager. They are read from the [ModUpdateNotifier] section of Game.ini instead, e.g. bPeriodicRecheck=True,
+	// and options missing from it keep the value they have.
+	static void ReadIniOptions(FModUpdateNotifier_ConfigStruct& Config);
+
+	static constexpr const TCHAR* IniSection = TEXT("ModUpdateNotifier");
+
+	// Used when neither the config nor the command line specify an API base URL
+	static constexpr const TCHAR* DefaultAPIBaseURL = TEXT("https://api.ficsit.app");
+
+	// Used when the config doesn't specify a cache lifetime
+	static constexpr int32 DefaultVersionCacheTTLMinutes = 60;
+
+	// Used when periodic re-checks are enabled without an interval
+	static constexpr int32 DefaultRecheckIntervalMinutes = 360;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FMUNOnModChecked, int32 /* RecordIndex */);
+DECLARE_MULTICAST_DELEGATE(FMUNOnCheckComplete);
+DECLARE_MULTICAST_DELEGATE_OneParam(FMUNOnChangelogFetched, int32 /* RecordIndex */);
+
+// Finds the installed mods and retrieves their newest compatible versions from SMR, without any UI.
+// Shared by the main menu notification and the headless server check, everything runs on the game thread
+// except response parsing, which happens on background workers.
+UCLASS()
+class MODUPDATENOTIFIER_API UMUNUpdateChecker : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// The version cache may be shared with other checks of the session, it is only read from disk once
+	void Initialize(const FMUNCheckSettings& InSettings, const TSharedRef<FMUNVersionCache>& InVersionCache);
+
+	// Builds the mod table and sends the version requests. The scan is spread over several frames, mods found so far are
+	// resolved from the snapshot or the cache right away and full version batches are sent while it runs, the rest of the
+	// requests go out once it ends. WorldModuleManager may be null, in which case opt-outs and support URLs
+	// declared by mod world modules are not read.
+	// The version cache is read on a worker first. If the installed mods haven't changed since the last check and its results
+	// are still fresh, they are reused and the check completes as soon as it has been read, without scanning or sending any requests.
+	void StartCheck(UModLoadingLibrary* ModLoadingLibrary, UWorldModuleManager* WorldModuleManager);
+
+	// Checks a known set of mods again without scanning, remote versions and changelogs of the given records are discarded.
+	// KnownFingerprint is the installed fingerprint of the check the mods came from, the results are stored for it.
+	// KnownDependencies is the dependency graph of that check, used to resolve the versions the mods are allowed to update to.
+	void StartCheck(FMUNModTable KnownMods, const FString& KnownFingerprint = FString(), const FMUNDependencyGraph& KnownDependencies = FMUNDependencyGraph());
+
+	// Sends chunked GraphQL queries for the changelogs of the remote versions of the given mods. Mods already fetched or being fetched are skipped.
+	void RequestChangelogs(const TArray<FString>& ModReferences);
+
+	// Cancels every request without calling back, results received so far are kept
+	void CancelPendingRequests();
+
+	// True if the newest remote version allowed by the mods depending on it is newer than the installed one
+	bool IsUpdateAvailable(int32 RecordIndex) const;
+
+	// Same comparison for an installed version other than the record's, such as the one listed in a modpack profile
+	static bool IsUpdateAvailable(const FMUNModRecord& ModRecord, const FVersion& InstalledVersion);
+
+	const FMUNModTable& GetModTable() const { return ModTable; }
+	const FMUNCheckSettings& GetSettings() const { return Settings; }
+	const FString& GetInstalledFingerprint() const { return InstalledFingerprint; }
+	const FMUNDependencyGraph& GetDependencyGraph() const { return DependencyGraph; }
+
+	// Mods already broadcast through OnModChecked, in order, so listeners attaching to a check in progress can catch up
+	const TArray<int32>& GetCheckedMods() const { return CheckedMods; }
+
+	int32 GetNumRequested() const { return NumRequested; }
+	int32 GetNumRetrieved() const { return NumRetrieved; }
+	bool HasStarted() const { return bStarted; }
+	bool IsComplete() const { return bStarted && bScanComplete && NumRetrieved == NumRequested; }
+
+	FMUNOnModChecked OnModChecked; // Broadcast once per mod as soon as its remote version is known
+	FMUNOnCheckComplete OnCheckComplete; // Broadcast once every mod has been checked
+	FMUNOnChangelogFetched OnChangelogFetched; // Broadcast when a changelog has been fetched or has failed to
+
+protected:
+	virtual void BeginDestroy() override;
+
+private:
+	// Number of mods asked for in a single GraphQL version query
+	static constexpr int32 VersionQueryBatchSize = 50;
+
+	// Newest versions asked for per mod. The newest compatible version is almost always among them, mods where
+	// it isn't are asked for again with the wide window.
+	static constexpr int32 VersionWindowSize = 10;
+	static constexpr int32 WideVersionWindowSize = 100;
+
+	// Number of changelogs asked for in a single GraphQL query, changelogs can be large so this is lower than for versions
+	static constexpr int32 ChangelogQueryBatchSize = 25;
+
+	// Changelogs longer than this are cut off at a line break, a few mods ship their whole history as the changelog
+	static constexpr int32 MaxChangelogCharacters = 32 * 1024;
+
+	// Number of mods per page of the updated mods query, a full page of updated mods means the next page is needed too
+	static constexpr int32 DeltaQueryPageSize = 50;
+
+	// Compatible versions remembered per mod for resolving dependency ranges, newest first
+	static constexpr int32 MaxRecentVersions = VersionWindowSize;
+
+	// Time the mod scan may take per frame
+	static constexpr double ScanBudgetSeconds = 0.002;
+
+	// Loads the version snapshot if one is configured, then begins dispatching
+	void BeginCheck();
+
+	// Starts the scan if mods are still to be discovered, otherwise sends the version requests for the whole mod table
+	void BeginDispatch();
+
+	// Hashes the installed mods (reference, version, dependency ranges) together with the settings that affect the results
+	FString ComputeInstalledFingerprint(UModLoadingLibrary* ModLoadingLibrary, const TArray<FModInfo>& LoadedMods) const;
+
+	// Takes the mod table from the results of the last check if they were made for the same fingerprint and are still fresh.
+	// Only called once the version cache has been read.
+	bool RestoreCheckResults();
+
+	// Scans installed mods until the frame's budget is used up and dispatches the ones found, returns true while mods remain
+	bool ScanNextMods(float DeltaTime);
+
+	// Adds an installed mod to the mod table unless it opted out, returns true if it was added
+	bool ScanMod(const FModInfo& ModInfo, UModLoadingLibrary* ModLoadingLibrary, UWorldModuleManager* WorldModuleManager);
+
+	// Completes the check if every mod found by the scan has already been retrieved
+	void FinishScan();
+
+	// Resolves the given mods from the version snapshot or the version cache where possible and queues requests for the rest.
+	// While the scan runs only full version batches are sent, the remaining requests wait for FlushVersionRequests.
+	void DispatchVersionRequests(const TArray<FString>& ModReferences);
+
+	// Sends the updated mods query for every queued stale mod and the version queries for every queued uncached mod
+	void FlushVersionRequests();
+
+	// Downloads the version snapshot from a mirror, then dispatches the version requests
+	void RequestVersionSnapshot();
+
+	// Triggered when we receive the version snapshot from a mirror
+	void OnVersionSnapshotReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful);
+
+	// Stores the cached version and changelog of a mod as its remote version
+	void RetrieveFromCache(const FString& ModReference);
+
+	// Asks SMR which of the given mods have had a release since the last successful check, newest first, one page at a time
+	void RequestUpdatedMods(const TArray<FString>& ModReferences, const FDateTime& Since, const int32 Offset);
+
+	// Triggered when we receive a page of the updated mods query
+	void OnUpdatedModsReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful, TArray<FString> ModReferences, FDateTime Since, int32 Offset);
+
+	// Picks the mods released after Since out of a page of the updated mods query. Runs on a worker thread.
+	static bool ParseUpdatedMods(const TConstArrayView<uint8> Content, const FDateTime& Since, TArray<FString>& OutChangedMods, bool& bOutReachedOlderMods);
+
+	// Back on the game thread, fetches the versions of updated mods and resolves the rest from the cache once the last page is in
+	void OnUpdatedModsParsed(const bool bValid, TArray<FString> ModReferences, const FDateTime& Since, const int32 Offset, TArray<FString> ChangedMods, const bool bReachedOlderMods);
+
+	// Sends chunked GraphQL queries to the Satisfactory Mod Repository (https://api.ficsit.app/v2/query) for the versions of many mods at once
+	// Only the newest VersionWindow versions of each mod are asked for.
+	void RequestModVersionsBatched(const TArray<FString>& ModReferences, const int32 VersionWindow = VersionWindowSize);
+
+	// Sends a REST request for the newest versions of a single mod, or for all of them if bFullHistory is set.
+	// Used as a fallback if a batched query fails and to widen mods whose recent versions weren't enough.
+	void RequestModVersions(const FString& ModReference, const bool bFullHistory = false);
+
+	// Triggered when we receive a response to a batched version query
+	void OnBatchedVersionsReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful, TArray<FString> ModReferences, int32 VersionWindow);
+
+	// Parses a batched version query and selects the recent compatible versions of every mod in it. Mods with a full window and no
+	// compatible version in it are left out and listed in OutNeedWiderWindow instead. Runs on a worker thread.
+	static bool ParseBatchedVersions(const TConstArrayView<uint8> Content, const int32 VersionWindow, TMap<FString, TArray<FVersion>>& OutRecentVersions, TMap<FString, FString>& OutLogos, TArray<FString>& OutNeedWiderWindow, const bool bIncludePreReleases, const bool bLogVerbose);
+
+	// Back on the game thread, stores the results of a batched query or falls back to per-mod requests if it was invalid
+	void OnBatchedVersionsParsed(const bool bValid, TArray<FString> ModReferences, TMap<FString, TArray<FVersion>> RecentVersions, TMap<FString, FString> Logos, TArray<FString> NeedWiderWindow);
+
+	// Triggered when we receive a response from the Satisfactory Mod Repository (https://api.ficsit.app/v1/) REST API for mod updates
+	void OnResponseReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful, FString ModReference, bool bFullHistory);
+
+	// Parses a versions REST response and selects up to MaxVersions recent compatible versions in it. Runs on a worker thread.
+	static TOptional<TArray<FVersion>> ParseModVersions(const TConstArrayView<uint8> Content, int32& OutNumVersions, const int32 MaxVersions, const bool bIncludePreReleases, const bool bLogVerbose);
+
+	// Back on the game thread, stores the result of a versions REST response or asks for the full history if the newest versions weren't enough
+	void OnModVersionsParsed(const FString& ModReference, const TOptional<TArray<FVersion>>& RecentVersions, const bool bNeedsFullHistory);
+
+	// Finds the versions in a list of SMR versions that support the current game version, skipping pre-releases unless they are included.
+	// Returns up to MaxVersions of them, newest first.
+	static TArray<FVersion> SelectRecentVersions(const TConstArrayView<FMUNVersionEntry> Versions, const bool bIncludePreReleases, const bool bLogVerbose, const int32 MaxVersions = MaxRecentVersions);
+
+	// Stores the remote versions of a mod, resolves the newest one its dependents allow and lets listeners evaluate it straight away.
+	// If none of a full window of recent versions is allowed, asks for the mod's full history instead, once per check.
+	void OnModVersionRetrieved(const FString& ModReference, const TArray<FVersion>& RecentVersions, bool bFromCache = false);
+
+	// Records the mod as checked and tells listeners
+	void BroadcastModChecked(int32 RecordIndex);
+
+	// Saves the version cache and broadcasts OnCheckComplete once the scan is done and every mod has been retrieved
+	void BroadcastIfComplete();
+
+	// Triggered when we receive a response containing a batch of mod changelogs
+	void OnChangelogsReceived(FHttpRequestPtr Request, FHttpResponsePtr Response, const bool bWasSuccessful, TArray<FString> ModReferences);
+
+	// Parses a batched changelog query into mod reference -> changelog, cutting off overly long ones. Runs on a worker thread.
+	static bool ParseChangelogs(const FString& Content, TMap<FString, FString>& OutChangelogs);
+
+	// Back on the game thread, stores the changelogs of a batched query
+	void OnChangelogsParsed(const bool bValid, const TArray<FString>& ModReferences, const TMap<FString, FString>& Changelogs);
+
+	FMUNCheckSettings Settings;
+
+	UPROPERTY()
+	FMUNModTable ModTable; // One record per installed mod that takes part in update checking
+
+	int32 NumRequested = 0; // Mods we've asked for
+	int32 NumRetrieved = 0; // Mods whose remote version is known
+	bool bStarted = false;
+	bool bCancelled = false; // A check cancelled while the version cache is being read never begins
+	bool bCompleteBroadcast = false; // OnCheckComplete fires once per check, however the last mod was retrieved
+	FString InstalledFingerprint; // Empty if the results of this check shouldn't be stored
+
+	TArray<FModInfo> PendingScanMods; // Installed mods, scanned a slice per frame
+	int32 ScanIndex = 0; // Next mod in PendingScanMods to scan
+	TArray<FString> PendingUncachedMods; // Found by the scan, waiting for a full version batch or the end of the scan
+	TArray<FString> PendingStaleMods; // Found by the scan, asked for in a single updated mods query once the scan ends
+	TWeakObjectPtr<UModLoadingLibrary> ScanModLoadingLibrary;
+	TWeakObjectPtr<UWorldModuleManager> ScanWorldModuleManager;
+	TArray<int32> CheckedMods; // Mods broadcast through OnModChecked so far
+	bool bScanComplete = true;
+	FTSTicker::FDelegateHandle ScanTickHandle;
+
+	FDateTime OldestConfirmation; // Oldest point in time at which the remote versions used by this check were known to be current
+	bool bHadFailures = false; // Set if any mod couldn't be confirmed with the API, such a check isn't stored as a baseline
+	TSet<FString> WidenedMods; // Mods whose full history was asked for because no recent version satisfied every dependent
+	TSet<FString> DeltaChangedMods; // Stale mods the updated mods query reported as released since the last check
+
+	FMUNDependencyGraph DependencyGraph; // Built from every loaded mod when the check starts, before the scan
+
+	TSharedPtr<FMUNRequestScheduler> PendingRequests; // Limits how many requests are in flight and retries failed ones
+
+	TSharedPtr<FMUNVersionCache> VersionCache; // Remote versions and changelogs remembered from previous launches
+
+	TSharedPtr<FMUNVersionSnapshot> VersionSnapshot; // Null unless a snapshot is configured and could be loaded
+};
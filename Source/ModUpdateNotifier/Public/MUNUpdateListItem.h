@@ -0,0 +1,118 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Blueprint/IUserObjectListEntry.h"
+#include "Blueprint/UserWidget.h"
+#include "Components/ListView.h"
+#include "MUNMenuModule.h"
+#include "MUNUpdateListItem.generated.h"
+
+class UImage;
+class UMUNIconCache;
+class UTextBlock;
+class UTexture2D;
+
+// One row of the notification's update list. Only holds its index, the update info stays in the menu module
+// and is read when the row becomes visible, so hundreds of updates don't mean hundreds of copied strings.
+UCLASS(BlueprintType)
+class MODUPDATENOTIFIER_API UMUNUpdateListItem : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	void Initialize(UMUNMenuModule* InMenuModule, const int32 InUpdateIndex)
+	{
+		MenuModule = InMenuModule;
+		UpdateIndex = InUpdateIndex;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "Mod Update Notifier")
+	bool GetUpdateInfo(FAvailableUpdateInfo& OutUpdateInfo) const; // Current info of the update, including its changelog once fetched
+
+	UFUNCTION(BlueprintPure, Category = "Mod Update Notifier")
+	int32 GetUpdateIndex() const { return UpdateIndex; }
+
+private:
+	TWeakObjectPtr<UMUNMenuModule> MenuModule;
+	int32 UpdateIndex = INDEX_NONE; // Index in the menu module's AvailableUpdates
+};
+
+// Base class for entry widgets of a list view showing UMUNUpdateListItem. The list view only creates entries for
+// visible rows and recycles them while scrolling, OnUpdateInfoSet is called every time an entry is given a new row.
+// The mod's logo is only loaded while its row is visible and arrives through OnIconSet.
+UCLASS(Abstract)
+class MODUPDATENOTIFIER_API UMUNUpdateEntryWidget : public UUserWidget, public IUserObjectListEntry
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void NativeOnListItemObjectSet(UObject* ListItemObject) override;
+	virtual void NativeOnEntryReleased() override;
+	virtual void NativeDestruct() override;
+
+	// Calls OnUpdateInfoSet, native entries override it to fill their widgets
+	virtual void NativeOnUpdateInfoSet(const FAvailableUpdateInfo& UpdateInfo);
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "Mod Update Notifier")
+	void OnUpdateInfoSet(const FAvailableUpdateInfo& UpdateInfo);
+
+	// Calls OnIconSet, native entries override it to show the icon
+	virtual void NativeOnIconSet(UTexture2D* Icon);
+
+	// Called with null right after OnUpdateInfoSet if the icon isn't loaded yet, and again once it is. Stays null if the mod has
+	// no logo or it can't be loaded.
+	UFUNCTION(BlueprintImplementableEvent, Category = "Mod Update Notifier")
+	void OnIconSet(UTexture2D* Icon);
+
+private:
+	void RequestIcon(const FString& LogoURL);
+
+	// Lets go of the icon of the previous row, so the cache can drop it
+	void ReleaseIcon();
+
+	void OnIconLoaded(const FString& LogoURL, UTexture2D* Icon);
+
+	FString HeldLogoURL; // Icon this entry shows or waits for, empty if none
+	bool bWaitingForIcon = false;
+	TWeakObjectPtr<UMUNIconCache> IconCache;
+	FDelegateHandle IconLoadedHandle;
+};
+
+// Entry of UMUNUpdateListView. Builds its own widgets, so the list works without an entry widget blueprint: the mod's logo
+// next to its name and author above the installed and available versions.
+UCLASS()
+class MODUPDATENOTIFIER_API UMUNUpdateRowWidget : public UMUNUpdateEntryWidget
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void NativeOnInitialized() override;
+	virtual void NativeOnUpdateInfoSet(const FAvailableUpdateInfo& UpdateInfo) override;
+	virtual void NativeOnIconSet(UTexture2D* Icon) override;
+
+private:
+	// Size the logo is shown at, thumbnails are at most 64 pixels
+	static constexpr float IconDisplaySize = 48.0f;
+
+	UPROPERTY()
+	TObjectPtr<UImage> IconImage;
+
+	UPROPERTY()
+	TObjectPtr<UTextBlock> NameText;
+
+	UPROPERTY()
+	TObjectPtr<UTextBlock> VersionText;
+};
+
+// The notification's update list. Only creates rows for the updates on screen, so long update lists open as fast as short ones.
+UCLASS()
+class MODUPDATENOTIFIER_API UMUNUpdateListView : public UListView
+{
+	GENERATED_BODY()
+
+public:
+	UMUNUpdateListView(const FObjectInitializer& ObjectInitializer);
+};
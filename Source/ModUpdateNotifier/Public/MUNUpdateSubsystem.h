@@ -0,0 +1,100 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "MUNChangelogCache.h"
+#include "MUNIconCache.h"
+#include "MUNUpdateChecker.h"
+#include "MUNUpdateSubsystem.generated.h"
+
+class UModLoadingLibrary;
+class UWorldModuleManager;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FMUNOnNewUpdatesFound, const TArray<FMUNModRecord>&, NewUpdates);
+
+// Owns update checks for the whole lifetime of the game instance, so they don't depend on the main menu world
+UCLASS()
+class MODUPDATENOTIFIER_API UMUNUpdateSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Returns this session's main menu check, creating it on first use. Only the first caller starts it, menus created
+	// later attach to it whether it is still in flight or complete, so returning to the main menu doesn't scan the mods
+	// or ask the API again. Changelogs fetched through it are kept for the session too. Periodic re-checks start once
+	// it completes.
+	UMUNUpdateChecker* GetMenuChecker(const FMUNCheckSettings& Settings);
+
+	// Rendered changelogs, shared by every main menu of the session
+	FMUNChangelogCache& GetChangelogCache() { return ChangelogCache; }
+
+	// Mod logos shown by the notification, created on first use and kept for the session
+	UMUNIconCache* GetIconCache();
+
+	// Checks every installed mod without any UI and writes a JSON report of the outdated ones to disk and the log.
+	// Meant for dedicated servers, only the first call in a session starts a check.
+	void StartServerCheck(const FMUNCheckSettings& Settings, UModLoadingLibrary* ModLoadingLibrary, UWorldModuleManager* WorldModuleManager);
+
+	static FString GetServerReportPath();
+
+	// Checks started afterwards read and write this cache instead of the one in Saved, so tests leave the player's cache alone
+	void SetVersionCache(const TSharedRef<FMUNVersionCache>& InVersionCache) { VersionCache = InVersionCache; }
+
+	UPROPERTY(BlueprintAssignable, Category = "Mod Update Notifier")
+	FMUNOnNewUpdatesFound OnNewUpdatesFound; // Broadcast after a periodic re-check for updates whose version changed since the previous check
+
+private:
+	// Servers are busy with players, keep the check from competing with them for the network
+	static constexpr int32 ServerMaxConcurrentRequests = 2;
+
+	// Re-checks run in the middle of a session, so they trickle their requests out instead of sending a burst
+	static constexpr int32 RecheckMaxConcurrentRequests = 1;
+	static constexpr float RecheckDispatchIntervalSeconds = 0.5f;
+
+	void OnMenuCheckComplete();
+	void OnServerCheckComplete();
+
+	// Checks the mods of a completed check again every Settings.RecheckIntervalSeconds for the rest of the session.
+	// Does nothing if re-checks are disabled or already running.
+	void StartPeriodicRecheck(const FMUNCheckSettings& Settings, const UMUNUpdateChecker& CompletedCheck);
+
+	// Writes the outdated mods of a completed check to the server report, on a worker thread
+	static void WriteServerReport(const UMUNUpdateChecker& Checker);
+
+	bool OnRecheckTimer(float DeltaTime);
+	void OnRecheckComplete();
+
+	// Bound to OnNewUpdatesFound on clients, tells the player about updates released during the session with a popup,
+	// which shows in the main menu and in game alike
+	UFUNCTION()
+	void ShowNewUpdatesNotice(const TArray<FMUNModRecord>& NewUpdates);
+
+	TSharedPtr<FMUNVersionCache> VersionCache; // Shared by every check of the session, so the cache file is read once
+
+	UPROPERTY()
+	TObjectPtr<UMUNUpdateChecker> MenuChecker;
+
+	FMUNChangelogCache ChangelogCache;
+
+	UPROPERTY()
+	TObjectPtr<UMUNIconCache> IconCache;
+
+	UPROPERTY()
+	TObjectPtr<UMUNUpdateChecker> ServerChecker;
+
+	UPROPERTY()
+	TObjectPtr<UMUNUpdateChecker> RecheckChecker; // The re-check in progress or the last one to complete
+
+	FMUNCheckSettings RecheckSettings;
+	FMUNModTable RecheckMods; // Mods found by the first check, installed mods don't change during a session
+	FString RecheckFingerprint; // Installed fingerprint of the first check, so re-checks keep its stored results current
+	FMUNDependencyGraph RecheckDependencies; // Dependency ranges of the installed mods, re-checks don't scan
+	TMap<FString, FVersion> KnownVersions; // Version offered for every mod as of the previous check
+	FTSTicker::FDelegateHandle RecheckHandle;
+};
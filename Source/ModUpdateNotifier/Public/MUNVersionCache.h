@@ -0,0 +1,106 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "Util/SemVersion.h"
+#include "MUNModRecord.h"
+
+// Everything we remember about a single mod between game launches
+struct FMUNCachedModVersion
+{
+	FVersion HighestVersion = {0,0,0}; // Highest compatible version found on SMR
+	TArray<FVersion> RecentVersions; // Newest compatible versions, newest first, so dependency ranges can be resolved without the API
+	FString Changelog; // Changelog of HighestVersion, empty if it hasn't been fetched yet
+	FString LogoURL; // Only returned by the batched query, kept so mods resolved from the cache or a snapshot still have one
+	FDateTime FetchedAt; // When the entry was last confirmed by the API (UTC)
+
+	bool IsFresh(const FTimespan& TimeToLive) const { return FDateTime::UtcNow() - FetchedAt < TimeToLive; }
+};
+
+// Persistent cache of remote mod versions, stored as JSON in Saved/ModUpdateNotifier. A single instance is shared by
+// every check of the session, so the file is read once and checks see each other's results. Only used on the game thread,
+// the file is read and written on workers.
+class MODUPDATENOTIFIER_API FMUNVersionCache : public TSharedFromThis<FMUNVersionCache>
+{
+public:
+	// Tests and tools point the cache at a file of their own, so they never read or overwrite the game's
+	explicit FMUNVersionCache(const FString& InFilePath = GetCacheFilePath());
+	~FMUNVersionCache();
+
+	// Reads the cache file on a worker the first time it is called and calls OnLoaded on the game thread once it has been
+	// read. Later calls keep what is held in memory and call OnLoaded right away.
+	void LoadAsync(TUniqueFunction<void()>&& OnLoaded);
+
+	// Writes the cache file on a worker if anything changed since it was loaded. The contents are copied first, so the cache
+	// can keep changing meanwhile, and the old file is only replaced once the new one has been written in full.
+	void SaveAsync();
+
+	// Waits for the last write to finish, for commandlets and shutdown
+	void Flush();
+
+	const FMUNCachedModVersion* Find(const FString& ModReference) const { return Contents.Entries.Find(ModReference); }
+
+	// Records freshly retrieved versions, newest first, dropping the cached changelog if the highest version changed
+	void UpdateVersion(const FString& ModReference, const TArray<FVersion>& RecentVersions);
+
+	// Marks an entry as confirmed by the API without changing its contents
+	void Touch(const FString& ModReference);
+
+	// Changelogs of the least recently confirmed entries are dropped once they add up to more than ChangelogBudgetCharacters,
+	// they are fetched again if anyone asks for them
+	void UpdateChangelog(const FString& ModReference, const FString& Changelog);
+
+	void UpdateLogo(const FString& ModReference, const FString& LogoURL);
+
+	// Start of the last check in which every mod was retrieved without errors (UTC). Only valid for the game version it was
+	// recorded with, since a game update can make other versions compatible. FDateTime::MinValue() if there is none.
+	FDateTime GetLastSuccessfulCheck(uint32 GameVersion) const { return GameVersion == Contents.LastCheckGameVersion ? Contents.LastSuccessfulCheck : FDateTime::MinValue(); }
+	void SetLastSuccessfulCheck(const FDateTime& CheckTime, uint32 GameVersion);
+
+	// Mod table of the last check without errors, if it was made for the same installed mods and is younger than TimeToLive.
+	// Changelogs are not part of it, they are kept with the version entries.
+	const FMUNModTable* FindCheckResults(const FString& InstalledFingerprint, const FTimespan& TimeToLive) const;
+
+	// CheckedAt is the oldest point in time at which the versions in ModTable were known to be current, not when the check
+	// completed, so results built from old cache entries or an old snapshot don't count as fresh for longer than those.
+	void SetCheckResults(const FString& InstalledFingerprint, const FMUNModTable& ModTable, const FDateTime& CheckedAt);
+
+	static FString GetCacheFilePath();
+
+private:
+	// Characters of changelog kept across all entries, in memory and in the file
+	static constexpr int64 ChangelogBudgetCharacters = 1024 * 1024;
+
+	// Everything stored in the cache file
+	struct FContents
+	{
+		TMap<FString, FMUNCachedModVersion> Entries;
+
+		FString ResultsFingerprint; // Fingerprint of the installed mods CheckResults were made for, empty if there are none
+		FDateTime ResultsCheckedAt; // Oldest confirmation of the versions in CheckResults (UTC)
+		FMUNModTable CheckResults;
+
+		FDateTime LastSuccessfulCheck = FDateTime::MinValue();
+		uint32 LastCheckGameVersion = 0;
+	};
+
+	// Parse and serialize the cache file. Run on workers.
+	static void ReadFile(const FString& CacheFilePath, FContents& OutContents);
+	static void WriteFile(const FString& CacheFilePath, const FContents& FileContents);
+
+	// Back on the game thread with the contents read from disk
+	void OnLoaded(FContents&& LoadedContents);
+
+	// Drops changelogs, least recently confirmed entries first, until they fit ChangelogBudgetCharacters
+	void TrimChangelogs();
+
+	const FString FilePath;
+	FContents Contents;
+
+	bool bLoaded = false;
+	bool bDirty = false;
+	TArray<TUniqueFunction<void()>> LoadCallbacks; // Waiting for the cache file to be read, empty unless it is being read
+	UE::Tasks::FTask SaveTask; // The last write, each write waits for the one before it
+};
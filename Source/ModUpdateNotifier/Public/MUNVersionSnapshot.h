@@ -0,0 +1,91 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MUNVersionsReader.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// A precompiled, read-only index of SMR versions, used instead of the API on machines that can't or shouldn't reach it.
+// The file is a fixed header, a table of mods sorted by reference, a table of versions and a blob of UTF-8 strings,
+// all addressed by offset so it can be memory mapped and searched in place. Lookups are a binary search and
+// return views into the file, nothing is copied or allocated per mod.
+class MODUPDATENOTIFIER_API FMUNVersionSnapshot
+{
+public:
+	~FMUNVersionSnapshot();
+
+	// Maps the file into memory, or reads it if the platform can't map files. Returns null if it is missing or malformed.
+	static TSharedPtr<FMUNVersionSnapshot> LoadFromFile(const FString& FilePath);
+
+	// Takes a snapshot downloaded from a mirror. Returns null if it is malformed.
+	static TSharedPtr<FMUNVersionSnapshot> LoadFromMemory(TArray<uint8>&& Data);
+
+	// Finds the versions of a mod, newest first. Returned views are valid as long as the snapshot is.
+	bool Find(FUtf8StringView ModReference, TArray<FMUNVersionEntry>& OutVersions) const;
+
+	int32 Num() const { return NumMods; }
+	FDateTime GetGeneratedAt() const { return GeneratedAt; }
+
+	static FString GetDefaultPath();
+
+private:
+	FMUNVersionSnapshot() = default;
+
+	// Checks the header and that every offset stays within the file, so lookups don't have to
+	bool Initialize(const uint8* InData, int64 InSize);
+
+	FUtf8StringView GetString(uint32 Offset, uint32 Length) const;
+
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion; // Declared after the handle so it is unmapped first
+	TArray<uint8> LoadedData; // Only used if the file couldn't be mapped
+
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+
+	int32 NumMods = 0;
+	FDateTime GeneratedAt;
+};
+
+// Builds a version snapshot file, used by the snapshot commandlet
+class MODUPDATENOTIFIER_API FMUNVersionSnapshotWriter
+{
+public:
+	// Versions are stored in the given order, which should be newest first
+	void AddMod(FUtf8StringView ModReference, TConstArrayView<FMUNVersionEntry> Versions);
+
+	// Writes to a temporary file first and moves it over the old snapshot, so readers never see a partial file
+	bool Save(const FString& FilePath, const FDateTime& GeneratedAt) const;
+
+	int32 Num() const { return Mods.Num(); }
+
+private:
+	struct FStringRef
+	{
+		uint32 Offset = 0;
+		uint32 Length = 0;
+	};
+
+	struct FPendingMod
+	{
+		FStringRef Reference;
+		TArray<TPair<FStringRef, FStringRef>> Versions; // Version, game version
+	};
+
+	// FString keys compare and hash ignoring case by default, which would merge versions like 1.0.0-RC.1 and 1.0.0-rc.1
+	struct FCaseSensitiveKeyFuncs : TDefaultMapKeyFuncs<FString, FStringRef, false>
+	{
+		static bool Matches(const FString& A, const FString& B) { return A.Equals(B, ESearchCase::CaseSensitive); }
+		static uint32 GetKeyHash(const FString& Key) { return FCrc::StrCrc32(*Key); }
+	};
+
+	// Game version constraints repeat across most versions, every distinct string is stored once
+	FStringRef AddString(FUtf8StringView String);
+
+	TArray<FPendingMod> Mods;
+	TArray<uint8> Strings;
+	TMap<FString, FStringRef, FDefaultSetAllocator, FCaseSensitiveKeyFuncs> StringOffsets;
+};
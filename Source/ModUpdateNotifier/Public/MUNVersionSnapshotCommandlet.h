@@ -0,0 +1,26 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MUNVersionSnapshotCommandlet.generated.h"
+
+// Downloads the versions of every mod on SMR (or of the mods given with -Mods=a,b,c) into a version snapshot file,
+// so a fleet of servers or LAN machines can check for updates without each of them reaching the API.
+// Uses the API base URL and request settings of the mod config saved on this machine, -MUNApiBaseURL= overrides the URL.
+// Usage: -run=MUNVersionSnapshot [-Output=<path>] [-Mods=<references>] [-MUNApiBaseURL=<url>]
+UCLASS()
+class MODUPDATENOTIFIER_API UMUNVersionSnapshotCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMUNVersionSnapshotCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	// Number of mods asked for in a single page, the API caps how many mods a query may return
+	static constexpr int32 SnapshotPageSize = 100;
+};
@@ -0,0 +1,39 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StringView.h"
+
+// Decoded text of strings that contained escape sequences, views of them point into its elements. Each element has its own
+// allocation, so adding more doesn't move the text of earlier ones.
+using FMUNDecodedStrings = TArray<TArray<UTF8CHAR>>;
+
+// A single SMR version, viewing directly into the UTF-8 response body it was read from, or into the decoded strings of
+// the read if it contained escape sequences
+struct FMUNVersionEntry
+{
+	FUtf8StringView Version;
+	FUtf8StringView GameVersion;
+};
+
+// Streaming reader for SMR version payloads. Works on the raw UTF-8 response bytes and only picks out
+// "version" and "game_version" from each element, skipping everything else without building a JSON DOM.
+// Strings without escape sequences are returned as views of the content, the rest are decoded (e.g. SMR escapes the ">"
+// of a range as \u003e). Returned views are only valid as long as the content and the decoded strings they were read from.
+class MODUPDATENOTIFIER_API FMUNVersionsReader
+{
+public:
+	// Reads a /v1/mod/<reference>/versions or /versions/all response. Returns false if the payload is malformed or has no "data" array.
+	static bool ReadVersionsAll(TConstArrayView<uint8> Content, TArray<FMUNVersionEntry>& OutVersions, FMUNDecodedStrings& OutDecodedStrings);
+
+	// Reads a batched getMods GraphQL response, calling Visitor once for every mod in it. Logo is empty unless the query asked for "logo".
+	// The views passed to Visitor are only valid during the call. Returns false if the payload is malformed or the query returned errors.
+	static bool ReadBatchedVersions(TConstArrayView<uint8> Content, TFunctionRef<void(FUtf8StringView ModReference, FUtf8StringView Logo, TConstArrayView<FMUNVersionEntry> Versions)> Visitor);
+
+	// Reads a getMods GraphQL response asking for "mod_reference" and "last_version_date", calling Visitor once for every mod in it.
+	// The views passed to Visitor are only valid during the call. Returns false if the payload is malformed or the query returned errors.
+	static bool ReadLastVersionDates(TConstArrayView<uint8> Content, TFunctionRef<void(FUtf8StringView ModReference, FUtf8StringView LastVersionDate)> Visitor);
+
+	static FString ToString(const FUtf8StringView View) { return FString(View.Len(), View.GetData()); }
+};
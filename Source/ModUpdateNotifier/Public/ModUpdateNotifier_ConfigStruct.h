@@ -18,6 +18,39 @@ public:
     UPROPERTY(BlueprintReadWrite)
     bool bDisableNotifications{};
 
+    UPROPERTY(BlueprintReadWrite)
+    bool bIncludePreReleases{};
+
+    UPROPERTY(BlueprintReadWrite)
+    int32 VersionCacheTTLMinutes{};
+
+    UPROPERTY(BlueprintReadWrite)
+    int32 MaxConcurrentRequests{};
+
+    UPROPERTY(BlueprintReadWrite)
+    float RequestTimeoutSeconds{};
+
+    UPROPERTY(BlueprintReadWrite)
+    float NotificationDeadlineSeconds{};
+
+    UPROPERTY(BlueprintReadWrite)
+    FString APIBaseURL{};
+
+    UPROPERTY(BlueprintReadWrite)
+    bool bPeriodicRecheck{};
+
+    UPROPERTY(BlueprintReadWrite)
+    int32 RecheckIntervalMinutes{};
+
+    UPROPERTY(BlueprintReadWrite)
+    FString VersionSnapshot{};
+
+    UPROPERTY(BlueprintReadWrite)
+    int32 ChangelogCacheBudgetKB{};
+
+    UPROPERTY(BlueprintReadWrite)
+    int32 IconCacheBudgetMB{};
+
     /* Retrieves active configuration value and returns object of this struct containing it */
     static FModUpdateNotifier_ConfigStruct GetActiveConfig(UObject* WorldContext) {
         FModUpdateNotifier_ConfigStruct ConfigStruct{};
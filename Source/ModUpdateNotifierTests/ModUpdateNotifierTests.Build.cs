@@ -0,0 +1,27 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class ModUpdateNotifierTests : ModuleRules
+{
+	public ModUpdateNotifierTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+		CppStandard = CppStandardVersion.Cpp20;
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"FactoryGame",
+				"SML",
+				"HTTP",
+				"HTTPServer",
+				"Json",
+				"ModUpdateNotifier",
+			}
+		);
+	}
+}
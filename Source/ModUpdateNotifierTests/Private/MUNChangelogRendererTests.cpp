@@ -0,0 +1,38 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "Misc/AutomationTest.h"
+#include "MUNChangelogCache.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMUNChangelogRendererPlainTextTest, "ModUpdateNotifier.ChangelogRenderer.PlainText",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMUNChangelogRendererPlainTextTest::RunTest(const FString& Parameters)
+{
+	const FString Markdown = TEXT("# Release <1.2.0>\n\n- **Fixed** a crash in `Foo`\n- See [the wiki](https://example.com) & more\n");
+
+	const TSharedRef<const FMUNRenderedChangelog> RichText = FMUNChangelogRenderer::Render(Markdown, 4096);
+	const TSharedRef<const FMUNRenderedChangelog> PlainText = FMUNChangelogRenderer::Render(Markdown, 4096, EMUNChangelogFormat::PlainText);
+
+	if (TestEqual(TEXT("Rich text chunks"), RichText->Chunks.Num(), 1) && TestEqual(TEXT("Plain text chunks"), PlainText->Chunks.Num(), 1))
+	{
+		TestEqual(TEXT("Rich text is styled and escaped"), RichText->Chunks[0], FString(TEXT("<Bold>Release &lt;1.2.0&gt;</>\n\n\u2022 <Bold>Fixed</> a crash in Foo\n\u2022 See the wiki &amp; more")));
+		TestEqual(TEXT("Plain text has no markup"), PlainText->Chunks[0], FString(TEXT("Release <1.2.0>\n\n\u2022 Fixed a crash in Foo\n\u2022 See the wiki & more")));
+	}
+
+	// Shown a chunk at a time, the chunks add up to the whole changelog
+	FString LongMarkdown;
+	for (int32 Line = 0; Line < 200; Line++)
+	{
+		LongMarkdown += FString::Printf(TEXT("- Change number %d\n"), Line);
+	}
+
+	const TSharedRef<const FMUNRenderedChangelog> Chunked = FMUNChangelogRenderer::Render(LongMarkdown, 256, EMUNChangelogFormat::PlainText);
+	const TSharedRef<const FMUNRenderedChangelog> Whole = FMUNChangelogRenderer::Render(LongMarkdown, LongMarkdown.Len() * 2, EMUNChangelogFormat::PlainText);
+	TestTrue(TEXT("Split into several chunks"), Chunked->Chunks.Num() > 1);
+	TestEqual(TEXT("Chunks add up to the whole changelog"), FString::Join(Chunked->Chunks, TEXT("")), Whole->Chunks[0]);
+	return true;
+}
+
+#endif
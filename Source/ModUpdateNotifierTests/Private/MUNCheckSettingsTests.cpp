@@ -0,0 +1,61 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "Misc/AutomationTest.h"
+#include "Misc/ConfigCacheIni.h"
+#include "MUNUpdateChecker.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMUNCheckSettingsIniTest, "ModUpdateNotifier.CheckSettings.IniOptions",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMUNCheckSettingsIniTest::RunTest(const FString& Parameters)
+{
+	// Whatever the game's Game.ini holds is put back afterwards
+	TArray<FString> SavedLines;
+	GConfig->GetSection(FMUNCheckSettings::IniSection, SavedLines, GGameIni);
+	GConfig->EmptySection(FMUNCheckSettings::IniSection, GGameIni);
+
+	FModUpdateNotifier_ConfigStruct Config;
+	FMUNCheckSettings::ReadIniOptions(Config);
+	TestFalse(TEXT("Options missing from the ini keep their value"), Config.bPeriodicRecheck);
+
+	GConfig->SetBool(FMUNCheckSettings::IniSection, TEXT("bPeriodicRecheck"), true, GGameIni);
+	GConfig->SetInt(FMUNCheckSettings::IniSection, TEXT("RecheckIntervalMinutes"), 30, GGameIni);
+	GConfig->SetInt(FMUNCheckSettings::IniSection, TEXT("VersionCacheTTLMinutes"), 15, GGameIni);
+	GConfig->SetInt(FMUNCheckSettings::IniSection, TEXT("MaxConcurrentRequests"), 4, GGameIni);
+	GConfig->SetFloat(FMUNCheckSettings::IniSection, TEXT("RequestTimeoutSeconds"), 5.0f, GGameIni);
+	GConfig->SetFloat(FMUNCheckSettings::IniSection, TEXT("NotificationDeadlineSeconds"), 1.5f, GGameIni);
+	GConfig->SetBool(FMUNCheckSettings::IniSection, TEXT("bIncludePreReleases"), true, GGameIni);
+	GConfig->SetString(FMUNCheckSettings::IniSection, TEXT("APIBaseURL"), TEXT("http://127.0.0.1:17860/"), GGameIni);
+	GConfig->SetString(FMUNCheckSettings::IniSection, TEXT("VersionSnapshot"), TEXT("https://example.com/VersionSnapshot.bin"), GGameIni);
+	GConfig->SetInt(FMUNCheckSettings::IniSection, TEXT("ChangelogCacheBudgetKB"), 512, GGameIni);
+	GConfig->SetInt(FMUNCheckSettings::IniSection, TEXT("IconCacheBudgetMB"), 8, GGameIni);
+	FMUNCheckSettings::ReadIniOptions(Config);
+
+	const FMUNCheckSettings Settings = FMUNCheckSettings::FromConfig(Config);
+	TestEqual(TEXT("Re-check interval"), Settings.RecheckIntervalSeconds, 30.0f * 60.0f);
+	TestEqual(TEXT("Version cache lifetime"), Settings.VersionCacheTTL, FTimespan::FromMinutes(15));
+	TestEqual(TEXT("Requests in flight"), Settings.RequestSettings.MaxConcurrentRequests, 4);
+	TestEqual(TEXT("Request timeout"), Settings.RequestSettings.TimeoutSeconds, 5.0f);
+	TestEqual(TEXT("Notification deadline"), Config.NotificationDeadlineSeconds, 1.5f);
+	TestTrue(TEXT("Pre-releases"), Settings.bIncludePreReleases);
+	TestEqual(TEXT("API base URL"), Config.APIBaseURL, FString(TEXT("http://127.0.0.1:17860/")));
+	TestEqual(TEXT("Version snapshot"), Config.VersionSnapshot, FString(TEXT("https://example.com/VersionSnapshot.bin")));
+	TestEqual(TEXT("Changelog cache budget"), Config.ChangelogCacheBudgetKB, 512);
+	TestEqual(TEXT("Icon cache budget"), Config.IconCacheBudgetMB, 8);
+
+	GConfig->EmptySection(FMUNCheckSettings::IniSection, GGameIni);
+	for (const FString& Line : SavedLines)
+	{
+		FString Key;
+		FString Value;
+		if (Line.Split(TEXT("="), &Key, &Value))
+		{
+			GConfig->SetString(FMUNCheckSettings::IniSection, *Key, *Value, GGameIni);
+		}
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,118 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "Misc/AutomationTest.h"
+#include "MUNDependencyGraph.h"
+#include "MUNTestPayloads.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	FVersionRange MakeRange(const TCHAR* Text)
+	{
+		FVersionRange Range;
+		FString Error;
+		verifyf(Range.ParseVersionRange(Text, Error), TEXT("Invalid range %s: %s"), Text, *Error);
+		return Range;
+	}
+
+	// Versions 2.0.0, 1.<NumMinor - 1>.0 down to 1.0.0, newest first
+	TArray<FVersion> MakeVersionList(const int32 NumMinor)
+	{
+		TArray<FVersion> Versions = {FVersion{2, 0, 0}};
+		for (int32 Minor = NumMinor - 1; Minor >= 0; Minor--)
+		{
+			Versions.Add(FVersion{1, Minor, 0});
+		}
+		return Versions;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMUNDependencyGraphTest, "ModUpdateNotifier.DependencyGraph.FindNewestAllowed",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMUNDependencyGraphTest::RunTest(const FString& Parameters)
+{
+	const TArray<FVersion> Versions = MakeVersionList(3);
+
+	FMUNDependencyGraph Graph;
+	TestTrue(TEXT("Mods without dependents get the newest version"), Graph.FindNewestAllowed(TEXT("Library"), Versions).Compare(FVersion{2, 0, 0}) == 0);
+
+	Graph.AddDependency(TEXT("Library"), TEXT("OldDependent"), MakeRange(TEXT("^1.0.0")));
+	Graph.AddDependency(TEXT("Library"), TEXT("NewDependent"), MakeRange(TEXT(">=1.1.0")));
+	TestEqual(TEXT("Edges"), Graph.NumEdges(), 2);
+
+	FName BlockingDependent;
+	TestTrue(TEXT("Newest version allowed by every dependent"), Graph.FindNewestAllowed(TEXT("Library"), Versions, &BlockingDependent).Compare(FVersion{1, 2, 0}) == 0);
+	TestEqual(TEXT("Dependent blocking the newest version"), BlockingDependent.ToString(), FString(TEXT("OldDependent")));
+
+	Graph.AddDependency(TEXT("Library"), TEXT("PinnedDependent"), MakeRange(TEXT("<1.1.0")));
+	TestTrue(TEXT("No version allowed by every dependent"), Graph.FindNewestAllowed(TEXT("Library"), Versions).Compare(FVersion{0, 0, 0}) == 0);
+
+	TestTrue(TEXT("Other mods are unaffected"), Graph.FindNewestAllowed(TEXT("OldDependent"), Versions).Compare(FVersion{2, 0, 0}) == 0);
+	TestTrue(TEXT("No versions"), Graph.FindNewestAllowed(TEXT("OldDependent"), {}).Compare(FVersion{0, 0, 0}) == 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMUNDependencyGraphBenchmark, "ModUpdateNotifier.Benchmarks.DependencyGraph",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FMUNDependencyGraphBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 Iterations = 9;
+	constexpr int32 DependenciesPerMod = 5;
+
+	// Every mod depends on SML and on a few of the mods before it, about what large modpacks look like
+	const FVersionRange SMLRange = MakeRange(TEXT("^3.12.0"));
+	const FVersionRange ModRange = MakeRange(TEXT("^1.0.0"));
+	const TArray<FVersion> Versions = MakeVersionList(9);
+
+	FMUNBenchmarkLog Log(*this, TEXT("DependencyGraph"));
+
+	for (const int32 NumMods : FMUNTestPayloads::BenchmarkScales)
+	{
+		TArray<FName> ModReferences;
+		for (int32 ModIndex = 0; ModIndex < NumMods; ModIndex++)
+		{
+			ModReferences.Add(FName(*FMUNTestPayloads::MakeModReference(ModIndex)));
+		}
+
+		FMUNDependencyGraph Graph;
+		const double BuildMs = FMUNBenchmarkLog::MedianMilliseconds(Iterations, [&]()
+		{
+			Graph = FMUNDependencyGraph();
+			for (int32 ModIndex = 0; ModIndex < NumMods; ModIndex++)
+			{
+				Graph.AddDependency(TEXT("SML"), ModReferences[ModIndex], SMLRange);
+				for (int32 Offset = 1; Offset <= FMath::Min(DependenciesPerMod, ModIndex); Offset++)
+				{
+					Graph.AddDependency(ModReferences[ModIndex - Offset], ModReferences[ModIndex], ModRange);
+				}
+			}
+		});
+
+		int32 NumBlocked = 0;
+		const double ResolveMs = FMUNBenchmarkLog::MedianMilliseconds(Iterations, [&]()
+		{
+			NumBlocked = 0;
+			for (const FName ModReference : ModReferences)
+			{
+				FName BlockingDependent;
+				if (Graph.FindNewestAllowed(ModReference, Versions, &BlockingDependent).Compare(Versions[0]) != 0)
+				{
+					NumBlocked++;
+				}
+			}
+		});
+
+		// Only the last mod has no dependents, the ^1.0.0 of the others holds them back from 2.0.0
+		TestEqual(TEXT("Mods held back by a dependent"), NumBlocked, NumMods - 1);
+		Log.Add(TEXT("Build"), NumMods, TEXT("ms"), BuildMs);
+		Log.Add(TEXT("Resolve every mod"), NumMods, TEXT("ms"), ResolveMs);
+		Log.Add(TEXT("Edges"), NumMods, TEXT("count"), Graph.NumEdges());
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,115 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "Misc/AutomationTest.h"
+#include "HttpModule.h"
+#include "MUNRequestScheduler.h"
+#include "MUNStats.h"
+#include "MUNTestApiServer.h"
+#include "MUNTestPayloads.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(FMUNRequestSchedulerSpec, "ModUpdateNotifier.RequestScheduler",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+	TSharedPtr<FMUNTestApiServer> Server;
+	TSharedPtr<FMUNRequestScheduler> Scheduler;
+	TArray<FString> Versions;
+
+	FHttpRequestRef MakeRequest(const FString& ModReference) const
+	{
+		const FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
+		Request->SetURL(FString::Printf(TEXT("%s/v1/mod/%s/versions/all"), *Server->GetBaseURL(), *ModReference));
+		Request->SetVerb(TEXT("GET"));
+		return Request;
+	}
+
+END_DEFINE_SPEC(FMUNRequestSchedulerSpec)
+
+void FMUNRequestSchedulerSpec::Define()
+{
+	BeforeEach([this]()
+	{
+		Versions = FMUNTestPayloads::MakeVersions(20);
+
+		Server = MakeShared<FMUNTestApiServer>();
+		TestTrue(TEXT("Test API started"), Server->Start());
+		Server->AddMod(FMUNTestPayloads::MakeModReference(0), Versions);
+
+		// Short backoffs, so retries don't slow the tests down
+		FMUNRequestSettings Settings;
+		Settings.TimeoutSeconds = 5.0f;
+		Settings.MaxRetries = 2;
+		Settings.BaseBackoffSeconds = 0.01f;
+		Settings.MaxBackoffSeconds = 0.05f;
+		Scheduler = MakeShared<FMUNRequestScheduler>(Settings);
+
+		FMUNCheckReport::Get().Reset();
+	});
+
+	AfterEach([this]()
+	{
+		Scheduler->CancelAll();
+		Scheduler.Reset();
+		Server.Reset();
+	});
+
+	Describe(TEXT("Gzipped responses"), [this]()
+	{
+		LatentIt(TEXT("decompresses the body and reports the bytes on the wire"), FTimespan::FromSeconds(10), [this](const FDoneDelegate& Done)
+		{
+			Server->Settings.bGzip = true;
+
+			Scheduler->Enqueue(MakeRequest(FMUNTestPayloads::MakeModReference(0)), FHttpRequestCompleteDelegate::CreateLambda([this, Done](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+			{
+				TArray<uint8> Storage;
+				const TConstArrayView<uint8> Content = FMUNRequestScheduler::GetContent(Response, Storage);
+				const TArray<uint8> Expected = FMUNTestPayloads::ToUtf8(FMUNTestPayloads::MakeVersionsAll(Versions));
+
+				TestTrue(TEXT("Request succeeded"), bWasSuccessful);
+				TestTrue(TEXT("Content matches the uncompressed payload"), Content.Num() == Expected.Num() && FMemory::Memcmp(Content.GetData(), Expected.GetData(), Expected.Num()) == 0);
+				TestTrue(TEXT("Body was sent compressed"), Server->GetBytesServed() < Expected.Num());
+				TestEqual(TEXT("Reported bytes are the compressed size"), FMUNCheckReport::Get().GetBytesReceived(), Server->GetBytesServed());
+				Done.Execute();
+			}), TEXT("Gzip"));
+		});
+	});
+
+	Describe(TEXT("Failing requests"), [this]()
+	{
+		LatentIt(TEXT("are retried before completing as failed"), FTimespan::FromSeconds(10), [this](const FDoneDelegate& Done)
+		{
+			Server->Settings.FailEveryNthRequest = 1;
+
+			Scheduler->Enqueue(MakeRequest(FMUNTestPayloads::MakeModReference(0)), FHttpRequestCompleteDelegate::CreateLambda([this, Done](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+			{
+				TestEqual(TEXT("Final response is the server error"), Response.IsValid() ? Response->GetResponseCode() : 0, static_cast<int32>(EHttpResponseCodes::ServerError));
+				TestEqual(TEXT("Attempts"), Server->GetNumRequests(), 3);
+				TestEqual(TEXT("Completes exactly once"), FMUNCheckReport::Get().GetNumRequests(), 1);
+				Done.Execute();
+			}), TEXT("Failing"));
+		});
+
+		LatentIt(TEXT("complete with the response of the retry that succeeds"), FTimespan::FromSeconds(10), [this](const FDoneDelegate& Done)
+		{
+			Server->Settings.FailEveryNthRequest = 2;
+
+			// The first request succeeds and the second fails, so the second one is answered by its retry
+			TSharedRef<int32> NumCompleted = MakeShared<int32>(0);
+			for (int32 RequestIndex = 0; RequestIndex < 2; RequestIndex++)
+			{
+				Scheduler->Enqueue(MakeRequest(FMUNTestPayloads::MakeModReference(0)), FHttpRequestCompleteDelegate::CreateLambda([this, Done, NumCompleted](FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
+				{
+					TestTrue(TEXT("Request succeeded"), bWasSuccessful && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()));
+					if (++*NumCompleted == 2)
+					{
+						TestEqual(TEXT("Attempts"), Server->GetNumRequests(), 3);
+						Done.Execute();
+					}
+				}), TEXT("Flaky"));
+			}
+		});
+	});
+}
+
+#endif
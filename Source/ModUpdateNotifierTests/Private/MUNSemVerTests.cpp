@@ -0,0 +1,164 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "Misc/AutomationTest.h"
+#include "MUNSemVer.h"
+#include "MUNTestPayloads.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	using FMUNTCharSemVer = TMUNSemVer<TCHAR>;
+
+	bool MatchesRange(const TCHAR* Range, const TCHAR* Version)
+	{
+		FMUNTCharSemVer SemVer;
+		return FMUNTCharSemVer::Parse(Version, SemVer) && FMUNVersionRange::Matches(FStringView(Range), SemVer);
+	}
+
+	int32 CompareVersions(const TCHAR* Left, const TCHAR* Right)
+	{
+		FMUNTCharSemVer LeftVersion;
+		FMUNTCharSemVer RightVersion;
+		FMUNTCharSemVer::Parse(Left, LeftVersion);
+		FMUNTCharSemVer::Parse(Right, RightVersion);
+		return FMath::Sign(LeftVersion.Compare(RightVersion));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMUNSemVerParseTest, "ModUpdateNotifier.SemVer.Parse",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMUNSemVerParseTest::RunTest(const FString& Parameters)
+{
+	FMUNTCharSemVer Version;
+	if (TestTrue(TEXT("Parses a version with a prefix, pre-release and build"), FMUNTCharSemVer::Parse(TEXT("v1.22.333-beta.1+build.5"), Version)))
+	{
+		TestEqual(TEXT("Major"), Version.Major, 1ull);
+		TestEqual(TEXT("Minor"), Version.Minor, 22ull);
+		TestEqual(TEXT("Patch"), Version.Patch, 333ull);
+		TestEqual(TEXT("Pre-release"), FString(Version.PreRelease), FString(TEXT("beta.1")));
+	}
+
+	TestFalse(TEXT("Rejects partial versions"), FMUNTCharSemVer::Parse(TEXT("1.2"), Version));
+	TestFalse(TEXT("Rejects an empty pre-release"), FMUNTCharSemVer::Parse(TEXT("1.2.3-"), Version));
+	TestFalse(TEXT("Rejects trailing text"), FMUNTCharSemVer::Parse(TEXT("1.2.3 beta"), Version));
+	TestFalse(TEXT("Rejects numbers that overflow"), FMUNTCharSemVer::Parse(TEXT("99999999999999999999.0.0"), Version));
+
+	int32 NumParts = 0;
+	TestTrue(TEXT("Parses partial versions of ranges"), FMUNTCharSemVer::Parse(TEXT("1.2"), Version, &NumParts) && NumParts == 2);
+
+	// Precedence examples of the SemVer 2.0 specification
+	const TCHAR* Ordered[] = {TEXT("1.0.0-alpha"), TEXT("1.0.0-alpha.1"), TEXT("1.0.0-alpha.beta"), TEXT("1.0.0-beta"), TEXT("1.0.0-beta.2"), TEXT("1.0.0-beta.11"), TEXT("1.0.0-rc.1"), TEXT("1.0.0"), TEXT("1.0.1"), TEXT("1.1.0"), TEXT("2.0.0")};
+	for (int32 Index = 1; Index < UE_ARRAY_COUNT(Ordered); Index++)
+	{
+		TestEqual(FString::Printf(TEXT("%s < %s"), Ordered[Index - 1], Ordered[Index]), CompareVersions(Ordered[Index - 1], Ordered[Index]), -1);
+	}
+	TestEqual(TEXT("Build metadata is ignored"), CompareVersions(TEXT("1.0.0+a"), TEXT("1.0.0+b")), 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMUNSemVerRangeTest, "ModUpdateNotifier.SemVer.Range",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMUNSemVerRangeTest::RunTest(const FString& Parameters)
+{
+	TestTrue(TEXT("Caret allows the same major version"), MatchesRange(TEXT("^1.2.3"), TEXT("1.9.0")));
+	TestFalse(TEXT("Caret excludes the next major version"), MatchesRange(TEXT("^1.2.3"), TEXT("2.0.0")));
+	TestFalse(TEXT("Caret excludes pre-releases of the next major version"), MatchesRange(TEXT("^1.2.3"), TEXT("2.0.0-beta")));
+	TestFalse(TEXT("Caret on 0.x keeps the minor version"), MatchesRange(TEXT("^0.2.3"), TEXT("0.3.0")));
+	TestFalse(TEXT("Caret on 0.0.x keeps the patch version"), MatchesRange(TEXT("^0.0.3"), TEXT("0.0.4")));
+	TestTrue(TEXT("Tilde allows the same minor version"), MatchesRange(TEXT("~1.2"), TEXT("1.2.9")));
+	TestFalse(TEXT("Tilde excludes the next minor version"), MatchesRange(TEXT("~1.2"), TEXT("1.3.0")));
+	TestTrue(TEXT("Comparators are combined"), MatchesRange(TEXT(">=1.0.0 <2.0.0"), TEXT("1.5.0")));
+	TestFalse(TEXT("Every comparator has to match"), MatchesRange(TEXT(">=1.0.0 <2.0.0"), TEXT("2.0.0")));
+	TestTrue(TEXT("Any alternative may match"), MatchesRange(TEXT("^1.0.0 || ^3.0.0"), TEXT("3.1.0")));
+	TestTrue(TEXT("Space after the operator"), MatchesRange(TEXT(">= 264901"), TEXT("264901.0.0")));
+	TestTrue(TEXT("Partial equality"), MatchesRange(TEXT("1.2"), TEXT("1.2.7")));
+	TestTrue(TEXT("Wildcard"), MatchesRange(TEXT("*"), TEXT("0.0.1")));
+	TestFalse(TEXT("Malformed ranges match nothing"), MatchesRange(TEXT(">=banana"), TEXT("1.0.0")));
+
+	// Game versions are compared against the changelist with UTF-8 ranges straight from the response
+	const FMUNUtf8SemVer GameVersion = {264901, 0, 0};
+	TestTrue(TEXT("UTF-8 range against a game version"), FMUNVersionRange::Matches(FUtf8StringView(UTF8TEXT(">=264901")), GameVersion));
+	TestFalse(TEXT("Experimental only version"), FMUNVersionRange::Matches(FUtf8StringView(UTF8TEXT(">=365306")), GameVersion));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMUNSemVerBenchmark, "ModUpdateNotifier.Benchmarks.SemVer",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FMUNSemVerBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 Iterations = 9;
+	constexpr int32 VersionsPerMod = 10;
+
+	// Every mod's versions are parsed and checked against the game version range, like selecting the recent versions of a response
+	const TArray<FString> Versions = FMUNTestPayloads::MakeVersions(VersionsPerMod);
+	TArray<TArray<uint8>> Utf8Versions;
+	for (const FString& Version : Versions)
+	{
+		Utf8Versions.Add(FMUNTestPayloads::ToUtf8(Version));
+	}
+	const FUtf8StringView GameVersionRange = UTF8TEXT(">=264901 <300000");
+	const FMUNUtf8SemVer GameVersion = {264901, 0, 0};
+	const FString ModRange = TEXT("^1.0.0");
+
+	FMUNBenchmarkLog Log(*this, TEXT("SemVer"));
+
+	for (const int32 NumMods : FMUNTestPayloads::BenchmarkScales)
+	{
+		int32 NumMatched = 0;
+		const auto MatchWithSemVer = [&]()
+		{
+			NumMatched = 0;
+			for (int32 ModIndex = 0; ModIndex < NumMods; ModIndex++)
+			{
+				for (const TArray<uint8>& Utf8Version : Utf8Versions)
+				{
+					FMUNUtf8SemVer Version;
+					if (FMUNUtf8SemVer::Parse(FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Utf8Version.GetData()), Utf8Version.Num()), Version)
+						&& FMUNVersionRange::Matches(GameVersionRange, GameVersion) && FMUNVersionRange::Matches(FStringView(ModRange), Version))
+					{
+						NumMatched++;
+					}
+				}
+			}
+		};
+		const double SemVerMs = FMUNBenchmarkLog::MedianMilliseconds(Iterations, MatchWithSemVer);
+		TestEqual(TEXT("Every version matches"), NumMatched, NumMods * VersionsPerMod);
+
+		// Versions and ranges are views of the text, so parsing and matching never touches the heap
+		const int64 SemVerAllocations = FMUNAllocationCounter::Count(MatchWithSemVer);
+		TestEqual(TEXT("MUN semver doesn't allocate"), SemVerAllocations, 0ll);
+
+		// SML's parser, which allocates for every version and range
+		const auto MatchWithSml = [&]()
+		{
+			for (int32 ModIndex = 0; ModIndex < NumMods; ModIndex++)
+			{
+				for (const FString& VersionText : Versions)
+				{
+					FVersion Version;
+					FVersionRange Range;
+					FString Error;
+					if (Version.ParseVersion(VersionText, Error) && Range.ParseVersionRange(ModRange, Error))
+					{
+						Range.Matches(Version);
+					}
+				}
+			}
+		};
+		const double SmlMs = FMUNBenchmarkLog::MedianMilliseconds(Iterations, MatchWithSml);
+		const int64 SmlAllocations = FMUNAllocationCounter::Count(MatchWithSml);
+
+		Log.Add(TEXT("MUN semver"), NumMods, TEXT("ms"), SemVerMs);
+		Log.Add(TEXT("MUN semver"), NumMods, TEXT("allocations"), SemVerAllocations);
+		Log.Add(TEXT("SML FVersion"), NumMods, TEXT("ms"), SmlMs);
+		Log.Add(TEXT("SML FVersion"), NumMods, TEXT("allocations"), SmlAllocations);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,39 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "Misc/AutomationTest.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "MUNStats.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMUNCheckReportCsvTest, "ModUpdateNotifier.CheckReport.Csv",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMUNCheckReportCsvTest::RunTest(const FString& Parameters)
+{
+	FMUNCheckReport& Report = FMUNCheckReport::Get();
+	Report.Reset();
+	Report.RecordRequest(TEXT("https://example.com/v1/mod/A?limit=10,20"), 0.5, 100, 1, true);
+	Report.RecordRequest(TEXT("say \"hi\""), 0.5, 100, 1, true);
+	Report.RecordModRetrieved(TEXT("PlainMod"), false);
+
+	const FString CsvPath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("ModUpdateNotifier"), TEXT("CheckReport.csv"));
+	TestTrue(TEXT("CSV written"), Report.WriteCsv(CsvPath));
+
+	TArray<FString> Lines;
+	FFileHelper::LoadFileToStringArray(Lines, *CsvPath);
+	IFileManager::Get().Delete(*CsvPath, false, false, true);
+	Report.Reset();
+
+	if (TestEqual(TEXT("Header and one line per sample"), Lines.Num(), 4))
+	{
+		TestEqual(TEXT("Fields with a separator are quoted"), Lines[1], FString(TEXT("request,\"https://example.com/v1/mod/A?limit=10,20\",500.000,1,100,1")));
+		TestEqual(TEXT("Quotes are doubled"), Lines[2], FString(TEXT("request,\"say \"\"hi\"\"\",500.000,1,100,1")));
+		TestTrue(TEXT("Plain fields are left alone"), Lines[3].StartsWith(TEXT("mod,PlainMod,")));
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,248 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNTestApiServer.h"
+
+#include "HttpPath.h"
+#include "HttpServerModule.h"
+#include "HttpServerRequest.h"
+#include "HttpServerResponse.h"
+#include "IHttpRouter.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Misc/Compression.h"
+#include "Misc/Parse.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "MUNTestPayloads.h"
+
+namespace
+{
+	// Reads the number after the first "<Name>: " in a query, the way the checker formats its filters
+	int32 ReadQueryNumber(const FString& Query, const TCHAR* Name, const int32 Default)
+	{
+		const FString Key = FString(Name) + TEXT(": ");
+		const int32 Index = Query.Find(Key, ESearchCase::CaseSensitive);
+		return Index == INDEX_NONE ? Default : FCString::Atoi(*Query + Index + Key.Len());
+	}
+}
+
+FMUNTestApiServer::FMUNTestApiServer()
+{
+	FParse::Value(FCommandLine::Get(), TEXT("MUNTestApiPort="), Port);
+}
+
+FMUNTestApiServer::~FMUNTestApiServer()
+{
+	if (Router.IsValid())
+	{
+		for (const FHttpRouteHandle& Route : Routes)
+		{
+			Router->UnbindRoute(Route);
+		}
+	}
+}
+
+bool FMUNTestApiServer::Start()
+{
+	Router = FHttpServerModule::Get().GetHttpRouter(Port);
+	if (!Router.IsValid())
+	{
+		return false;
+	}
+
+	// The routes only hold a weak reference, so a test that ends early leaves nothing behind that could answer for it
+	const TWeakPtr<FMUNTestApiServer> WeakThis = AsShared();
+
+	// Bound to the prefix, so it receives /v1/mod/<reference>/versions and /v1/mod/<reference>/versions/all
+	Routes.Add(Router->BindRoute(FHttpPath(TEXT("/v1/mod")), EHttpServerRequestVerbs::VERB_GET, [WeakThis](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+	{
+		const TSharedPtr<FMUNTestApiServer> This = WeakThis.Pin();
+		return This.IsValid() && This->HandleVersions(Request, OnComplete);
+	}));
+
+	Routes.Add(Router->BindRoute(FHttpPath(TEXT("/v2/query")), EHttpServerRequestVerbs::VERB_POST, [WeakThis](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+	{
+		const TSharedPtr<FMUNTestApiServer> This = WeakThis.Pin();
+		return This.IsValid() && This->HandleQuery(Request, OnComplete);
+	}));
+
+	// A route that is still bound by another server on the same port can't be bound again
+	if (!Routes[0].IsValid() || !Routes[1].IsValid())
+	{
+		return false;
+	}
+
+	FHttpServerModule::Get().StartAllListeners();
+	return true;
+}
+
+void FMUNTestApiServer::AddMod(const FString& ModReference, const TArray<FString>& Versions, const FString& GameVersion)
+{
+	Mods.Add(ModReference, {Versions, GameVersion, FDateTime::UtcNow()});
+}
+
+FString FMUNTestApiServer::GetBaseURL() const
+{
+	return FString::Printf(TEXT("http://127.0.0.1:%u"), Port);
+}
+
+bool FMUNTestApiServer::HandleVersions(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+{
+	TArray<FString> Segments;
+	Request.RelativePath.GetPath().ParseIntoArray(Segments, TEXT("/"));
+
+	// The mod reference is the segment before "versions", wherever the router's prefix ends
+	const int32 VersionsIndex = Segments.Find(TEXT("versions"));
+	const FMod* Mod = VersionsIndex > 0 ? Mods.Find(Segments[VersionsIndex - 1]) : nullptr;
+	if (!Mod)
+	{
+		NumRequests++;
+		OnComplete(FHttpServerResponse::Error(EHttpServerResponseCodes::NotFound));
+		return true;
+	}
+
+	int32 Limit = Mod->Versions.Num();
+	if (Segments.Last() != TEXT("all"))
+	{
+		if (const FString* LimitParam = Request.QueryParams.Find(TEXT("limit")))
+		{
+			Limit = FMath::Clamp(FCString::Atoi(**LimitParam), 0, Limit);
+		}
+	}
+
+	Respond(OnComplete, FMUNTestPayloads::MakeVersionsAll(TConstArrayView<FString>(Mod->Versions.GetData(), Limit), Mod->GameVersion));
+	return true;
+}
+
+bool FMUNTestApiServer::HandleQuery(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+{
+	const FUTF8ToTCHAR Body(reinterpret_cast<const ANSICHAR*>(Request.Body.GetData()), Request.Body.Num());
+
+	TSharedPtr<FJsonObject> RequestObject;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FString(Body.Length(), Body.Get()));
+	FString Query;
+	const TSharedPtr<FJsonObject>* Variables = nullptr;
+	const TArray<TSharedPtr<FJsonValue>>* References = nullptr;
+
+	if (!FJsonSerializer::Deserialize(Reader, RequestObject) || !RequestObject.IsValid() || !RequestObject->TryGetStringField(TEXT("query"), Query)
+		|| !RequestObject->TryGetObjectField(TEXT("variables"), Variables) || !(*Variables)->TryGetArrayField(TEXT("references"), References))
+	{
+		NumRequests++;
+		OnComplete(FHttpServerResponse::Error(EHttpServerResponseCodes::BadRequest));
+		return true;
+	}
+
+	TArray<FString> ModReferences;
+	for (const TSharedPtr<FJsonValue>& Reference : *References)
+	{
+		if (Mods.Contains(Reference->AsString()))
+		{
+			ModReferences.Add(Reference->AsString());
+		}
+	}
+
+	// Updated mods query: a page of the requested mods, most recently released first
+	if (Query.Contains(TEXT("last_version_date")))
+	{
+		ModReferences.Sort([this](const FString& Left, const FString& Right)
+		{
+			return Mods[Left].LastVersionDate > Mods[Right].LastVersionDate;
+		});
+
+		const int32 Offset = FMath::Clamp(ReadQueryNumber(Query, TEXT("offset"), 0), 0, ModReferences.Num());
+		const int32 Limit = FMath::Clamp(ReadQueryNumber(Query, TEXT("limit"), ModReferences.Num()), 0, ModReferences.Num() - Offset);
+
+		TArray<FString> ModObjects;
+		for (int32 ModIndex = Offset; ModIndex < Offset + Limit; ModIndex++)
+		{
+			ModObjects.Add(FString::Printf(TEXT("{\"mod_reference\":\"%s\",\"last_version_date\":\"%s\"}"), *ModReferences[ModIndex], *Mods[ModReferences[ModIndex]].LastVersionDate.ToIso8601()));
+		}
+		Respond(OnComplete, FMUNTestPayloads::MakeGetMods(ModObjects));
+		return true;
+	}
+
+	// Changelog queries aren't served, and version queries fail on request so the REST fallback can be tested
+	const int32 VersionsIndex = Query.Find(TEXT("versions("), ESearchCase::CaseSensitive);
+	if (VersionsIndex == INDEX_NONE || Settings.bFailBatchedQueries)
+	{
+		Respond(OnComplete, TEXT("{\"errors\":[{\"message\":\"Not served by the test API\"}],\"data\":null}"));
+		return true;
+	}
+
+	// The first limit of the query belongs to getMods, the window is the limit of the versions filter
+	const int32 VersionWindow = ReadQueryNumber(Query.Mid(VersionsIndex), TEXT("limit"), MAX_int32);
+
+	TArray<FString> ModObjects;
+	for (const FString& ModReference : ModReferences)
+	{
+		const FMod& Mod = Mods[ModReference];
+		ModObjects.Add(FMUNTestPayloads::MakeBatchedMod(ModReference, TConstArrayView<FString>(Mod.Versions.GetData(), FMath::Min(VersionWindow, Mod.Versions.Num())), Mod.GameVersion));
+	}
+	Respond(OnComplete, FMUNTestPayloads::MakeGetMods(ModObjects));
+	return true;
+}
+
+void FMUNTestApiServer::Respond(const FHttpResultCallback& OnComplete, const FString& Body)
+{
+	NumRequests++;
+
+	const bool bFail = Settings.FailEveryNthRequest > 0 && NumRequests % Settings.FailEveryNthRequest == 0;
+
+	TArray<uint8> Bytes = FMUNTestPayloads::ToUtf8(Body);
+	bool bGzipped = false;
+	if (!bFail && Settings.bGzip)
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Gzip, Bytes.Num());
+		TArray<uint8> Compressed;
+		Compressed.SetNumUninitialized(CompressedSize);
+		if (FCompression::CompressMemory(NAME_Gzip, Compressed.GetData(), CompressedSize, Bytes.GetData(), Bytes.Num()))
+		{
+			Compressed.SetNum(CompressedSize);
+			Bytes = MoveTemp(Compressed);
+			bGzipped = true;
+		}
+	}
+
+	if (!bFail)
+	{
+		BytesServed += Bytes.Num();
+	}
+
+	// Built when it is sent, the delayed response has to be copyable to sit in a ticker
+	auto Send = [OnComplete, Bytes = MoveTemp(Bytes), bFail, bGzipped]()
+	{
+		if (bFail)
+		{
+			OnComplete(FHttpServerResponse::Error(EHttpServerResponseCodes::ServerError));
+			return;
+		}
+
+		TArray<uint8> ResponseBytes = Bytes;
+		TUniquePtr<FHttpServerResponse> Response = FHttpServerResponse::Create(MoveTemp(ResponseBytes), TEXT("application/json"));
+		if (bGzipped)
+		{
+			Response->Headers.Add(TEXT("Content-Encoding"), {TEXT("gzip")});
+		}
+		OnComplete(MoveTemp(Response));
+	};
+
+	if (Settings.LatencySeconds <= 0.0f)
+	{
+		Send();
+		return;
+	}
+
+	NumInFlight++;
+	MaxInFlight = FMath::Max(MaxInFlight, NumInFlight);
+
+	const TWeakPtr<FMUNTestApiServer> WeakThis = AsShared();
+	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis, Send](float)
+	{
+		if (const TSharedPtr<FMUNTestApiServer> This = WeakThis.Pin())
+		{
+			This->NumInFlight--;
+		}
+		Send();
+		return false;
+	}), Settings.LatencySeconds);
+}
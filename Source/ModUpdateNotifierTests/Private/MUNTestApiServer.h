@@ -0,0 +1,71 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HttpResultCallback.h"
+#include "HttpRouteHandle.h"
+
+class IHttpRouter;
+struct FHttpServerRequest;
+
+// How the stand-in misbehaves, changeable between requests
+struct FMUNTestApiSettings
+{
+	float LatencySeconds = 0.0f; // Added before every response
+	int32 FailEveryNthRequest = 0; // Every Nth request is answered with a 500, 0 to never fail
+	bool bFailBatchedQueries = false; // Answer every version query with GraphQL errors, so checks fall back to the REST API
+	bool bGzip = false; // Gzip response bodies like SMR does for clients that accept it
+};
+
+// Local stand-in for the SMR endpoints the update check uses: /v1/mod/<reference>/versions(/all) and the getMods queries
+// of /v2/query. Serves the mods added to it on 127.0.0.1, so tests and benchmarks run without the network.
+// Only used on the game thread, which also ticks the HTTP server.
+class FMUNTestApiServer : public TSharedFromThis<FMUNTestApiServer>
+{
+public:
+	// Used unless the command line picks another port with -MUNTestApiPort=
+	static constexpr uint32 DefaultPort = 17860;
+
+	FMUNTestApiServer();
+	~FMUNTestApiServer();
+
+	// Binds the routes and starts listening, returns false if the port can't be used
+	bool Start();
+
+	// Versions are listed newest first, the way SMR orders them
+	void AddMod(const FString& ModReference, const TArray<FString>& Versions, const FString& GameVersion = TEXT(">=0"));
+
+	// What to pass as the API base URL of a check
+	FString GetBaseURL() const;
+
+	int32 GetNumRequests() const { return NumRequests; }
+	int64 GetBytesServed() const { return BytesServed; } // Body bytes as sent, after gzip
+	int32 GetMaxInFlight() const { return MaxInFlight; } // Most requests waiting for their response at once, only meaningful with latency
+
+	FMUNTestApiSettings Settings;
+
+private:
+	struct FMod
+	{
+		TArray<FString> Versions;
+		FString GameVersion;
+		FDateTime LastVersionDate;
+	};
+
+	bool HandleVersions(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+	bool HandleQuery(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+
+	// Applies the failure and latency settings, then completes the request with Body
+	void Respond(const FHttpResultCallback& OnComplete, const FString& Body);
+
+	uint32 Port = DefaultPort;
+	TSharedPtr<IHttpRouter> Router;
+	TArray<FHttpRouteHandle> Routes;
+
+	TMap<FString, FMod> Mods;
+	int32 NumRequests = 0;
+	int64 BytesServed = 0;
+	int32 NumInFlight = 0;
+	int32 MaxInFlight = 0;
+};
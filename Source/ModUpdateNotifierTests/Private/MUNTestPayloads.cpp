@@ -0,0 +1,253 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "MUNTestPayloads.h"
+
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+
+namespace
+{
+	// Forwards everything to the allocator it was put in front of, counting allocations along the way
+	class FMUNCountingMalloc final : public FMalloc
+	{
+	public:
+		FMalloc* Inner = nullptr;
+		uint32 ThreadId = 0; // Thread whose allocations are counted, 0 for every thread
+		std::atomic<int64> NumAllocations = 0;
+		std::atomic<int64> NumBytes = 0;
+		std::atomic<int64> LiveBytes = 0;
+		std::atomic<int64> PeakBytes = 0;
+
+		virtual void* Malloc(const SIZE_T Count, const uint32 Alignment) override
+		{
+			void* Result = Inner->Malloc(Count, Alignment);
+			if (IsCounted())
+			{
+				NumAllocations.fetch_add(1, std::memory_order_relaxed);
+				NumBytes.fetch_add(Count, std::memory_order_relaxed);
+				AddLiveBytes(GetSize(Result));
+			}
+			return Result;
+		}
+
+		virtual void* Realloc(void* Original, const SIZE_T Count, const uint32 Alignment) override
+		{
+			if (!IsCounted())
+			{
+				return Inner->Realloc(Original, Count, Alignment);
+			}
+
+			// Growing a block may move it, so it counts as an allocation
+			const int64 OriginalSize = GetSize(Original);
+			void* Result = Inner->Realloc(Original, Count, Alignment);
+			if (Count > 0)
+			{
+				NumAllocations.fetch_add(1, std::memory_order_relaxed);
+				NumBytes.fetch_add(Count, std::memory_order_relaxed);
+			}
+			AddLiveBytes(GetSize(Result) - OriginalSize);
+			return Result;
+		}
+
+		virtual void Free(void* Original) override
+		{
+			if (IsCounted())
+			{
+				AddLiveBytes(-GetSize(Original));
+			}
+			Inner->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(const SIZE_T Count, const uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(const bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+	private:
+		bool IsCounted() const
+		{
+			return ThreadId == 0 || FPlatformTLS::GetCurrentThreadId() == ThreadId;
+		}
+
+		int64 GetSize(void* Original) const
+		{
+			SIZE_T Size = 0;
+			return Original && Inner->GetAllocationSize(Original, Size) ? static_cast<int64>(Size) : 0;
+		}
+
+		void AddLiveBytes(const int64 Delta)
+		{
+			const int64 Live = LiveBytes.fetch_add(Delta, std::memory_order_relaxed) + Delta;
+			int64 Peak = PeakBytes.load(std::memory_order_relaxed);
+			while (Live > Peak && !PeakBytes.compare_exchange_weak(Peak, Live, std::memory_order_relaxed))
+			{
+			}
+		}
+	};
+
+	// Never destroyed, another thread can still be inside it right after GMalloc has been restored
+	FMUNCountingMalloc& GetCountingMalloc()
+	{
+		static FMUNCountingMalloc* CountingMalloc = new FMUNCountingMalloc();
+		return *CountingMalloc;
+	}
+}
+
+FString FMUNTestPayloads::MakeModReference(const int32 ModIndex)
+{
+	return FString::Printf(TEXT("TestMod%04d"), ModIndex);
+}
+
+TArray<FString> FMUNTestPayloads::MakeVersions(const int32 NumVersions)
+{
+	TArray<FString> Versions;
+	for (int32 Minor = NumVersions - 1; Minor >= 0; Minor--)
+	{
+		Versions.Add(FString::Printf(TEXT("1.%d.0"), Minor));
+	}
+	return Versions;
+}
+
+FString FMUNTestPayloads::MakeVersionsAll(const TConstArrayView<FString> Versions, const FString& GameVersion)
+{
+	FString Payload = TEXT("{\"success\":true,\"data\":[");
+	for (int32 VersionIndex = 0; VersionIndex < Versions.Num(); VersionIndex++)
+	{
+		Payload += FString::Printf(TEXT("%s{\"id\":\"v%d\",\"version\":\"%s\",\"game_version\":\"%s\",\"changelog\":\"Fixed \\\"things\\\"\\nand more\",")
+			TEXT("\"downloads\":%d,\"stability\":\"release\",\"dependencies\":[{\"mod_id\":\"SML\",\"condition\":\"^3.12.0\",\"optional\":false}],")
+			TEXT("\"created_at\":\"2025-01-01T00:00:00.000Z\"}"),
+			VersionIndex > 0 ? TEXT(",") : TEXT(""), VersionIndex, *Versions[VersionIndex], *GameVersion, 1000 + VersionIndex);
+	}
+	Payload += TEXT("]}");
+	return Payload;
+}
+
+FString FMUNTestPayloads::MakeBatchedVersions(const TConstArrayView<FString> ModReferences, const TConstArrayView<FString> Versions)
+{
+	TArray<FString> ModObjects;
+	for (const FString& ModReference : ModReferences)
+	{
+		ModObjects.Add(MakeBatchedMod(ModReference, Versions));
+	}
+	return MakeGetMods(ModObjects);
+}
+
+FString FMUNTestPayloads::MakeBatchedMod(const FString& ModReference, const TConstArrayView<FString> Versions, const FString& GameVersion)
+{
+	FString VersionList;
+	for (int32 VersionIndex = 0; VersionIndex < Versions.Num(); VersionIndex++)
+	{
+		VersionList += FString::Printf(TEXT("%s{\"version\":\"%s\",\"game_version\":\"%s\"}"), VersionIndex > 0 ? TEXT(",") : TEXT(""), *Versions[VersionIndex], *GameVersion);
+	}
+
+	// SMR escapes the slashes of URLs
+	return FString::Printf(TEXT("{\"mod_reference\":\"%s\",\"logo\":\"https:\\/\\/storage.ficsit.app\\/images\\/mods\\/%s\\/logo.webp\",\"versions\":[%s]}"), *ModReference, *ModReference, *VersionList);
+}
+
+FString FMUNTestPayloads::MakeGetMods(const TConstArrayView<FString> ModObjects)
+{
+	return TEXT("{\"data\":{\"getMods\":{\"mods\":[") + FString::Join(ModObjects, TEXT(",")) + TEXT("]}}}");
+}
+
+FString FMUNTestPayloads::MakeLastVersionDates(const TConstArrayView<FString> ModReferences, const FDateTime& LastVersionDate)
+{
+	TArray<FString> ModObjects;
+	for (const FString& ModReference : ModReferences)
+	{
+		ModObjects.Add(FString::Printf(TEXT("{\"mod_reference\":\"%s\",\"last_version_date\":\"%s\"}"), *ModReference, *LastVersionDate.ToIso8601()));
+	}
+	return MakeGetMods(ModObjects);
+}
+
+TArray<uint8> FMUNTestPayloads::ToUtf8(const FString& Text)
+{
+	const FTCHARToUTF8 Utf8(*Text);
+	return TArray<uint8>(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+}
+
+FMUNBenchmarkLog::FMUNBenchmarkLog(FAutomationTestBase& InTest, const FString& InName)
+	: Test(InTest)
+	, Name(InName)
+	, Csv(TEXT("case,mods,metric,value\n"))
+{
+}
+
+FMUNBenchmarkLog::~FMUNBenchmarkLog()
+{
+	const FString CsvPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ModUpdateNotifier"), TEXT("Benchmarks"), Name + TEXT(".csv"));
+	if (FFileHelper::SaveStringToFile(Csv, *CsvPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		Test.AddInfo(FString::Printf(TEXT("Benchmark results written to %s"), *CsvPath));
+	}
+}
+
+void FMUNBenchmarkLog::Add(const FString& Case, const int32 NumMods, const FString& Metric, const double Value)
+{
+	Test.AddInfo(FString::Printf(TEXT("%s, %d mods: %s %.3f"), *Case, NumMods, *Metric, Value));
+	Csv += FString::Printf(TEXT("%s,%d,%s,%.6f\n"), *Case, NumMods, *Metric, Value);
+}
+
+double FMUNBenchmarkLog::MedianMilliseconds(const int32 Iterations, const TFunctionRef<void()> Work)
+{
+	TArray<double> Times;
+	for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Work();
+		Times.Add((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+
+	Times.Sort();
+	return Times.IsEmpty() ? 0.0 : Times[Times.Num() / 2];
+}
+
+FMUNAllocationCounter::FMUNAllocationCounter(const bool bAllThreads)
+{
+	FMUNCountingMalloc& CountingMalloc = GetCountingMalloc();
+	check(GMalloc != &CountingMalloc);
+
+	CountingMalloc.Inner = GMalloc;
+	CountingMalloc.ThreadId = bAllThreads ? 0 : FPlatformTLS::GetCurrentThreadId();
+	CountingMalloc.NumAllocations = 0;
+	CountingMalloc.NumBytes = 0;
+	CountingMalloc.LiveBytes = 0;
+	CountingMalloc.PeakBytes = 0;
+	GMalloc = &CountingMalloc;
+}
+
+FMUNAllocationCounter::~FMUNAllocationCounter()
+{
+	GMalloc = GetCountingMalloc().Inner;
+}
+
+int64 FMUNAllocationCounter::GetNumAllocations() const
+{
+	return GetCountingMalloc().NumAllocations.load();
+}
+
+int64 FMUNAllocationCounter::GetNumBytes() const
+{
+	return GetCountingMalloc().NumBytes.load();
+}
+
+int64 FMUNAllocationCounter::GetPeakBytes() const
+{
+	return GetCountingMalloc().PeakBytes.load();
+}
+
+int64 FMUNAllocationCounter::Count(const TFunctionRef<void()> Work)
+{
+	const FMUNAllocationCounter Counter;
+	Work();
+	return Counter.GetNumAllocations();
+}
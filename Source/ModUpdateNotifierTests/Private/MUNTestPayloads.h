@@ -0,0 +1,73 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FAutomationTestBase;
+
+// Builds SMR responses shaped like the real ones, for the reader tests and the local API stand-in.
+// Every version supports any game version unless stated otherwise.
+struct FMUNTestPayloads
+{
+	// Mod counts the benchmarks are run at
+	static constexpr int32 BenchmarkScales[] = {10, 100, 300, 1000};
+
+	static FString MakeModReference(int32 ModIndex);
+
+	// NumVersions versions, newest first: 1.<NumVersions - 1>.0 down to 1.0.0
+	static TArray<FString> MakeVersions(int32 NumVersions);
+
+	// A /v1/mod/<reference>/versions response. Every version carries the fields SMR sends too, so readers have to skip them.
+	static FString MakeVersionsAll(TConstArrayView<FString> Versions, const FString& GameVersion = TEXT(">=0"));
+
+	// A batched getMods response listing Versions for every mod
+	static FString MakeBatchedVersions(TConstArrayView<FString> ModReferences, TConstArrayView<FString> Versions);
+
+	// A single mod of a batched getMods response, and the response wrapped around such mods
+	static FString MakeBatchedMod(const FString& ModReference, TConstArrayView<FString> Versions, const FString& GameVersion = TEXT(">=0"));
+	static FString MakeGetMods(TConstArrayView<FString> ModObjects);
+
+	// An updated mods getMods response, every mod released at LastVersionDate
+	static FString MakeLastVersionDates(TConstArrayView<FString> ModReferences, const FDateTime& LastVersionDate);
+
+	static TArray<uint8> ToUtf8(const FString& Text);
+};
+
+// Collects benchmark results, logs them with the test and writes them to Saved/ModUpdateNotifier/Benchmarks/<Name>.csv
+class FMUNBenchmarkLog
+{
+public:
+	FMUNBenchmarkLog(FAutomationTestBase& InTest, const FString& InName);
+	~FMUNBenchmarkLog();
+
+	void Add(const FString& Case, int32 NumMods, const FString& Metric, double Value);
+
+	// Runs Work Iterations times and returns the median time of a run in milliseconds
+	static double MedianMilliseconds(int32 Iterations, TFunctionRef<void()> Work);
+
+private:
+	FAutomationTestBase& Test;
+	FString Name;
+	FString Csv;
+};
+
+// Counts heap allocations while in scope by putting a forwarding allocator in front of GMalloc. Only the thread that created
+// it is counted, unless bAllThreads is set for work spread over workers. One counter at a time.
+class FMUNAllocationCounter
+{
+public:
+	explicit FMUNAllocationCounter(bool bAllThreads = false);
+	~FMUNAllocationCounter();
+
+	int64 GetNumAllocations() const;
+
+	// Bytes asked for by the counted allocations, reallocations included
+	int64 GetNumBytes() const;
+
+	// Highest growth of the heap over the start, counting what was freed in between
+	int64 GetPeakBytes() const;
+
+	// Runs Work once and returns the allocations it made on the calling thread
+	static int64 Count(TFunctionRef<void()> Work);
+};
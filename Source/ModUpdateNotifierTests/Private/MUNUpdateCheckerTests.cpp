@@ -0,0 +1,380 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "Misc/AutomationTest.h"
+#include "TimerManager.h"
+#include "Containers/Ticker.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "ModLoading/ModLoadingLibrary.h"
+#include "UObject/StrongObjectPtr.h"
+#include "MUNMenuModule.h"
+#include "MUNStats.h"
+#include "MUNTestApiServer.h"
+#include "MUNTestPayloads.h"
+#include "MUNUpdateChecker.h"
+#include "MUNUpdateSubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// Every check gets a cache file of its own, so no test sees results of another or of the game
+	FString MakeCacheFilePath()
+	{
+		return FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("ModUpdateNotifier"), FGuid::NewGuid().ToString() + TEXT(".json"));
+	}
+
+	FMUNModRecord MakeRecord(const FString& ModReference, const FVersion& InstalledVersion)
+	{
+		FMUNModRecord ModRecord;
+		ModRecord.ModReference = ModReference;
+		ModRecord.FriendlyName = ModReference;
+		ModRecord.InstalledVersion = InstalledVersion;
+		return ModRecord;
+	}
+
+	// Every mod is installed at 1.0.0 and has NumVersions versions on the test API
+	FMUNModTable AddMods(FMUNTestApiServer& Server, const int32 NumMods, const int32 NumVersions)
+	{
+		const TArray<FString> Versions = FMUNTestPayloads::MakeVersions(NumVersions);
+
+		FMUNModTable ModTable;
+		for (int32 ModIndex = 0; ModIndex < NumMods; ModIndex++)
+		{
+			const FString ModReference = FMUNTestPayloads::MakeModReference(ModIndex);
+			Server.AddMod(ModReference, Versions);
+			ModTable.Add(MakeRecord(ModReference, FVersion{1, 0, 0}));
+		}
+		return ModTable;
+	}
+
+	// Runs a check against the test API with a cache of its own, and cleans up after it
+	struct FMUNTestCheck
+	{
+		TStrongObjectPtr<UMUNUpdateChecker> Checker;
+		TSharedPtr<FMUNVersionCache> VersionCache;
+		FString CacheFilePath;
+		FMUNCheckSettings Settings; // Tests that change these initialize the checker again before starting it
+
+		FMUNTestCheck(const FMUNTestApiServer& Server, const int32 MaxConcurrentRequests = FMUNRequestSettings().MaxConcurrentRequests)
+			: Checker(NewObject<UMUNUpdateChecker>())
+			, CacheFilePath(MakeCacheFilePath())
+		{
+			Settings.APIBaseURL = Server.GetBaseURL();
+			Settings.VersionCacheTTL = FTimespan::FromMinutes(FMUNCheckSettings::DefaultVersionCacheTTLMinutes);
+			Settings.RequestSettings.MaxConcurrentRequests = MaxConcurrentRequests;
+			Settings.RequestSettings.TimeoutSeconds = 10.0f;
+			Settings.RequestSettings.BaseBackoffSeconds = 0.01f;
+			Settings.RequestSettings.MaxBackoffSeconds = 0.05f;
+			Settings.bRecordBaseline = false;
+			Settings.bRecordReport = true;
+
+			VersionCache = MakeShared<FMUNVersionCache>(CacheFilePath);
+			Checker->Initialize(Settings, VersionCache.ToSharedRef());
+		}
+
+		~FMUNTestCheck()
+		{
+			Checker->CancelPendingRequests();
+			VersionCache->Flush();
+			IFileManager::Get().Delete(*CacheFilePath, false, false, true);
+		}
+	};
+}
+
+BEGIN_DEFINE_SPEC(FMUNUpdateCheckerSpec, "ModUpdateNotifier.UpdateChecker",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+	TSharedPtr<FMUNTestApiServer> Server;
+	TSharedPtr<FMUNTestCheck> Check;
+
+	// Every mod is expected to have 1.<NumVersions - 1>.0 as its remote version
+	void TestAllRetrieved(const int32 NumVersions)
+	{
+		const FMUNModTable& ModTable = Check->Checker->GetModTable();
+		const FVersion Expected = {1, NumVersions - 1, 0};
+
+		TestTrue(TEXT("Check is complete"), Check->Checker->IsComplete());
+		for (int32 RecordIndex = 0; RecordIndex < ModTable.Num(); RecordIndex++)
+		{
+			const FMUNModRecord& ModRecord = ModTable.Records[RecordIndex];
+			TestTrue(FString::Printf(TEXT("%s has its newest version"), *ModRecord.ModReference), ModRecord.APIVersion.Compare(Expected) == 0);
+			TestTrue(FString::Printf(TEXT("%s has an update"), *ModRecord.ModReference), Check->Checker->IsUpdateAvailable(RecordIndex));
+		}
+	}
+
+END_DEFINE_SPEC(FMUNUpdateCheckerSpec)
+
+void FMUNUpdateCheckerSpec::Define()
+{
+	BeforeEach([this]()
+	{
+		Server = MakeShared<FMUNTestApiServer>();
+		TestTrue(TEXT("Test API started"), Server->Start());
+	});
+
+	AfterEach([this]()
+	{
+		Check.Reset();
+		Server.Reset();
+	});
+
+	LatentIt(TEXT("finds updates in batched queries and respects the ranges of dependents"), FTimespan::FromSeconds(30), [this](const FDoneDelegate& Done)
+	{
+		// More mods than fit in a single batch
+		FMUNModTable ModTable = AddMods(*Server, 120, 5);
+
+		const FString LockedMod = TEXT("LockedMod");
+		Server->AddMod(LockedMod, {TEXT("2.0.0"), TEXT("1.5.0"), TEXT("1.0.0")});
+		ModTable.Add(MakeRecord(LockedMod, FVersion{1, 0, 0}));
+
+		FVersionRange Range;
+		FString Error;
+		Range.ParseVersionRange(TEXT("^1.0.0"), Error);
+		FMUNDependencyGraph Graph;
+		Graph.AddDependency(FName(*LockedMod), TEXT("Dependent"), Range);
+
+		Check = MakeShared<FMUNTestCheck>(*Server);
+		Check->Checker->OnCheckComplete.AddLambda([this, Done, LockedMod]()
+		{
+			const FMUNModTable& Results = Check->Checker->GetModTable();
+			const int32 LockedIndex = Results.IndexOf(LockedMod);
+			if (TestNotEqual(TEXT("Locked mod is in the table"), LockedIndex, static_cast<int32>(INDEX_NONE)))
+			{
+				TestTrue(TEXT("Remote version is the newest"), Results.Records[LockedIndex].APIVersion.Compare(FVersion{2, 0, 0}) == 0);
+				TestTrue(TEXT("Update is the newest version the dependent allows"), Results.Records[LockedIndex].CompatibleVersion.Compare(FVersion{1, 5, 0}) == 0);
+				TestTrue(TEXT("Mod is locked by its dependent"), Results.IsLocked(LockedIndex));
+			}
+
+			TestEqual(TEXT("Version queries"), Server->GetNumRequests(), 3);
+			TestEqual(TEXT("Mods retrieved"), FMUNCheckReport::Get().GetNumModsRetrieved(), Results.Num());
+			Done.Execute();
+		});
+		Check->Checker->StartCheck(MoveTemp(ModTable), FString(), Graph);
+	});
+
+	LatentIt(TEXT("retries requests the API fails"), FTimespan::FromSeconds(30), [this](const FDoneDelegate& Done)
+	{
+		Server->Settings.FailEveryNthRequest = 2;
+		FMUNModTable ModTable = AddMods(*Server, 120, 5);
+
+		Check = MakeShared<FMUNTestCheck>(*Server);
+		Check->Checker->OnCheckComplete.AddLambda([this, Done]()
+		{
+			TestAllRetrieved(5);
+			TestTrue(TEXT("Failed queries were sent again"), Server->GetNumRequests() > 3);
+			Done.Execute();
+		});
+		Check->Checker->StartCheck(MoveTemp(ModTable));
+	});
+
+	LatentIt(TEXT("falls back to the REST API when batched queries fail"), FTimespan::FromSeconds(30), [this](const FDoneDelegate& Done)
+	{
+		Server->Settings.bFailBatchedQueries = true;
+		FMUNModTable ModTable = AddMods(*Server, 20, 5);
+
+		Check = MakeShared<FMUNTestCheck>(*Server);
+		Check->Checker->OnCheckComplete.AddLambda([this, Done]()
+		{
+			TestAllRetrieved(5);
+			TestEqual(TEXT("One batched query and one REST request per mod"), Server->GetNumRequests(), 1 + 20);
+			Done.Execute();
+		});
+		Check->Checker->StartCheck(MoveTemp(ModTable));
+	});
+
+	LatentIt(TEXT("falls back to the cached versions when the API keeps answering with errors"), FTimespan::FromSeconds(30), [this](const FDoneDelegate& Done)
+	{
+		// Every request fails with a 500, the batched query as well as the REST requests it falls back to
+		Server->Settings.FailEveryNthRequest = 1;
+		FMUNModTable ModTable = AddMods(*Server, 5, 5);
+
+		// Every cached entry is stale, so each mod is asked for
+		Check = MakeShared<FMUNTestCheck>(*Server);
+		Check->Settings.VersionCacheTTL = FTimespan::Zero();
+		Check->Checker->Initialize(Check->Settings, Check->VersionCache.ToSharedRef());
+
+		Check->VersionCache->LoadAsync([this, Done, ModTable = MoveTemp(ModTable)]() mutable
+		{
+			for (const FMUNModRecord& ModRecord : ModTable.Records)
+			{
+				Check->VersionCache->UpdateVersion(ModRecord.ModReference, {FVersion{1, 2, 0}});
+			}
+
+			Check->Checker->OnCheckComplete.AddLambda([this, Done]()
+			{
+				const FMUNModTable& Results = Check->Checker->GetModTable();
+				for (const FMUNModRecord& ModRecord : Results.Records)
+				{
+					TestTrue(FString::Printf(TEXT("%s keeps its cached version"), *ModRecord.ModReference), ModRecord.APIVersion.Compare(FVersion{1, 2, 0}) == 0);
+				}
+				Done.Execute();
+			});
+			Check->Checker->StartCheck(MoveTemp(ModTable));
+		});
+	});
+
+	LatentIt(TEXT("runs headless with the request limit of dedicated servers"), FTimespan::FromSeconds(30), [this](const FDoneDelegate& Done)
+	{
+		// Like StartServerCheck: no world, no UI, at most two requests at once. The latency keeps requests in flight long
+		// enough for the server to see how many overlap.
+		Server->Settings.LatencySeconds = 0.05f;
+		Server->Settings.bFailBatchedQueries = true;
+		FMUNModTable ModTable = AddMods(*Server, 10, 5);
+
+		Check = MakeShared<FMUNTestCheck>(*Server, 2);
+		Check->Checker->OnCheckComplete.AddLambda([this, Done]()
+		{
+			TestAllRetrieved(5);
+			TestTrue(TEXT("At most two requests in flight"), Server->GetMaxInFlight() <= 2);
+			Done.Execute();
+		});
+		Check->Checker->StartCheck(MoveTemp(ModTable));
+	});
+}
+
+BEGIN_DEFINE_SPEC(FMUNUpdateCheckerBenchmark, "ModUpdateNotifier.Benchmarks.UpdateCheck",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+	// Added to every response, about the round trip to the real API
+	static constexpr float LatencySeconds = 0.05f;
+
+	TSharedPtr<FMUNTestApiServer> Server;
+	TStrongObjectPtr<UGameInstance> GameInstance; // A session of its own, the game's has run its one menu check already
+	TStrongObjectPtr<UMUNMenuModule> MenuModule;
+	FString CacheFilePath;
+	TSharedPtr<FMUNBenchmarkLog> Log;
+	TUniquePtr<FMUNAllocationCounter> AllocationCounter;
+	FTSTicker::FDelegateHandle PollHandle;
+
+	// Checks for updates through the menu module the way the main menu does, and logs how long it took to show the
+	// notification to Name. Generated mods are handed to the session's check first, without them the installed mods are scanned.
+	void RunUntilNotification(const FString& Name, const FString& Case, TOptional<FMUNModTable> GeneratedMods, const FDoneDelegate& Done);
+
+END_DEFINE_SPEC(FMUNUpdateCheckerBenchmark)
+
+void FMUNUpdateCheckerBenchmark::Define()
+{
+	BeforeEach([this]()
+	{
+		Server = MakeShared<FMUNTestApiServer>();
+		Server->Settings.LatencySeconds = LatencySeconds;
+		Server->Settings.bGzip = true;
+		TestTrue(TEXT("Test API started"), Server->Start());
+
+		GameInstance.Reset(NewObject<UGameInstance>(GEngine));
+		GameInstance->InitializeStandalone();
+
+		CacheFilePath = MakeCacheFilePath();
+		GameInstance->GetSubsystem<UMUNUpdateSubsystem>()->SetVersionCache(MakeShared<FMUNVersionCache>(CacheFilePath));
+
+		// Settings of a player who hasn't changed any, pointed at the test API
+		FMUNCheckSettings Settings;
+		Settings.APIBaseURL = Server->GetBaseURL();
+		Settings.VersionCacheTTL = FTimespan::FromMinutes(FMUNCheckSettings::DefaultVersionCacheTTLMinutes);
+		Settings.RequestSettings.TimeoutSeconds = 10.0f;
+		Settings.bRecordBaseline = false;
+
+		MenuModule.Reset(NewObject<UMUNMenuModule>(GameInstance->GetWorld()));
+		MenuModule->CheckSettings = Settings;
+		MenuModule->bShowNotifications = true;
+		MenuModule->bDisableNotifications = false;
+		MenuModule->NotificationDeadlineSeconds = 3.0f;
+	});
+
+	AfterEach([this]()
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(PollHandle);
+		PollHandle.Reset();
+		AllocationCounter.Reset();
+
+		// Shutting down cancels the session's check and flushes its cache
+		UWorld* World = GameInstance->GetWorld();
+		GameInstance->GetTimerManager().ClearAllTimersForObject(MenuModule.Get());
+		MenuModule.Reset();
+		GameInstance->Shutdown();
+		World->DestroyWorld(false);
+		GEngine->DestroyWorldContext(World);
+		GameInstance.Reset();
+
+		Server.Reset();
+		Log.Reset();
+		IFileManager::Get().Delete(*CacheFilePath, false, false, true);
+	});
+
+	for (const int32 NumMods : FMUNTestPayloads::BenchmarkScales)
+	{
+		LatentIt(FString::Printf(TEXT("shows the notification for %d mods"), NumMods), FTimespan::FromSeconds(120), [this, NumMods](const FDoneDelegate& Done)
+		{
+			RunUntilNotification(FString::Printf(TEXT("UpdateCheck%d"), NumMods), TEXT("Batched, gzip"), AddMods(*Server, NumMods, 10), Done);
+		});
+	}
+
+	LatentIt(TEXT("shows the notification for the installed mods"), FTimespan::FromSeconds(120), [this](const FDoneDelegate& Done)
+	{
+		// Every installed mod has a patch release, so the check runs from the mod scan on
+		for (const FModInfo& ModInfo : GameInstance->GetSubsystem<UModLoadingLibrary>()->GetLoadedMods())
+		{
+			Server->AddMod(ModInfo.Name, {FString::Printf(TEXT("%lld.%lld.%lld"), ModInfo.Version.Major, ModInfo.Version.Minor, ModInfo.Version.Patch + 1), ModInfo.Version.ToString()});
+		}
+		RunUntilNotification(TEXT("UpdateCheckInstalled"), TEXT("Installed mods"), {}, Done);
+	});
+}
+
+void FMUNUpdateCheckerBenchmark::RunUntilNotification(const FString& Name, const FString& Case, TOptional<FMUNModTable> GeneratedMods, const FDoneDelegate& Done)
+{
+	Log = MakeShared<FMUNBenchmarkLog>(*this, Name);
+
+	// Every thread, the HTTP and parsing work happens off the game thread
+	AllocationCounter = MakeUnique<FMUNAllocationCounter>(true);
+	const uint64 StartFrame = GFrameCounter;
+
+	// Picked up by CheckForModUpdates like a check started by an earlier main menu of the session
+	if (GeneratedMods.IsSet())
+	{
+		GameInstance->GetSubsystem<UMUNUpdateSubsystem>()->GetMenuChecker(MenuModule->CheckSettings)->StartCheck(MoveTemp(GeneratedMods.GetValue()));
+	}
+	MenuModule->CheckForModUpdates();
+
+	// Runs between the notifier's callbacks, so the work of the one that showed the notification has been recorded by then
+	PollHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this, Name, Case, Done, StartFrame](float)
+	{
+		const FMUNCheckReport& Report = FMUNCheckReport::Get();
+		const double SecondsToNotification = Report.GetSecondsToNotification();
+		if (SecondsToNotification == 0.0)
+		{
+			return true;
+		}
+
+		const int64 NumAllocations = AllocationCounter->GetNumAllocations();
+		const int64 NumBytes = AllocationCounter->GetNumBytes();
+		const int64 PeakBytes = AllocationCounter->GetPeakBytes();
+		AllocationCounter.Reset();
+
+		const int32 NumMods = MenuModule->GetModCount();
+
+		Log->Add(Case, NumMods, TEXT("time to notification ms"), SecondsToNotification * 1000.0);
+		Log->Add(Case, NumMods, TEXT("frames to notification"), GFrameCounter - StartFrame);
+		Log->Add(Case, NumMods, TEXT("updates shown"), MenuModule->GetNumAvailableUpdates());
+		Log->Add(Case, NumMods, TEXT("game thread ms"), Report.GetGameThreadSeconds() * 1000.0);
+		Log->Add(Case, NumMods, TEXT("busiest frame game thread ms"), Report.GetLongestGameThreadFrameSeconds() * 1000.0);
+		Log->Add(Case, NumMods, TEXT("requests"), Report.GetNumRequests());
+		Log->Add(Case, NumMods, TEXT("KiB received"), Report.GetBytesReceived() / 1024.0);
+		Log->Add(Case, NumMods, TEXT("allocations"), NumAllocations);
+		Log->Add(Case, NumMods, TEXT("MiB allocated"), NumBytes / (1024.0 * 1024.0));
+		Log->Add(Case, NumMods, TEXT("peak heap growth MiB"), PeakBytes / (1024.0 * 1024.0));
+
+		// Latency, size and phase timings of every request, in the same format as the ModUpdateReportCsv command
+		Report.WriteCsv(FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ModUpdateNotifier"), TEXT("Benchmarks"), Name + TEXT("Report.csv")));
+
+		PollHandle.Reset();
+		Done.Execute();
+		return false;
+	}));
+}
+
+#endif
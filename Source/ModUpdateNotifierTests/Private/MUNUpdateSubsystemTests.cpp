@@ -0,0 +1,163 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "Misc/AutomationTest.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "ModLoading/ModLoadingLibrary.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/StrongObjectPtr.h"
+#include "MUNTestApiServer.h"
+#include "MUNUpdateSubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// The mods installed in the running game, the same ones a server would check
+	UModLoadingLibrary* FindModLoadingLibrary()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if (Context.OwningGameInstance)
+			{
+				return Context.OwningGameInstance->GetSubsystem<UModLoadingLibrary>();
+			}
+		}
+		return nullptr;
+	}
+}
+
+BEGIN_DEFINE_SPEC(FMUNUpdateSubsystemSpec, "ModUpdateNotifier.UpdateSubsystem",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+	TSharedPtr<FMUNTestApiServer> Server;
+	TStrongObjectPtr<UMUNUpdateSubsystem> Subsystem; // Not the game's, so its check only runs for this test
+	FString CacheFilePath;
+	FString PreviousReport; // The report is written where servers write it, whatever was there is put back afterwards
+	bool bHadReport = false;
+	FTSTicker::FDelegateHandle PollHandle;
+
+END_DEFINE_SPEC(FMUNUpdateSubsystemSpec)
+
+void FMUNUpdateSubsystemSpec::Define()
+{
+	BeforeEach([this]()
+	{
+		Server = MakeShared<FMUNTestApiServer>();
+		TestTrue(TEXT("Test API started"), Server->Start());
+
+		CacheFilePath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("ModUpdateNotifier"), FGuid::NewGuid().ToString() + TEXT(".json"));
+		Subsystem.Reset(NewObject<UMUNUpdateSubsystem>());
+		Subsystem->SetVersionCache(MakeShared<FMUNVersionCache>(CacheFilePath));
+
+		const FString ReportPath = UMUNUpdateSubsystem::GetServerReportPath();
+		bHadReport = FFileHelper::LoadFileToString(PreviousReport, *ReportPath);
+		IFileManager::Get().Delete(*ReportPath, false, false, true);
+	});
+
+	AfterEach([this]()
+	{
+		if (PollHandle.IsValid())
+		{
+			FTSTicker::GetCoreTicker().RemoveTicker(PollHandle);
+			PollHandle.Reset();
+		}
+
+		Subsystem->Deinitialize();
+		Subsystem.Reset();
+		Server.Reset();
+		IFileManager::Get().Delete(*CacheFilePath, false, false, true);
+
+		const FString ReportPath = UMUNUpdateSubsystem::GetServerReportPath();
+		if (bHadReport)
+		{
+			FFileHelper::SaveStringToFile(PreviousReport, *ReportPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+		}
+		else
+		{
+			IFileManager::Get().Delete(*ReportPath, false, false, true);
+		}
+	});
+
+	LatentIt(TEXT("writes the outdated installed mods to the server report"), FTimespan::FromSeconds(30), [this](const FDoneDelegate& Done)
+	{
+		UModLoadingLibrary* ModLoadingLibrary = FindModLoadingLibrary();
+		if (!TestNotNull(TEXT("Game instance with the installed mods"), ModLoadingLibrary))
+		{
+			Done.Execute();
+			return;
+		}
+
+		// Every installed mod has a patch release on the test API
+		TMap<FString, FString> NewVersions;
+		for (const FModInfo& ModInfo : ModLoadingLibrary->GetLoadedMods())
+		{
+			const FString NewVersion = FString::Printf(TEXT("%lld.%lld.%lld"), ModInfo.Version.Major, ModInfo.Version.Minor, ModInfo.Version.Patch + 1);
+			Server->AddMod(ModInfo.Name, {NewVersion, ModInfo.Version.ToString()});
+			NewVersions.Add(ModInfo.Name, NewVersion);
+		}
+		Server->Settings.LatencySeconds = 0.05f;
+
+		FMUNCheckSettings Settings;
+		Settings.APIBaseURL = Server->GetBaseURL();
+		Settings.VersionCacheTTL = FTimespan::FromMinutes(FMUNCheckSettings::DefaultVersionCacheTTLMinutes);
+		Settings.RequestSettings.TimeoutSeconds = 10.0f;
+		Settings.bRecordBaseline = false;
+
+		// Without a world module manager every mod takes part, none can opt out
+		Subsystem->StartServerCheck(Settings, ModLoadingLibrary, nullptr);
+
+		PollHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this, Done, NewVersions](float)
+		{
+			// Written on a worker once the check completes, so it may be missing or only partly written for a while
+			FString Report;
+			TSharedPtr<FJsonObject> ReportObj;
+			if (!FFileHelper::LoadFileToString(Report, *UMUNUpdateSubsystem::GetServerReportPath()) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Report), ReportObj) || !ReportObj.IsValid())
+			{
+				return true;
+			}
+
+			TestEqual(TEXT("API base URL"), ReportObj->GetStringField(TEXT("api_base_url")), Server->GetBaseURL());
+			TestEqual(TEXT("Every installed mod is checked"), static_cast<int32>(ReportObj->GetNumberField(TEXT("mods_checked"))), NewVersions.Num());
+
+			FDateTime GeneratedAt;
+			TestTrue(TEXT("Generation time is ISO 8601"), FDateTime::ParseIso8601(*ReportObj->GetStringField(TEXT("generated_at")), GeneratedAt));
+
+			const TArray<TSharedPtr<FJsonValue>>& OutdatedMods = ReportObj->GetArrayField(TEXT("outdated_mods"));
+			TestEqual(TEXT("Update count matches the list"), static_cast<int32>(ReportObj->GetNumberField(TEXT("updates_available"))), OutdatedMods.Num());
+
+			bool bFoundSelf = false;
+			for (const TSharedPtr<FJsonValue>& OutdatedMod : OutdatedMods)
+			{
+				const TSharedPtr<FJsonObject> ModObj = OutdatedMod->AsObject();
+				const FString ModReference = ModObj->GetStringField(TEXT("mod_reference"));
+				const FString* NewVersion = NewVersions.Find(ModReference);
+				if (!TestNotNull(FString::Printf(TEXT("%s is installed"), *ModReference), NewVersion))
+				{
+					continue;
+				}
+
+				TestEqual(FString::Printf(TEXT("%s is offered the patch release"), *ModReference), ModObj->GetStringField(TEXT("available_version")), *NewVersion);
+				TestEqual(FString::Printf(TEXT("%s has the patch release as its newest version"), *ModReference), ModObj->GetStringField(TEXT("newest_version")), *NewVersion);
+				bFoundSelf |= ModReference == TEXT("ModUpdateNotifier");
+			}
+
+			// Nothing installed in a test run pins the notifier, other mods may be held back by their dependents
+			TestTrue(TEXT("The notifier itself is reported as outdated"), bFoundSelf);
+			TestTrue(TEXT("Server checks send at most two requests at once"), Server->GetMaxInFlight() <= 2);
+
+			PollHandle.Reset();
+			Done.Execute();
+			return false;
+		}), 0.1f);
+	});
+}
+
+#endif
@@ -0,0 +1,48 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "Misc/AutomationTest.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "MUNVersionSnapshot.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMUNVersionSnapshotTest, "ModUpdateNotifier.VersionSnapshot.RoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMUNVersionSnapshotTest::RunTest(const FString& Parameters)
+{
+	// Strings that only differ in case must each keep their own bytes
+	const FMUNVersionEntry Versions[] = {
+		{UTF8TEXT("1.0.0-RC.1"), UTF8TEXT(">=264901")},
+		{UTF8TEXT("1.0.0-rc.1"), UTF8TEXT(">=264901")},
+	};
+
+	FMUNVersionSnapshotWriter Writer;
+	Writer.AddMod(UTF8TEXT("CaseMod"), Versions);
+	Writer.AddMod(UTF8TEXT("casemod"), TConstArrayView<FMUNVersionEntry>(Versions, 1));
+
+	const FString SnapshotPath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("ModUpdateNotifier"), TEXT("VersionSnapshot.bin"));
+	if (!TestTrue(TEXT("Snapshot written"), Writer.Save(SnapshotPath, FDateTime::UtcNow())))
+	{
+		return false;
+	}
+
+	{
+		const TSharedPtr<FMUNVersionSnapshot> Snapshot = FMUNVersionSnapshot::LoadFromFile(SnapshotPath);
+		TArray<FMUNVersionEntry> Found;
+		if (TestTrue(TEXT("Snapshot loaded"), Snapshot.IsValid()) && TestTrue(TEXT("Mod found"), Snapshot->Find(UTF8TEXT("CaseMod"), Found)))
+		{
+			if (TestEqual(TEXT("Versions"), Found.Num(), 2))
+			{
+				TestEqual(TEXT("Upper case version"), FMUNVersionsReader::ToString(Found[0].Version), FString(TEXT("1.0.0-RC.1")));
+				TestEqual(TEXT("Lower case version"), FMUNVersionsReader::ToString(Found[1].Version), FString(TEXT("1.0.0-rc.1")));
+			}
+		}
+	}
+
+	IFileManager::Get().Delete(*SnapshotPath, false, false, true);
+	return true;
+}
+
+#endif
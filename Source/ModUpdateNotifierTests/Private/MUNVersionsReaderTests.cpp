@@ -0,0 +1,191 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "Misc/AutomationTest.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "MUNTestPayloads.h"
+#include "MUNVersionsReader.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMUNVersionsReaderVersionsAllTest, "ModUpdateNotifier.VersionsReader.VersionsAll",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMUNVersionsReaderVersionsAllTest::RunTest(const FString& Parameters)
+{
+	const TArray<FString> Versions = FMUNTestPayloads::MakeVersions(3);
+	const TArray<uint8> Content = FMUNTestPayloads::ToUtf8(FMUNTestPayloads::MakeVersionsAll(Versions, TEXT(">=264901")));
+
+	TArray<FMUNVersionEntry> Entries;
+	FMUNDecodedStrings DecodedStrings;
+	if (!TestTrue(TEXT("Reads a response with extra fields"), FMUNVersionsReader::ReadVersionsAll(Content, Entries, DecodedStrings)))
+	{
+		return false;
+	}
+
+	if (TestEqual(TEXT("Number of versions"), Entries.Num(), Versions.Num()))
+	{
+		for (int32 VersionIndex = 0; VersionIndex < Versions.Num(); VersionIndex++)
+		{
+			TestEqual(TEXT("Version"), FMUNVersionsReader::ToString(Entries[VersionIndex].Version), Versions[VersionIndex]);
+			TestEqual(TEXT("Game version"), FMUNVersionsReader::ToString(Entries[VersionIndex].GameVersion), FString(TEXT(">=264901")));
+		}
+	}
+	TestEqual(TEXT("Unescaped strings are views of the content"), DecodedStrings.Num(), 0);
+
+	Entries.Reset();
+	TestFalse(TEXT("Fails without a data array"), FMUNVersionsReader::ReadVersionsAll(FMUNTestPayloads::ToUtf8(TEXT("{\"success\":false,\"error\":\"not found\"}")), Entries, DecodedStrings));
+	TestFalse(TEXT("Fails on a truncated response"), FMUNVersionsReader::ReadVersionsAll(FMUNTestPayloads::ToUtf8(TEXT("{\"success\":true,\"data\":[{\"version\":\"1.0.0\"")), Entries, DecodedStrings));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMUNVersionsReaderEscapesTest, "ModUpdateNotifier.VersionsReader.Escapes",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMUNVersionsReaderEscapesTest::RunTest(const FString& Parameters)
+{
+	// SMR escapes the ">" of ranges, the rest covers every other kind of escape sequence
+	const TArray<uint8> Content = FMUNTestPayloads::ToUtf8(TEXT("{\"success\":true,\"data\":[")
+		TEXT("{\"version\":\"1.0.0\",\"game_version\":\"\\u003e=264901\"},")
+		TEXT("{\"changelog\":\"\\\"quoted\\\" \\\\ \\/\",\"version\":\"1.0.0-\\u00e9\\ud83d\\ude00\",\"game_version\":\"\\t\\n\"},")
+		TEXT("{\"version\":\"1.0.0-\\ud83d\",\"game_version\":\"*\"}]}"));
+
+	TArray<FMUNVersionEntry> Entries;
+	FMUNDecodedStrings DecodedStrings;
+	if (!TestTrue(TEXT("Reads escaped strings"), FMUNVersionsReader::ReadVersionsAll(Content, Entries, DecodedStrings)) || !TestEqual(TEXT("Number of versions"), Entries.Num(), 3))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("Unicode escape"), FMUNVersionsReader::ToString(Entries[0].GameVersion), FString(TEXT(">=264901")));
+	TestEqual(TEXT("Surrogate pair"), FMUNVersionsReader::ToString(Entries[1].Version), FString(TEXT("1.0.0-")) + UTF8_TO_TCHAR("\xC3\xA9\xF0\x9F\x98\x80"));
+	TestEqual(TEXT("Control characters"), FMUNVersionsReader::ToString(Entries[1].GameVersion), FString(TEXT("\t\n")));
+	TestEqual(TEXT("Lone surrogate"), FMUNVersionsReader::ToString(Entries[2].Version), FString(TEXT("1.0.0-")) + UTF8_TO_TCHAR("\xEF\xBF\xBD"));
+
+	Entries.Reset();
+	TestFalse(TEXT("Fails on a trailing backslash"), FMUNVersionsReader::ReadVersionsAll(FMUNTestPayloads::ToUtf8(TEXT("{\"success\":true,\"data\":[{\"version\":\"1.0.0\\")), Entries, DecodedStrings));
+	TestFalse(TEXT("Fails on a truncated unicode escape"), FMUNVersionsReader::ReadVersionsAll(FMUNTestPayloads::ToUtf8(TEXT("{\"success\":true,\"data\":[{\"version\":\"\\u00\"}]}")), Entries, DecodedStrings));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMUNVersionsReaderBatchedTest, "ModUpdateNotifier.VersionsReader.Batched",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMUNVersionsReaderBatchedTest::RunTest(const FString& Parameters)
+{
+	const TArray<FString> ModReferences = {FMUNTestPayloads::MakeModReference(0), FMUNTestPayloads::MakeModReference(1)};
+	const TArray<FString> Versions = FMUNTestPayloads::MakeVersions(2);
+
+	TArray<FString> VisitedMods;
+	const bool bValid = FMUNVersionsReader::ReadBatchedVersions(FMUNTestPayloads::ToUtf8(FMUNTestPayloads::MakeBatchedVersions(ModReferences, Versions)),
+		[this, &VisitedMods, &Versions](const FUtf8StringView ModReference, const FUtf8StringView Logo, const TConstArrayView<FMUNVersionEntry> Entries)
+	{
+		const FString Reference = FMUNVersionsReader::ToString(ModReference);
+		VisitedMods.Add(Reference);
+		TestEqual(TEXT("Logo with escaped slashes"), FMUNVersionsReader::ToString(Logo), FString::Printf(TEXT("https://storage.ficsit.app/images/mods/%s/logo.webp"), *Reference));
+		if (TestEqual(TEXT("Number of versions"), Entries.Num(), Versions.Num()))
+		{
+			TestEqual(TEXT("Newest version"), FMUNVersionsReader::ToString(Entries[0].Version), Versions[0]);
+		}
+	});
+
+	TestTrue(TEXT("Reads a batched response"), bValid);
+	TestEqual(TEXT("Visits every mod in order"), VisitedMods, ModReferences);
+
+	TestFalse(TEXT("Fails if the query returned errors"), FMUNVersionsReader::ReadBatchedVersions(FMUNTestPayloads::ToUtf8(TEXT("{\"errors\":[{\"message\":\"bad query\"}],\"data\":null}")),
+		[](FUtf8StringView, FUtf8StringView, TConstArrayView<FMUNVersionEntry>) {}));
+
+	int32 NumDates = 0;
+	TestTrue(TEXT("Reads last version dates"), FMUNVersionsReader::ReadLastVersionDates(FMUNTestPayloads::ToUtf8(FMUNTestPayloads::MakeLastVersionDates(ModReferences, FDateTime(2025, 1, 1))),
+		[this, &NumDates](const FUtf8StringView ModReference, const FUtf8StringView LastVersionDate)
+	{
+		NumDates++;
+		FDateTime Date;
+		TestTrue(TEXT("Date is ISO 8601"), FDateTime::ParseIso8601(*FMUNVersionsReader::ToString(LastVersionDate), Date) && Date == FDateTime(2025, 1, 1));
+	}));
+	TestEqual(TEXT("Visits every mod"), NumDates, ModReferences.Num());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMUNVersionsReaderBenchmark, "ModUpdateNotifier.Benchmarks.VersionsReader",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FMUNVersionsReaderBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 Iterations = 9;
+	const TArray<FString> Versions = FMUNTestPayloads::MakeVersions(10);
+	const TArray<uint8> VersionsAll = FMUNTestPayloads::ToUtf8(FMUNTestPayloads::MakeVersionsAll(Versions));
+
+	FMUNBenchmarkLog Log(*this, TEXT("VersionsReader"));
+
+	for (const int32 NumMods : FMUNTestPayloads::BenchmarkScales)
+	{
+		// One REST response per mod, read with the streaming reader and with the JSON DOM it replaced
+		const auto ReadWithReader = [&VersionsAll, NumMods]()
+		{
+			TArray<FMUNVersionEntry> Entries;
+			FMUNDecodedStrings DecodedStrings;
+			for (int32 ModIndex = 0; ModIndex < NumMods; ModIndex++)
+			{
+				Entries.Reset();
+				FMUNVersionsReader::ReadVersionsAll(VersionsAll, Entries, DecodedStrings);
+			}
+		};
+
+		const auto ReadWithDom = [&VersionsAll, NumMods]()
+		{
+			for (int32 ModIndex = 0; ModIndex < NumMods; ModIndex++)
+			{
+				const FUTF8ToTCHAR Text(reinterpret_cast<const ANSICHAR*>(VersionsAll.GetData()), VersionsAll.Num());
+				TSharedPtr<FJsonObject> Object;
+				FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(FString(Text.Length(), Text.Get())), Object);
+			}
+		};
+
+		const double ReaderMs = FMUNBenchmarkLog::MedianMilliseconds(Iterations, ReadWithReader);
+		const double DomMs = FMUNBenchmarkLog::MedianMilliseconds(Iterations, ReadWithDom);
+
+		// The reader only grows its entry array once, the DOM allocates every object, value and string of every response
+		const int64 ReaderAllocations = FMUNAllocationCounter::Count(ReadWithReader);
+		const int64 DomAllocations = FMUNAllocationCounter::Count(ReadWithDom);
+		TestTrue(TEXT("The streaming reader allocates less than the JSON DOM"), ReaderAllocations < DomAllocations);
+
+		Log.Add(TEXT("REST, streaming reader"), NumMods, TEXT("ms"), ReaderMs);
+		Log.Add(TEXT("REST, streaming reader"), NumMods, TEXT("allocations"), ReaderAllocations);
+		Log.Add(TEXT("REST, JSON DOM"), NumMods, TEXT("ms"), DomMs);
+		Log.Add(TEXT("REST, JSON DOM"), NumMods, TEXT("allocations"), DomAllocations);
+
+		// The same mods in batched queries of 50, the way the checker asks for them
+		TArray<TArray<uint8>> Batches;
+		for (int32 FirstMod = 0; FirstMod < NumMods; FirstMod += 50)
+		{
+			TArray<FString> ModReferences;
+			for (int32 ModIndex = FirstMod; ModIndex < FMath::Min(FirstMod + 50, NumMods); ModIndex++)
+			{
+				ModReferences.Add(FMUNTestPayloads::MakeModReference(ModIndex));
+			}
+			Batches.Add(FMUNTestPayloads::ToUtf8(FMUNTestPayloads::MakeBatchedVersions(ModReferences, Versions)));
+		}
+
+		int32 NumRead = 0;
+		const auto ReadBatches = [&Batches, &NumRead]()
+		{
+			NumRead = 0;
+			for (const TArray<uint8>& Batch : Batches)
+			{
+				FMUNVersionsReader::ReadBatchedVersions(Batch, [&NumRead](FUtf8StringView, FUtf8StringView, TConstArrayView<FMUNVersionEntry>) { NumRead++; });
+			}
+		};
+		const double BatchedMs = FMUNBenchmarkLog::MedianMilliseconds(Iterations, ReadBatches);
+		const int64 BatchedAllocations = FMUNAllocationCounter::Count(ReadBatches);
+
+		TestEqual(TEXT("Every mod of the batches is read"), NumRead, NumMods);
+		Log.Add(TEXT("Batched, streaming reader"), NumMods, TEXT("ms"), BatchedMs);
+		Log.Add(TEXT("Batched, streaming reader"), NumMods, TEXT("allocations"), BatchedAllocations);
+	}
+
+	return true;
+}
+
+#endif
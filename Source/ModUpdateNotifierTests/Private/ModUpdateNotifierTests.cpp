@@ -0,0 +1,7 @@
+// Copyright 2024 - 2026 Jesse Hodgson.
+
+#include "Modules/ModuleManager.h"
+
+// Only holds automation tests and benchmarks, run them headless with
+// -nullrhi -unattended -ExecCmds="Automation RunTests ModUpdateNotifier; Quit"
+IMPLEMENT_MODULE(FDefaultModuleImpl, ModUpdateNotifierTests)